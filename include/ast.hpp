@@ -6,10 +6,14 @@
  * Some of the included files are themselves amalgamated headers.
  */
 
+#include "ast/arena.hpp"
 #include "ast/builder.hpp"
+#include "ast/direct_builder.hpp"
 #include "ast/error.hpp"
+#include "ast/node_map.hpp"
 #include "ast/nodes.hpp"
 #include "ast/parse_tree_node.hpp"
+#include "ast/rule_id.hpp"
 #include "ast/selector.hpp"
 #include "ast/transform.hpp"
 
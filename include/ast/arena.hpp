@@ -0,0 +1,98 @@
+#ifndef RHEA_AST_ARENA_HPP
+#define RHEA_AST_ARENA_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/*
+ * Region allocator for AST nodes.
+ *
+ * Building the AST for a real source file makes a huge number of small
+ * allocations, one per node, and tearing the tree down frees every one of
+ * them separately. An arena instead hands out memory from a few large
+ * blocks, so nodes created while it's active are packed together in the
+ * order they were built, and all of it goes back in one step when the
+ * arena is released.
+ *
+ * Nothing about the AST's interface changes: nodes are still owned through
+ * std::unique_ptr, and their destructors still run, so tearing a tree down
+ * still visits every node (and frees every child list, which come from the
+ * heap). What the arena saves is the per-node heap traffic. ASTNode
+ * overloads its own operator new and delete (see node_base.hpp), which use
+ * whichever arena is current on this thread, if any. Deleting an
+ * arena-backed node just drops it from the arena's live count; the memory
+ * is reclaimed when the arena itself is released or destroyed.
+ *
+ * Each node remembers which arena it came from (null for the heap). The
+ * node's destructor passes that along to operator delete, which can't look
+ * at the node itself, so deleting never has to search for the memory or
+ * take a lock, whichever thread it happens on.
+ *
+ * Because of that, an arena must outlive every node allocated from it. In
+ * practice, that means declaring the arena before the tree that uses it.
+ * Releasing an arena that still has live nodes throws, and destroying one
+ * aborts the program, since the alternative is a use-after-free.
+ */
+namespace rhea { namespace ast {
+    class Arena
+    {
+        public:
+        static constexpr std::size_t default_block_size = 64 * 1024;
+
+        explicit Arena(std::size_t block_size = default_block_size);
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // Get `size` bytes aligned to `align`, which must be a power of 2.
+        void* allocate(std::size_t size, std::size_t align);
+
+        // Free every block at once. All nodes allocated from this arena
+        // must have been destroyed already; if not, this throws
+        // std::logic_error and frees nothing.
+        void release();
+
+        // Bookkeeping, mostly for tests and the debug tools.
+        std::size_t bytes_used() const { return m_used; }
+        std::size_t block_count() const { return m_blocks.size(); }
+        std::size_t live_nodes() const { return m_live.load(); }
+
+        // The arena new nodes will be allocated from on this thread, or
+        // null if they should use the regular heap.
+        static Arena* current();
+
+        private:
+        friend class ASTNode;
+        friend class ArenaScope;
+
+        void add_block(std::size_t min_size);
+
+        std::size_t m_block_size;
+        std::vector<char*> m_blocks;
+        char* m_next = nullptr;
+        char* m_end = nullptr;
+        std::size_t m_used = 0;
+
+        // Nodes can be deleted from any thread.
+        std::atomic<std::size_t> m_live { 0 };
+    };
+
+    // RAII helper that makes an arena current for the lifetime of the
+    // scope, then restores whatever was current before.
+    class ArenaScope
+    {
+        public:
+        explicit ArenaScope(Arena& arena);
+        ~ArenaScope();
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+        private:
+        Arena* m_previous;
+    };
+}}
+
+#endif /* RHEA_AST_ARENA_HPP */
@@ -3,6 +3,7 @@
 
 #include <memory>
 
+#include "arena.hpp"
 #include "nodes.hpp"
 #include "parse_tree_node.hpp"
 #include "internal/builder.hpp"
@@ -13,10 +14,18 @@
  * intended to be passed to the type checker, declaration checker, and
  * code generator. This representation can also be serialized to serve as
  * a module object format.
+ *
+ * Node locations point into the source text, which has to be registered
+ * with the global SourceManager by whoever owns it (SourceFile does this
+ * for whole files). Text that isn't registered gives invalid locations.
  */
 namespace rhea { namespace ast {
     // Build a Rhea AST out of the PEGTL modified parse tree.
     std::unique_ptr<ASTNode> build_ast(parser_node* node);
+
+    // Same as above, but allocate every node from the given arena, which
+    // must outlive the returned tree.
+    std::unique_ptr<ASTNode> build_ast(parser_node* node, Arena& arena);
 }}
 
 #endif /* RHEA_AST_BUILDER_HPP */
\ No newline at end of file
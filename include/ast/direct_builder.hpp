@@ -0,0 +1,54 @@
+#ifndef RHEA_AST_DIRECT_BUILDER_HPP
+#define RHEA_AST_DIRECT_BUILDER_HPP
+
+#include <memory>
+
+#include <tao/pegtl.hpp>
+
+#include "nodes.hpp"
+
+/*
+ * Single-pass AST builder. The regular builder (see builder.hpp) has PEGTL
+ * create a full parse tree, then walks that tree to create a second one
+ * made of AST nodes. This one instead hooks into the parser's control
+ * class, building AST nodes on a stack as soon as each rule matches, so
+ * there is no parse tree at all.
+ *
+ * It covers expressions and the simple statements (declarations,
+ * assignments, blocks, and the basic control-flow statements). Anything
+ * else throws unimplemented_type, and the caller should fall back to the
+ * two-phase builder for that input. As with that one, the input has to be
+ * registered with the SourceManager for nodes to get valid locations.
+ *
+ * The builders are templates over the PEGTL input type. They're
+ * instantiated for string_input and memory_input<> (which keep their source
+ * name as a std::string), and for mmap_input and file_view_input (which
+ * use a plain pointer, and so are a different memory_input type).
+ */
+namespace rhea { namespace ast {
+    // Input over memory that belongs to someone else, like a mapped file.
+    // This is the base class of mmap_input.
+    using file_view_input = tao::pegtl::memory_input<
+        tao::pegtl::tracking_mode::eager,
+        tao::pegtl::eol::lf_crlf,
+        const char*
+    >;
+
+    // Parse and build a single expression. Returns null if the input
+    // doesn't match.
+    template <typename Input>
+    expression_ptr build_expression_direct(Input& in);
+
+    // Parse and build a single statement or block. Returns null if the
+    // input doesn't match.
+    template <typename Input>
+    statement_ptr build_statement_direct(Input& in);
+
+    // Parse and build a whole file, which must be a program. Modules, and
+    // top-level definitions other than simple statements, are left to the
+    // two-phase builder. Returns null if the input doesn't match.
+    template <typename Input>
+    node_ptr build_program_direct(Input& in);
+}}
+
+#endif /* RHEA_AST_DIRECT_BUILDER_HPP */
@@ -4,6 +4,8 @@
 #include <stdexcept>
 #include <fmt/format.h>
 
+#include "../source/source_manager.hpp"
+
 namespace rhea { namespace ast {
     // Exception type for unimplemented AST nodes
     struct unimplemented_type : public std::invalid_argument
@@ -21,16 +23,24 @@ namespace rhea { namespace ast {
     struct type_mismatch : public syntax_error
     {
         template <typename T>
-        type_mismatch(T* t) : info(
-            fmt::format("{0}:{1}:{2}({3}) Type mismatch",
-                t->position.source,
-                t->position.line,
-                t->position.byte_in_line,
-                t->position.byte
-            )
-        ) {}
+        type_mismatch(T* t)
+            : syntax_error(describe(t->position)), info(what()) {}
 
         const std::string info;
+
+        private:
+        // Line and column are only worked out here, when we need them.
+        static std::string describe(source::SourceLocation loc)
+        {
+            if (!loc.valid())
+            {
+                return "<unknown> Type mismatch";
+            }
+
+            auto p = source::SourceManager::global().presumed(loc);
+            return fmt::format("{0}:{1}:{2}({3}) Type mismatch",
+                p.name, p.line, p.column, p.offset);
+        }
     };
 }}
 
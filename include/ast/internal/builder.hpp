@@ -7,6 +7,7 @@
 #include "../nodes.hpp"
 #include "../error.hpp"
 #include "../parse_tree_node.hpp"
+#include "../../source/source_manager.hpp"
 #include "../../types/types.hpp"
 #include "../../util/compat.hpp"
 #include "../../util/downcast.hpp"
@@ -28,6 +29,22 @@ namespace rhea { namespace ast {
         // Builder for statements.
         statement_ptr create_statement_node(parser_node* node);
 
+        // Location of a parse node in the source manager's terms. The node's
+        // input must have been registered, or the location is invalid.
+        source::SourceLocation location_of(parser_node* node);
+
+        // Literal helpers, shared with the direct (single-pass) builder.
+        // These take the matched text rather than a parse node.
+        expression_ptr create_integer_literal(const std::string& lit, const std::string& suffix);
+        expression_ptr create_float_literal(const std::string& lit, bool float_suffix);
+        expression_ptr create_hex_literal(const std::string& lit);
+
+        // The kind of function a suffix (`?`, `!`, or `$`) stands for.
+        FunctionType function_type_for_suffix(const std::string& suffix);
+
+        // Convert an already-built expression into a dictionary key, throwing
+        // a syntax error if it isn't a valid key type.
+        DictionaryKey create_dictionary_key(expression_ptr expr);
     }
 }}
 
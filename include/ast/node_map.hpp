@@ -0,0 +1,226 @@
+#ifndef RHEA_AST_NODE_MAP_HPP
+#define RHEA_AST_NODE_MAP_HPP
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "nodes/node_base.hpp"
+
+/*
+ * A map from AST nodes to extra data, for compiler passes that need to
+ * hang something off every node (inferred types, scopes, and so on).
+ *
+ * Since nodes have small, dense IDs (see node_base.hpp), this is just a
+ * table indexed by ID, plus a flag for which slots are in use. Lookups
+ * don't hash anything, and nodes built together sit together in memory.
+ *
+ * IDs are never reused, so a long-running process (like the REPL) hands out
+ * bigger and bigger ones. The table is split into fixed-size chunks, which
+ * are only created for ranges of IDs that actually have entries, and the
+ * chunk list starts at the first chunk in use. A map for one small tree
+ * stays small, however many nodes came before it.
+ *
+ * The interface is a subset of `std::unordered_map`'s, enough for the
+ * ways the compiler uses it. The big difference is that `find` returns a
+ * pointer (null if there's no entry) instead of an iterator.
+ *
+ * Chunks never move once they're created, so references into the map stay
+ * valid until the entry is erased or the map is cleared, even when entries
+ * are added for other nodes.
+ */
+namespace rhea { namespace ast {
+    template <typename T>
+    class NodeMap
+    {
+        static constexpr std::size_t chunk_bits = 8;
+        static constexpr std::size_t chunk_size = std::size_t(1) << chunk_bits;
+
+        struct Chunk
+        {
+            std::array<T, chunk_size> values {};
+            std::bitset<chunk_size> present;
+        };
+
+        public:
+        NodeMap() = default;
+        NodeMap(NodeMap&&) = default;
+        NodeMap& operator=(NodeMap&&) = default;
+
+        NodeMap(const NodeMap& other)
+            : m_first_chunk(other.m_first_chunk), m_size(other.m_size)
+        {
+            m_chunks.reserve(other.m_chunks.size());
+            for (auto& c : other.m_chunks)
+            {
+                m_chunks.push_back(c ? std::make_unique<Chunk>(*c) : nullptr);
+            }
+        }
+
+        NodeMap& operator=(const NodeMap& other)
+        {
+            if (this != &other)
+            {
+                NodeMap copy { other };
+                *this = std::move(copy);
+            }
+
+            return *this;
+        }
+
+        T& operator[](const ASTNode* node)
+        {
+            auto id = node->id;
+            auto& chunk = chunk_for(id);
+            auto slot = id & (chunk_size - 1);
+
+            if (!chunk.present[slot])
+            {
+                chunk.present[slot] = true;
+                ++m_size;
+            }
+
+            return chunk.values[slot];
+        }
+
+        T* find(const ASTNode* node)
+        {
+            auto chunk = existing_chunk(node->id);
+            auto slot = node->id & (chunk_size - 1);
+            return (chunk != nullptr && chunk->present[slot]) ? &chunk->values[slot] : nullptr;
+        }
+
+        const T* find(const ASTNode* node) const
+        {
+            auto chunk = existing_chunk(node->id);
+            auto slot = node->id & (chunk_size - 1);
+            return (chunk != nullptr && chunk->present[slot]) ? &chunk->values[slot] : nullptr;
+        }
+
+        std::size_t count(const ASTNode* node) const { return find(node) != nullptr ? 1 : 0; }
+
+        // Remove a node's entry, resetting it to a default value.
+        void erase(const ASTNode* node)
+        {
+            auto chunk = existing_chunk(node->id);
+            auto slot = node->id & (chunk_size - 1);
+
+            if (chunk != nullptr && chunk->present[slot])
+            {
+                chunk->present[slot] = false;
+                chunk->values[slot] = T {};
+                --m_size;
+            }
+        }
+
+        // Call a function on every entry, in ID order, optionally skipping
+        // nodes older than a given ID.
+        template <typename F>
+        void for_each(F f, NodeId first = 0)
+        {
+            each_slot(*this, first, [&] (Chunk& c, std::size_t slot) { f(c.values[slot]); });
+        }
+
+        template <typename F>
+        void for_each(F f, NodeId first = 0) const
+        {
+            each_slot(*this, first, [&] (const Chunk& c, std::size_t slot) { f(c.values[slot]); });
+        }
+
+        void clear()
+        {
+            m_chunks.clear();
+            m_first_chunk = 0;
+            m_size = 0;
+        }
+
+        // Number of nodes with entries.
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        // Number of slots allocated, used or not.
+        std::size_t capacity() const
+        {
+            return chunk_size * std::count_if(m_chunks.begin(), m_chunks.end(),
+                [] (const std::unique_ptr<Chunk>& c) { return c != nullptr; });
+        }
+
+        private:
+        Chunk* existing_chunk(NodeId id) const
+        {
+            std::size_t index = id >> chunk_bits;
+            if (index < m_first_chunk || index - m_first_chunk >= m_chunks.size())
+            {
+                return nullptr;
+            }
+
+            return m_chunks[index - m_first_chunk].get();
+        }
+
+        Chunk& chunk_for(NodeId id)
+        {
+            std::size_t index = id >> chunk_bits;
+
+            if (m_chunks.empty())
+            {
+                m_first_chunk = index;
+            }
+            else if (index < m_first_chunk)
+            {
+                // Only the list of chunks moves, not the chunks themselves.
+                std::vector<std::unique_ptr<Chunk>> chunks (m_first_chunk - index + m_chunks.size());
+                std::move(m_chunks.begin(), m_chunks.end(), chunks.begin() + (m_first_chunk - index));
+                m_chunks = std::move(chunks);
+                m_first_chunk = index;
+            }
+
+            auto offset = index - m_first_chunk;
+            if (offset >= m_chunks.size())
+            {
+                m_chunks.resize(offset + 1);
+            }
+
+            auto& chunk = m_chunks[offset];
+            if (!chunk)
+            {
+                chunk = std::make_unique<Chunk>();
+            }
+
+            return *chunk;
+        }
+
+        // Entries can't be added while this is running, since that might
+        // shift the list of chunks.
+        template <typename Self, typename F>
+        static void each_slot(Self& self, NodeId first, F f)
+        {
+            std::size_t first_index = first >> chunk_bits;
+            std::size_t start = first_index > self.m_first_chunk ? first_index - self.m_first_chunk : 0;
+
+            for (std::size_t i = start; i < self.m_chunks.size(); ++i)
+            {
+                auto chunk = self.m_chunks[i].get();
+                if (chunk == nullptr) continue;
+
+                auto base = (self.m_first_chunk + i) << chunk_bits;
+                for (std::size_t slot = 0; slot < chunk_size; ++slot)
+                {
+                    if (base + slot >= first && chunk->present[slot])
+                    {
+                        f(*chunk, slot);
+                    }
+                }
+            }
+        }
+
+        // Chunk `i` in the list holds IDs starting at `(m_first_chunk + i) * chunk_size`.
+        std::vector<std::unique_ptr<Chunk>> m_chunks;
+        std::size_t m_first_chunk = 0;
+        std::size_t m_size = 0;
+    };
+}}
+
+#endif /* RHEA_AST_NODE_MAP_HPP */
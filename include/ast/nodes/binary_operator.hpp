@@ -50,11 +50,11 @@ namespace rhea { namespace ast {
             : op(o), left(std::move(l)), right(std::move(r)) {}
 
         const BinaryOperators op;
-        const expression_ptr left;
-        const expression_ptr right;
+        expression_ptr left;
+        expression_ptr right;
 
         types::TypeInfo expression_type() override;
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string()
             { return fmt::format("(BinaryOp,{0},{1},{2})",
                 static_cast<int>(op), left->to_string(), right->to_string()); }
@@ -75,7 +75,7 @@ namespace rhea { namespace ast {
         const expression_ptr object;
 
         types::TypeInfo expression_type() override;
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(Member,{0},{1})", member->to_string(), object->to_string()); }
     };
@@ -91,7 +91,7 @@ namespace rhea { namespace ast {
         const expression_ptr index;
 
         types::TypeInfo expression_type() override;
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(Subscript,{0},{1})", container->to_string(), index->to_string()); }
     };
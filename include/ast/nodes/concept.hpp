@@ -31,7 +31,7 @@ namespace rhea { namespace ast {
         std::string name;
         std::unique_ptr<Typename> concept_type;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(ConceptMatch,{0},{1})", name, concept_type->to_string()); }
     };
@@ -47,7 +47,7 @@ namespace rhea { namespace ast {
         std::string type;
         std::string member;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(MemberCheck,{0},{1})", type, member); }
     };
@@ -66,7 +66,7 @@ namespace rhea { namespace ast {
         child_vector<Typename> function_arguments;
         std::unique_ptr<Typename> return_type_name;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 
@@ -88,7 +88,7 @@ namespace rhea { namespace ast {
         std::string type;
         std::vector<ConceptCheck> body;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 }}
@@ -26,11 +26,11 @@ namespace rhea { namespace ast {
         If(expression_ptr c, statement_ptr t, statement_ptr e) :
             condition(std::move(c)), then_case(std::move(t)), else_case(std::move(e)) {}
 
-        const expression_ptr condition;
+        expression_ptr condition;
         const statement_ptr then_case;
         const statement_ptr else_case;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override { return fmt::format("(If,{0},{1},{2})", condition->to_string(),
             then_case != nullptr ? then_case->to_string() : "null",
             else_case != nullptr ? else_case->to_string() : "null"); }
@@ -43,10 +43,10 @@ namespace rhea { namespace ast {
         While(expression_ptr c, statement_ptr b)
             : condition(std::move(c)), body(std::move(b)) {}
 
-        const expression_ptr condition;
+        expression_ptr condition;
         const statement_ptr body;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(While,{0},{1})", condition->to_string(), body->to_string()); }
     };
@@ -61,10 +61,10 @@ namespace rhea { namespace ast {
             : index(i), range(std::move(r)), body(std::move(b)) {}
 
         const std::string index;
-        const expression_ptr range;
+        expression_ptr range;
         const statement_ptr body;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(For,{0},{1},{2})", index, range->to_string(), body->to_string()); }
     };
@@ -82,7 +82,7 @@ namespace rhea { namespace ast {
         
         types::TypeInfo expression_type() override 
             { return types::SimpleType(types::BasicType::Boolean); }
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string();
     };
 
@@ -96,7 +96,7 @@ namespace rhea { namespace ast {
         const statement_ptr body;
         child_vector<PredicateCall> predicates;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 
@@ -106,7 +106,7 @@ namespace rhea { namespace ast {
         public:
         Break() {}
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override { return "(Break)"; }
     };
 
@@ -115,7 +115,7 @@ namespace rhea { namespace ast {
         public:
         Continue() {}
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override { return "(Continue)"; }
     };
 
@@ -125,18 +125,19 @@ namespace rhea { namespace ast {
     class Case : public ASTNode {};
 
     // "On" cases are like traditional C-style switch cases, but they can be
-    // any constant expression.
+    // any constant expression. One case can match more than one value
+    // (`on 1, 2: ...`), all of which share the same body.
     class On : public Case
     {
         public:
-        On(expression_ptr c, statement_ptr b) : case_expr(std::move(c)), body(std::move(b)) {}
+        On(expression_ptr c, statement_ptr b);
+        On(child_vector<Expression>& cs, statement_ptr b);
 
-        expression_ptr case_expr;
+        child_vector<Expression> case_values;
         statement_ptr body;
 
-        util::any visit(visitor::Visitor* v) override;
-        std::string to_string() override
-            { return fmt::format("(On,{0},{1})", case_expr->to_string(), body->to_string()); }
+        void accept(visitor::VisitorBase* v) override;
+        std::string to_string() override;
     };
 
     // "When" cases are predicate-based.
@@ -149,7 +150,7 @@ namespace rhea { namespace ast {
         std::unique_ptr<PredicateCall> predicate;
         statement_ptr body;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(When,{0},{1})", predicate->to_string(), body->to_string()); }
     };
@@ -164,7 +165,7 @@ namespace rhea { namespace ast {
         std::unique_ptr<Typename> type_name;
         statement_ptr body;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(TypeCase,{0},{1})", type_name->to_string(), body->to_string()); }
     };
@@ -177,7 +178,7 @@ namespace rhea { namespace ast {
 
         statement_ptr body;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(Default,{0})", body->to_string()); }
     };
@@ -192,7 +193,7 @@ namespace rhea { namespace ast {
         expression_ptr expression;
         child_vector<Case> cases;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 }}
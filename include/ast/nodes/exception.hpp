@@ -27,7 +27,7 @@ namespace rhea { namespace ast {
         std::unique_ptr<TypePair> catch_type;
         statement_ptr body;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(Catch,{0},{1})", catch_type->to_string(), body->to_string()); }
     };
@@ -42,7 +42,7 @@ namespace rhea { namespace ast {
 
         expression_ptr exception;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override { return fmt::format("(Throw,{0})", exception->to_string()); }
     };
 
@@ -55,7 +55,7 @@ namespace rhea { namespace ast {
 
         statement_ptr body;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override { return fmt::format("(Finally,{0})", body->to_string()); }
     };
 
@@ -72,7 +72,7 @@ namespace rhea { namespace ast {
         // Note: We name it like this just in case C++ ever adds a `finally` keyword.
         std::unique_ptr<Finally> finally_block;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 
@@ -26,7 +26,7 @@ namespace rhea { namespace ast {
         const std::string name;
         const expression_ptr value;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(NamedArgument,{0},{1})", name, value->to_string()); }
     };
@@ -48,7 +48,12 @@ namespace rhea { namespace ast {
         const expression_ptr target;
         std::vector<function_argument> arguments;
 
-        util::any visit(visitor::Visitor* v) override;
+        // The suffix on the call (e.g., `valid(x)?`), which says what kind
+        // of function is being called.
+        FunctionType type = FunctionType::Basic;
+
+        types::TypeInfo expression_type() override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 
@@ -65,7 +70,7 @@ namespace rhea { namespace ast {
 
         child_vector<TypePair> arguments;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 
@@ -79,7 +84,7 @@ namespace rhea { namespace ast {
         const std::string target;
         const expression_ptr predicate;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(Condition,{0},{1})", target, predicate->to_string()); }
     };
@@ -112,7 +117,7 @@ namespace rhea { namespace ast {
         child_vector<Condition> conditions;
         const statement_ptr body;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
         std::string function_type_string();
     };
@@ -141,7 +146,7 @@ namespace rhea { namespace ast {
 
         std::vector<GenericMatch> generic_types;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 
@@ -152,9 +157,9 @@ namespace rhea { namespace ast {
         public:
         Return(expression_ptr v): value(std::move(v)) {}
 
-        const expression_ptr value;
+        expression_ptr value;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override { return fmt::format("(Return,{0})", value->to_string()); }
     };
 
@@ -168,7 +173,7 @@ namespace rhea { namespace ast {
 
         const std::string name;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override { return fmt::format("(Extern,{0})", name); }
     };
 }}
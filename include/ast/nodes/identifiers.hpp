@@ -9,6 +9,7 @@
 
 #include "node_base.hpp"
 
+#include "util/interned_string.hpp"
 #include "util/serialize_array.hpp"
 
 /*
@@ -34,17 +35,17 @@ namespace rhea { namespace ast {
     class Identifier : public AnyIdentifier
     {
         public:
-        Identifier(std::string n): name(n) {}
+        Identifier(util::InternedString n): name(n) {}
 
-        const std::string name;
+        const util::InternedString name;
 
-        std::string canonical_name() const override { return name; }
+        std::string canonical_name() const override { return name.str(); }
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         types::TypeInfo expression_type() override
             { return m_expression_type; }
         std::string to_string() override
-            { return fmt::format("(Identifier,{0})", name); }
+            { return fmt::format("(Identifier,{0})", name.str()); }
 
         // Variables (and other uses of identifiers) do not have known types at compile time,
         // so we must have some way of identifying them.
@@ -66,7 +67,7 @@ namespace rhea { namespace ast {
 
         std::string canonical_name() const override;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         types::TypeInfo expression_type() override
             { return m_expression_type; }
         std::string to_string() override;
@@ -84,20 +85,20 @@ namespace rhea { namespace ast {
     class RelativeIdentifier : public AnyIdentifier
     {
         public:
-        RelativeIdentifier(std::unique_ptr<Identifier> id, std::string mn);
-        RelativeIdentifier(std::unique_ptr<FullyQualified> id, std::string mn);
+        RelativeIdentifier(std::unique_ptr<Identifier> id, util::InternedString mn);
+        RelativeIdentifier(std::unique_ptr<FullyQualified> id, util::InternedString mn);
 
         RelativeIdentifier(std::unique_ptr<Identifier> id)
             : RelativeIdentifier(std::move(id), "") {}
         RelativeIdentifier(std::unique_ptr<FullyQualified> id)
             : RelativeIdentifier(std::move(id), "") {}
 
-        std::string module_name;
+        util::InternedString module_name;
         child_vector<Identifier> children;
 
         std::string canonical_name() const override;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         types::TypeInfo expression_type() override
             { return m_expression_type; }
         std::string to_string() override;
@@ -49,7 +49,7 @@ namespace rhea { namespace ast {
             { return types::SimpleType { numeric_type<template_type>(), true, true }; }
         std::string to_string() override
             { return fmt::format("(Integral,{0},{1})", value, static_cast<int>(type)); }
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
     };
 
     // This node class represents floating-point types. Again, it's
@@ -71,7 +71,7 @@ namespace rhea { namespace ast {
             { return types::SimpleType { numeric_type<template_type>(), true, false }; }
         std::string to_string() override
             { return fmt::format("(FloatingPoint,{0},{1})", value, static_cast<int>(type)); }
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
     };
 
     // Convenience declarations for the defined types.
@@ -97,7 +97,7 @@ namespace rhea { namespace ast {
         types::TypeInfo expression_type() override
             { return types::SimpleType { BasicType::Boolean, false }; }
         std::string to_string() { return fmt::format("(Boolean,{0})", value); }
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
     };
 
     // For the string literal class, we have to think about encodings.
@@ -114,7 +114,7 @@ namespace rhea { namespace ast {
             { return types::SimpleType { BasicType::String, false }; }
         std::string to_string() override
             { return fmt::format("(String,\"{0}\")", value); }
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
     };
 
     // The symbol node class stores the name of the symbol. We can use that
@@ -131,7 +131,7 @@ namespace rhea { namespace ast {
             { return types::SimpleType { BasicType::Symbol, false }; }
         std::string to_string() override
             { return fmt::format("(Symbol,{0})", value); }
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
     };
 
     // For the "nothing" node class, we don't have to store much of anything.
@@ -148,7 +148,7 @@ namespace rhea { namespace ast {
             { return types::NothingType(); }
         std::string to_string() override
             { return fmt::format("(Nothing)"); }
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
     };
 }}
 
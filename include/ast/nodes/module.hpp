@@ -23,7 +23,7 @@ namespace rhea { namespace ast {
 
         child_vector<Statement> children;
         
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 
@@ -34,7 +34,7 @@ namespace rhea { namespace ast {
 
         child_vector<Statement> children;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 
@@ -45,11 +45,11 @@ namespace rhea { namespace ast {
         public:
         ModuleName(std::unique_ptr<AnyIdentifier> id) : name(id->canonical_name()) {}
 
-        const std::string name;
+        const util::InternedString name;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
-        { return fmt::format("(ModuleName,{0})", name); }
+        { return fmt::format("(ModuleName,{0})", name.str()); }
     };
 
     class ModuleDef : public Statement
@@ -58,7 +58,7 @@ namespace rhea { namespace ast {
         ModuleDef(std::unique_ptr<ModuleName> n) : name(std::move(n)) {}
 
         const std::unique_ptr<ModuleName> name;
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(ModuleDef,{0})", name->to_string()); }
     };
@@ -69,7 +69,7 @@ namespace rhea { namespace ast {
         Use(std::unique_ptr<ModuleName> m) : module(std::move(m)) {}
 
         const std::unique_ptr<ModuleName> module;
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(Use,{0})", module->to_string()); }
     };
@@ -82,7 +82,7 @@ namespace rhea { namespace ast {
         child_vector<Identifier> imports;
         const std::unique_ptr<ModuleName> module;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 
@@ -93,7 +93,7 @@ namespace rhea { namespace ast {
 
         child_vector<Identifier> exports;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 }}
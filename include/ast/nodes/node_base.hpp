@@ -1,6 +1,7 @@
 #ifndef RHEA_AST_NODE_BASE_HPP
 #define RHEA_AST_NODE_BASE_HPP
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
@@ -8,7 +9,9 @@
 
 #include <tao/pegtl.hpp>
 
+#include "../arena.hpp"
 #include "../parse_tree_node.hpp"
+#include "../../source/source_manager.hpp"
 #include "../../types/types.hpp"
 #include "../../util/compat.hpp"
 #include "../../visitor/visitor_fwd.hpp"
@@ -32,17 +35,58 @@
  */
 
 namespace rhea { namespace ast {
+    // Every node gets a small integer ID when it's created. These are handed
+    // out in order, so the nodes of a tree have (more or less) consecutive IDs,
+    // and later passes can keep per-node data in flat tables indexed by them.
+    // See node_map.hpp.
+    using NodeId = std::uint32_t;
+
     // The base type for all AST nodes
     class ASTNode
     {
         public:
-        ASTNode(): position({}, "") {}
-        virtual ~ASTNode() {}
+        ASTNode() : id(next_id()), m_arena(Arena::current()) {}
+        virtual ~ASTNode();
+
+        // A copy is a different node, so it gets its own ID (and memory).
+        ASTNode(const ASTNode& other)
+            : position(other.position), id(next_id()), m_arena(Arena::current()) {}
+        ASTNode& operator=(const ASTNode& other) { position = other.position; return *this; }
 
         virtual std::string to_string() = 0;
-        virtual util::any visit(visitor::Visitor* v);
 
-        tao::pegtl::position position;
+        // Double dispatch for visitors. Each node class overrides `accept`;
+        // callers use `visit`, which returns whatever the visitor's own
+        // `visit` methods return. (It's defined in visitor/visitor.hpp.)
+        virtual void accept(visitor::VisitorBase* v);
+
+        template <typename R>
+        R visit(visitor::Visitor<R>* v);
+
+        // All nodes are allocated from the current arena, if there is
+        // one, or the heap otherwise. See arena.hpp.
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr) noexcept;
+
+        // Where the node's text starts. This is only a handle; use the
+        // source manager to get the file name, line, and so on.
+        source::SourceLocation position;
+
+        // This node's ID. No two nodes share one.
+        NodeId id;
+
+        // The number of IDs handed out so far. Every existing node's ID
+        // is less than this.
+        static NodeId id_count();
+
+        private:
+        static NodeId next_id();
+
+        // The arena this node was allocated from, if any. This is the same
+        // one operator new used, since the two run back to back. Nodes that
+        // weren't made with `new` may have one, too, but they never get to
+        // operator delete, so it doesn't matter.
+        Arena* m_arena;
     };
 
     // "Top-level" node types
@@ -53,13 +97,13 @@ namespace rhea { namespace ast {
         // so we make it a method.
         virtual types::TypeInfo expression_type() { return types::UnknownType{}; }
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
     };
 
     class Statement : public ASTNode
     {
         public:
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         // TODO: Some statements can declare symbols. If we make a quick
         // pass through some levels of the AST, we can pick these out,
         // which saves us from having to forward declare as in C/C++.
@@ -24,9 +24,9 @@ namespace rhea { namespace ast {
         public:
         BareExpression(expression_ptr e): expression(std::move(e)) {}
 
-        const expression_ptr expression;
+        expression_ptr expression;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(BareExpression,{0})", expression->to_string()); }
     };
@@ -39,7 +39,7 @@ namespace rhea { namespace ast {
         public:
         Block(child_vector<Statement>& ss);
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
 
         child_vector<Statement> children;
@@ -72,9 +72,9 @@ namespace rhea { namespace ast {
         Assign(expression_ptr l, expression_ptr r): lhs(std::move(l)), rhs(std::move(r)) {}
 
         const expression_ptr lhs;
-        const expression_ptr rhs;
+        expression_ptr rhs;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(Assign,{0},{1})", lhs->to_string(), rhs->to_string()); }
     };
@@ -89,9 +89,9 @@ namespace rhea { namespace ast {
 
         const expression_ptr lhs;
         const AssignOperator op;
-        const expression_ptr rhs;
+        expression_ptr rhs;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         // Note reordering of members in the string representation.
         // String version is (LHS, RHS, OP).
         std::string to_string() override
@@ -111,7 +111,7 @@ namespace rhea { namespace ast {
         const std::unique_ptr<Identifier> lhs;
         const std::unique_ptr<Typename> rhs;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(TypeDeclaration,{0},{1})", lhs->to_string(), rhs->to_string()); }
     };
@@ -127,9 +127,9 @@ namespace rhea { namespace ast {
             : lhs(std::move(l)), rhs(std::move(r)) {}
 
         const std::unique_ptr<Identifier> lhs;
-        const expression_ptr rhs;
+        expression_ptr rhs;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(Variable,{0},{1})", lhs->to_string(), rhs->to_string()); }
     };
@@ -144,9 +144,9 @@ namespace rhea { namespace ast {
             : lhs(std::move(l)), rhs(std::move(r)) {}
 
         const std::unique_ptr<Identifier> lhs;
-        const expression_ptr rhs;
+        expression_ptr rhs;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(Constant,{0},{1})", lhs->to_string(), rhs->to_string()); }
     };
@@ -161,7 +161,7 @@ namespace rhea { namespace ast {
 
         const expression_ptr expression;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override { return fmt::format("(Do,{0})", expression->to_string()); }
     };
 }}
@@ -41,7 +41,7 @@ namespace rhea { namespace ast {
         public:
         Array(child_vector<Expression>& es) : Container(es) {}
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override { return to_string_base("Array"); }
     };
 
@@ -50,7 +50,7 @@ namespace rhea { namespace ast {
         public:
         List(child_vector<Expression>& es) : Container(es) {}
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override { return to_string_base("List"); }
     };
 
@@ -59,7 +59,7 @@ namespace rhea { namespace ast {
         public:
         Tuple(child_vector<Expression>& es) : Container(es) {}
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override { return to_string_base("Tuple"); }
     };
 
@@ -85,7 +85,7 @@ namespace rhea { namespace ast {
         DictionaryKey key;
         expression_ptr value;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 
@@ -97,7 +97,7 @@ namespace rhea { namespace ast {
 
         child_vector<DictionaryEntry> items;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 
@@ -111,7 +111,7 @@ namespace rhea { namespace ast {
         const std::unique_ptr<Identifier> name;
         child_vector<TypePair> fields;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 }}
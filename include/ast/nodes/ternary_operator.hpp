@@ -19,12 +19,12 @@ namespace rhea { namespace ast {
         TernaryOp(expression_ptr c, expression_ptr t, expression_ptr f) :
             condition(std::move(c)), true_branch(std::move(t)), false_branch(std::move(f)) {}
 
-        const expression_ptr condition;
-        const expression_ptr true_branch;
-        const expression_ptr false_branch;
+        expression_ptr condition;
+        expression_ptr true_branch;
+        expression_ptr false_branch;
 
         types::TypeInfo expression_type() override { return true_branch->expression_type(); }
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string()
          { return fmt::format("(TernaryOp,{0},{1},{2})",
             condition->to_string(), true_branch->to_string(), false_branch->to_string()); }
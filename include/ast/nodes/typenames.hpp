@@ -25,7 +25,7 @@ namespace rhea { namespace ast {
         public:
         GenericTypename(child_vector<Typename>& c);
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
 
         child_vector<Typename> children;
@@ -38,7 +38,7 @@ namespace rhea { namespace ast {
         public:
         ArrayTypename(child_vector<Expression>& a);
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
 
         child_vector<Expression> children;
@@ -70,7 +70,7 @@ namespace rhea { namespace ast {
 
         virtual std::string canonical_name() const;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(Typename,{0},{1},{2})",
                 name->to_string(),
@@ -88,7 +88,7 @@ namespace rhea { namespace ast {
 
         std::string canonical_name() const override;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
 
         child_vector<Typename> children;
@@ -104,7 +104,7 @@ namespace rhea { namespace ast {
 
         const std::unique_ptr<Typename> type;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(Optional,{0})", type->to_string()); }
     };
@@ -118,10 +118,10 @@ namespace rhea { namespace ast {
         Cast(expression_ptr l, std::unique_ptr<Typename> r)
             : left(std::move(l)), right(std::move(r)) {}
 
-        const expression_ptr left;
+        expression_ptr left;
         const std::unique_ptr<Typename> right;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(Cast,{0},{1})", left->to_string(), right->to_string()); }
     };
@@ -136,7 +136,7 @@ namespace rhea { namespace ast {
         const expression_ptr left;
         const std::unique_ptr<Typename> right;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(TypeCheck,{0},{1})", left->to_string(), right->to_string()); }
     };
@@ -153,7 +153,7 @@ namespace rhea { namespace ast {
         const std::unique_ptr<Identifier> alias;
         const std::unique_ptr<Typename> original;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(Alias,{0},{1})", alias->to_string(), original->to_string()); }
     };
@@ -169,7 +169,7 @@ namespace rhea { namespace ast {
 
         child_vector<Symbol> symbols;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override;
     };
 
@@ -185,7 +185,7 @@ namespace rhea { namespace ast {
         const std::unique_ptr<Identifier> name;
         const std::unique_ptr<SymbolList> values;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(Enum,{0},{1})", name->to_string(), values->to_string()); }
     };
@@ -195,19 +195,19 @@ namespace rhea { namespace ast {
     class TypePair : public ASTNode
     {
         public:
-        TypePair(std::string n, std::unique_ptr<Typename> v)
+        TypePair(util::InternedString n, std::unique_ptr<Typename> v)
             : name(n), value(std::move(v)) {}
         
         // We store the name as just a string rather than an
         // Identifier AST node because we don't actually want
         // the extra functionality of the node class. This class
         // just creates a mapping, not any actual code.
-        std::string name;
+        util::InternedString name;
         std::unique_ptr<Typename> value;
 
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
-            { return fmt::format("(TypePair,{0},{1})", name, value->to_string()); }
+            { return fmt::format("(TypePair,{0},{1})", name.str(), value->to_string()); }
     };
 }}
 
@@ -29,10 +29,10 @@ namespace rhea { namespace ast {
             : op(o), operand(std::move(r)) {}
 
         const UnaryOperators op;
-        const expression_ptr operand;
+        expression_ptr operand;
 
         types::TypeInfo expression_type() override;
-        util::any visit(visitor::Visitor* v) override;
+        void accept(visitor::VisitorBase* v) override;
         std::string to_string() override
             { return fmt::format("(UnaryOp,{0},{1})", static_cast<int>(op), operand->to_string()); }
     };
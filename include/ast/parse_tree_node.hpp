@@ -1,28 +1,46 @@
 #ifndef RHEA_AST_PARSE_TREE_NODE_HPP
 #define RHEA_AST_PARSE_TREE_NODE_HPP
 
+#include <cstddef>
 #include <memory>
+#include <utility>
 
 #include <tao/pegtl.hpp>
 #include <tao/pegtl/contrib/parse_tree.hpp>
 
 #include "nodes/node_base.hpp"
+#include "rule_id.hpp"
 
 /*
  * Here we derive a custom node class for the PEGTL parse tree.
  * This allows us a little more flexibility when we go to annotate
  * the generated AST.
- * 
- * At the moment, we don't do anything with it, but we can add in
- * extra information later. Note that we'll have to adapt the AST
- * builder to handle any additional information.
+ *
+ * On top of PEGTL's own data, each node stores the dense ID of the
+ * rule that created it (see rule_id.hpp), which the AST builder uses
+ * to pick a constructor without a chain of type comparisons. Note
+ * that we'll have to adapt the AST builder to handle any additional
+ * information.
  */
 
 namespace rhea { namespace ast {
 
     struct parser_node : tao::pegtl::parse_tree::basic_node<parser_node>
     {
-        
+        using base_type = tao::pegtl::parse_tree::basic_node<parser_node>;
+
+        // Dense ID of the matching rule. The root node has no rule, so
+        // it keeps the "unknown" ID.
+        std::size_t rule = unknown_rule_id;
+
+        // The parse tree builder calls this on every non-root node, so
+        // we hook it to record the rule ID alongside PEGTL's type info.
+        template <typename Rule, typename Input, typename... States>
+        void start(const Input& in, States&&... st)
+        {
+            base_type::template start<Rule>(in, std::forward<States>(st)...);
+            rule = rule_id<Rule>::value;
+        }
     };
 }}
 
@@ -0,0 +1,169 @@
+#ifndef RHEA_AST_RULE_ID_HPP
+#define RHEA_AST_RULE_ID_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+#include "../grammar.hpp"
+
+/*
+ * Dense IDs for the grammar rules the AST builder dispatches on.
+ *
+ * PEGTL tags each parse tree node with a std::type_info pointer, which is
+ * only good for equality tests, so finding the right AST constructor meant
+ * testing a node against every rule in turn. Instead, we give each selected
+ * rule the builder understands a small integer, its position in the list
+ * below, and the builder indexes straight into a table of constructors.
+ *
+ * IDs are computed at compile time. Any rule not in the list gets
+ * `unknown_rule_id`, which is one past the last real ID, so a table
+ * indexed by rule ID needs `rule_id_count + 1` entries.
+ */
+namespace rhea { namespace ast {
+    template <typename... Rules>
+    struct rule_list {};
+
+    namespace internal {
+        // Position of Rule in a list of rules, or the list's length if it's
+        // not there at all.
+        template <typename Rule, typename... Rules>
+        struct rule_index;
+
+        template <typename Rule>
+        struct rule_index<Rule> : std::integral_constant<std::size_t, 0> {};
+
+        template <typename Rule, typename... Rules>
+        struct rule_index<Rule, Rule, Rules...>
+            : std::integral_constant<std::size_t, 0> {};
+
+        template <typename Rule, typename First, typename... Rules>
+        struct rule_index<Rule, First, Rules...>
+            : std::integral_constant<std::size_t, 1 + rule_index<Rule, Rules...>::value> {};
+
+        template <typename Rule, typename List>
+        struct rule_list_index;
+
+        template <typename Rule, typename... Rules>
+        struct rule_list_index<Rule, rule_list<Rules...>> : rule_index<Rule, Rules...> {};
+
+        template <typename List>
+        struct rule_list_size;
+
+        template <typename... Rules>
+        struct rule_list_size<rule_list<Rules...>>
+            : std::integral_constant<std::size_t, sizeof...(Rules)> {};
+    }
+
+    /*
+     * Every parse tree rule the AST builder knows how to turn into an
+     * expression or statement. The order doesn't matter, but each rule
+     * must only appear once.
+     */
+    using builder_rules = rule_list<
+        // Literals and identifiers
+        grammar::float_literal,
+        grammar::integer_literal,
+        grammar::hex_literal,
+        grammar::boolean_literal,
+        grammar::nothing_literal,
+        grammar::string_literal,
+        grammar::identifier,
+        grammar::fully_qualified,
+        grammar::relative_identifier,
+        grammar::symbol_name,
+
+        // Binary operators
+        grammar::add_operator,
+        grammar::subtract_operator,
+        grammar::multiply_operator,
+        grammar::divide_operator,
+        grammar::modulus_operator,
+        grammar::exponent_operator,
+        grammar::left_shift_operator,
+        grammar::right_shift_operator,
+        grammar::equals_operator,
+        grammar::not_equal_operator,
+        grammar::less_than_operator,
+        grammar::greater_than_operator,
+        grammar::less_equal_operator,
+        grammar::greater_equal_operator,
+        grammar::bitand_operator,
+        grammar::bitor_operator,
+        grammar::bitxor_operator,
+        grammar::kw_and,
+        grammar::kw_or,
+
+        // Unary operators
+        grammar::coerce_operator,
+        grammar::bitnot_operator,
+        grammar::dereference_operator,
+        grammar::unary_plus_operator,
+        grammar::unary_minus_operator,
+        grammar::kw_not,
+        grammar::kw_ref,
+        grammar::kw_ptr,
+
+        // Other expressions
+        grammar::array_expression,
+        grammar::list_expression,
+        grammar::tuple_expression,
+        grammar::symbol_list_expression,
+        grammar::dictionary_expression,
+        grammar::member_expr,
+        grammar::subscript_expr,
+        grammar::ternary_op,
+        grammar::kw_as,
+        grammar::kw_is,
+        grammar::function_call_expr,
+
+        // Statements
+        grammar::bare_expression,
+        grammar::statement_block,
+        grammar::variable_declaration,
+        grammar::declaration_as_type,
+        grammar::constant_declaration,
+        grammar::assignment,
+        grammar::compound_assignment,
+        grammar::type_alias,
+        grammar::enum_declaration,
+        grammar::structure_declaration,
+        grammar::do_statement,
+        grammar::if_statement,
+        grammar::unless_statement,
+        grammar::while_statement,
+        grammar::for_statement,
+        grammar::kw_break,
+        grammar::kw_continue,
+        grammar::with_statement,
+        grammar::match_on_statement,
+        grammar::match_when_statement,
+        grammar::match_type_statement,
+        grammar::basic_function_def,
+        grammar::unchecked_function_def,
+        grammar::predicate_function_def,
+        grammar::operator_function_def,
+        grammar::return_statement,
+        grammar::extern_declaration,
+        grammar::throw_statement,
+        grammar::finally_statement,
+        grammar::catch_statement,
+        grammar::try_statement,
+        grammar::concept_definition,
+        grammar::module_statement,
+        grammar::use_statement,
+        grammar::import_statement,
+        grammar::export_statement
+    >;
+
+    // Number of rules with a real ID.
+    constexpr std::size_t rule_id_count = internal::rule_list_size<builder_rules>::value;
+
+    // ID given to any rule the builder doesn't dispatch on.
+    constexpr std::size_t unknown_rule_id = rule_id_count;
+
+    // The dense ID for a grammar rule.
+    template <typename Rule>
+    struct rule_id : internal::rule_list_index<Rule, builder_rules> {};
+}}
+
+#endif /* RHEA_AST_RULE_ID_HPP */
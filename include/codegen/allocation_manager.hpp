@@ -2,11 +2,12 @@
 #define RHEA_CODEGEN_ALLOCA_MGR_HPP
 
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 #include <llvm/IR/Instructions.h>
 
 #include "../util/compat.hpp"
+#include "../util/scoped_table.hpp"
 
 /*
  * A manager to track allocations in LLVM IR. This is needed because variable
@@ -15,25 +16,32 @@
  * Design-wise, it mostly mirrors the Rhea scope manager (state/symbol.hpp).
  */
 namespace rhea { namespace codegen {
-    using AllocaTable = std::unordered_map<std::string, llvm::AllocaInst*>;
+    using AllocaTable = util::ScopedTable<std::string, llvm::AllocaInst*>;
 
     struct AllocationScope
     {
         std::string name;
-        AllocaTable alloca_table;
     };
 
     struct AllocationManager
     {
-        AllocationManager() : m_stack({ {"$global", {}} }) {}
+        AllocationManager() : m_stack({ {"$global"} }) {}
 
         // Add a new allocation scope to the stack, optionally with a name.
-        void push() { m_stack.push_back({}); }
-        void push(std::string name) { m_stack.push_back({name, {}}); }
+        void push() { push(""); }
+        void push(std::string name)
+        {
+            m_stack.push_back({name});
+            m_table.push();
+        }
 
         // Delete the current scope. This is done at the end of a scoping
         // block to prevent contamination of unrelated blocks.
-        void pop() { m_stack.pop_back(); }
+        void pop()
+        {
+            m_table.pop();
+            m_stack.pop_back();
+        }
 
         // Add a new entry to the current allocation scope.
         void add(std::string name, llvm::AllocaInst* ai);
@@ -46,12 +54,10 @@ namespace rhea { namespace codegen {
         util::optional<llvm::AllocaInst*> find(std::string key);
 
         private:
-        // We use a vector rather than a stack here, even though we call
-        // it a stack. That's because the standard libaray's stack is
-        // an adapter over vector (usually) which only allows access to
-        // the topmost item. We need to be able to iterate through the
-        // stack to find outer entries, so that won't work here.
+        // The scope stack only holds names; the allocations for every
+        // open scope are kept together in one table.
         std::vector<AllocationScope> m_stack;
+        AllocaTable m_table;
     };
 }}
 
@@ -17,47 +17,52 @@
 #include "../types/to_string.hpp"
 #include "../util/compat.hpp"
 #include "../util/symbol_hash.hpp"
+#include "../util/symbol_table.hpp"
 #include "../visitor/visitor.hpp"
 #include "../visitor/default.hpp"
 #include "generator_fwd.hpp"
+#include "cost.hpp"
 #include "type_convert.hpp"
 
 /*
  * The AST visitor for the code generation pass of the Rhea compiler.
  */
 namespace rhea { namespace codegen {
-    using util::any;
+    using llvm::Value;
     using namespace rhea::ast;
 
-    struct CodeVisitor : visitor::DefaultVisitor
+    struct CodeVisitor : visitor::DefaultVisitor<Value*>
     {
         CodeVisitor(CodeGenerator* g) : generator(g) {}
         CodeGenerator* generator = nullptr;
 
         // Code generation visitors for AST nodes.
         // Only those nodes which generate code should be here.
-        any visit(Boolean* n) override;
-        any visit(Integer* n) override;
-        any visit(Byte* n) override;
-        any visit(Long* n) override;
-        any visit(UnsignedInteger* n) override;
-        any visit(UnsignedByte* n) override;
-        any visit(UnsignedLong* n) override;
-        any visit(Float* n) override;
-        any visit(Double* n) override;
-        any visit(Symbol* n) override;
-        any visit(Nothing* n) override;
-        any visit(Identifier* n) override;
-        any visit(BinaryOp* n) override;
-        any visit(UnaryOp* n) override;
-        any visit(TernaryOp* n) override;
+        Value* visit(Boolean* n) override;
+        Value* visit(Integer* n) override;
+        Value* visit(Byte* n) override;
+        Value* visit(Long* n) override;
+        Value* visit(UnsignedInteger* n) override;
+        Value* visit(UnsignedByte* n) override;
+        Value* visit(UnsignedLong* n) override;
+        Value* visit(Float* n) override;
+        Value* visit(Double* n) override;
+        Value* visit(Symbol* n) override;
+        Value* visit(Nothing* n) override;
+        Value* visit(Identifier* n) override;
+        Value* visit(BinaryOp* n) override;
+        Value* visit(UnaryOp* n) override;
+        Value* visit(TernaryOp* n) override;
+        Value* visit(Call* n) override;
 
-        any visit(If* n) override;
-        any visit(BareExpression* n) override;
-        any visit(Block* n) override;
-        any visit(TypeDeclaration* n) override;
-        any visit(Variable* n) override;
-        any visit(Constant* n) override;
+        Value* visit(If* n) override;
+        Value* visit(Match* n) override;
+        Value* visit(BareExpression* n) override;
+        Value* visit(Block* n) override;
+        Value* visit(TypeDeclaration* n) override;
+        Value* visit(Enum* n) override;
+        Value* visit(Variable* n) override;
+        Value* visit(Constant* n) override;
     };
 }}
 
@@ -0,0 +1,64 @@
+#ifndef RHEA_CODEGEN_COST_HPP
+#define RHEA_CODEGEN_COST_HPP
+
+#include <limits>
+
+#include "../ast.hpp"
+#include "../visitor/visitor.hpp"
+#include "../visitor/default.hpp"
+
+/*
+ * A rough estimate of what it costs to evaluate an expression, used when
+ * codegen has a choice between branching around some code and running it
+ * unconditionally (e.g., `select` versus a branch and PHI for the ternary
+ * operator).
+ *
+ * Costs are counted in something like "simple instructions". Anything that
+ * can't safely be evaluated when it isn't needed, like a call or a division
+ * that might trap, gets the unbounded cost, and so does anything we don't
+ * know about yet. That way, new node types are never speculated by accident.
+ */
+namespace rhea { namespace codegen {
+    constexpr unsigned unbounded_cost = std::numeric_limits<unsigned>::max();
+
+    // Both arms of a ternary together can cost this much and still use a
+    // `select`. That's about what LLVM itself is willing to speculate.
+    constexpr unsigned select_cost_limit = 4;
+
+    // The result type for the cost visitor. It only exists so that the
+    // default for unhandled nodes is "too expensive" instead of 0.
+    struct Cost
+    {
+        unsigned value = unbounded_cost;
+    };
+
+    struct CostVisitor : visitor::DefaultVisitor<Cost>
+    {
+        using visitor::DefaultVisitor<Cost>::visit;
+
+        Cost visit(ast::Boolean* n) override;
+        Cost visit(ast::Integer* n) override;
+        Cost visit(ast::Byte* n) override;
+        Cost visit(ast::Long* n) override;
+        Cost visit(ast::UnsignedInteger* n) override;
+        Cost visit(ast::UnsignedByte* n) override;
+        Cost visit(ast::UnsignedLong* n) override;
+        Cost visit(ast::Float* n) override;
+        Cost visit(ast::Double* n) override;
+        Cost visit(ast::Symbol* n) override;
+        Cost visit(ast::Nothing* n) override;
+        Cost visit(ast::Identifier* n) override;
+        Cost visit(ast::BinaryOp* n) override;
+        Cost visit(ast::UnaryOp* n) override;
+        Cost visit(ast::TernaryOp* n) override;
+        Cost visit(ast::Cast* n) override;
+    };
+
+    // The estimated cost of an expression.
+    unsigned evaluation_cost(ast::Expression* e);
+
+    // Should this ternary be lowered to a `select`, evaluating both arms?
+    bool should_use_select(ast::TernaryOp* n);
+}}
+
+#endif /* RHEA_CODEGEN_COST_HPP */
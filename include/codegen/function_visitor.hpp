@@ -16,10 +16,9 @@
  * to declare functions whose first use appears before their definition.
  */
 namespace rhea { namespace codegen {
-    using util::any;
     using namespace rhea::ast;
 
-    struct FunctionVisitor : visitor::DefaultVisitor
+    struct FunctionVisitor : visitor::DefaultVisitor<void>
     {
         using argument_map = std::map<std::string, types::TypeInfo>;
 
@@ -31,26 +30,26 @@ namespace rhea { namespace codegen {
         FunctionVisitor() : FunctionVisitor(types::UnknownType(), {}) {}
 
         // We only need to override the visitor methods that can possibly
-        // lead to a return value. Note that, although these return "any"s,
-        // almost all will actually return nothing, instead tracking the
-        // resulting return type in the state variable below.
+        // lead to a return value. These don't return anything themselves,
+        // instead tracking the resulting return type in the state variable
+        // below.
 
-        any visit(If*) override;
-        any visit(While*) override;
-        any visit(For*) override;
-        any visit(With*) override;
-        any visit(Match*) override;
-        any visit(On*) override;
-        any visit(When*) override;
-        any visit(TypeCase*) override;
-        any visit(Default*) override;
-        any visit(Def*) override;
-        any visit(GenericDef*) override;
-        any visit(Return*) override;
-        any visit(Block* n) override;
-        any visit(Try* n) override;
-        any visit(Catch* n) override;
-        any visit(Finally* n) override;
+        void visit(If*) override;
+        void visit(While*) override;
+        void visit(For*) override;
+        void visit(With*) override;
+        void visit(Match*) override;
+        void visit(On*) override;
+        void visit(When*) override;
+        void visit(TypeCase*) override;
+        void visit(Default*) override;
+        void visit(Def*) override;
+        void visit(GenericDef*) override;
+        void visit(Return*) override;
+        void visit(Block* n) override;
+        void visit(Try* n) override;
+        void visit(Catch* n) override;
+        void visit(Finally* n) override;
 
         // We keep track of all the return types we've found while traversing
         // the AST. If these don't match, or if they're not the same as the one
@@ -60,5 +59,9 @@ namespace rhea { namespace codegen {
 
         // The arguments of the function may come in handy.
         argument_map argument_types;
+
+        // Where return values get their types (see `CodeGenerator::type_of`).
+        // Without a generator, each value is asked for its own type.
+        CodeGenerator* generator = nullptr;
     };
 }}
\ No newline at end of file
@@ -2,25 +2,26 @@
 #define RHEA_CODEGEN_GENERATOR_HPP
 
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 #include <llvm/IR/Module.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/PassManager.h>
 #include <llvm/Passes/PassBuilder.h>
-#include "llvm/Support/TargetRegistry.h"
-#include "llvm/Support/TargetSelect.h"
 #include "llvm/Target/TargetMachine.h"
-#include "llvm/Target/TargetOptions.h"
 
 #include "../ast.hpp"
 #include "../state/symbol.hpp"
 #include "../types/types.hpp"
+#include "../types/type_table.hpp"
 #include "../types/mapper.hpp"
 #include "../util/compat.hpp"
 #include "code_visitor.hpp"
 #include "allocation_manager.hpp"
+#include "target.hpp"
 
 /*
  * The core class for Rhea code generation using LLVM.
@@ -32,6 +33,30 @@ namespace rhea { namespace codegen {
     // Forward declaration for helper class.
     struct TypeBuilder;
 
+    // Optimization levels, matching the usual compiler options.
+    enum class OptimizationLevel
+    {
+        O0,     // None at all, for the fastest edit-compile cycle
+        O1,
+        O2,
+        O3,     // Everything, for release builds
+        Os,     // Optimize for size
+        Oz      // Optimize for size, even at the cost of speed
+    };
+
+    struct OptimizationOptions
+    {
+        OptimizationLevel level = OptimizationLevel::O0;
+
+        // Passes to run after the standard pipeline, in LLVM's textual
+        // pipeline syntax, e.g., "instcombine" or "function(sroa)".
+        std::vector<std::string> extra_passes;
+
+        // Passes to skip, using the names LLVM reports for them, e.g.,
+        // "LoopUnrollPass" or "InlinerPass".
+        std::set<std::string> disabled_passes;
+    };
+
     struct CodeGenerator
     {
         CodeGenerator();
@@ -48,12 +73,40 @@ namespace rhea { namespace codegen {
         // Make our visitor a friend class, so it can access all the LLVM parts.
         friend CodeVisitor;
 
-        // At present, this returns a std::any (C++17( or boost::any (C++14).
-        // This may change in the future.
-        util::any generate(ast::ASTNode* tree);
+        // Returns the value of the last thing generated, if it has one.
+        // Without inference, only literals and operators on them know their
+        // types, so reading a variable needs the overload below.
+        llvm::Value* generate(ast::ASTNode* tree);
+
+        // The same, but using the types given by the inference engine (see
+        // `inference::TypeEngine::finalize()`). These have to cover the
+        // whole tree; a node without one is an error.
+        llvm::Value* generate(ast::ASTNode* tree, ast::NodeMap<types::TypeId> types);
+
+        // The optimization level and passes to use in `optimize`.
+        OptimizationOptions optimization;
+
+        // Whether top-level definitions can be seen from other modules. The
+        // REPL needs this, because each input gets a module of its own.
+        bool export_globals = false;
+
+        // Whether symbols use their stable hashes instead of their dense IDs
+        // from the program's symbol table. Code that will be linked with
+        // separately compiled modules needs this; anything else shouldn't.
+        bool hashed_symbols = false;
+
+        // The CPU and features to generate code for. Change this before
+        // generating any code, since the target machine is chosen then.
+        TargetSelection target;
 
-        // Run optimization passes over a section of IR code.
-        // TODO: Find some way to let callers determine which passes to use.
+        // Where our target machine comes from. A target machine can't be
+        // used by two threads at once, so generators running in parallel
+        // each need a cache of their own.
+        TargetMachineCache* target_machines = &TargetMachineCache::global();
+
+        // Run optimization passes over a section of IR code. This works on
+        // whole modules (the full per-module pipeline) or single functions
+        // (just the function simplification pipeline). Returns the same code.
         template <typename Code>
         Code* optimize(Code* code);
 
@@ -71,15 +124,47 @@ namespace rhea { namespace codegen {
         // Later on, we may need more than just one, but we can start small.
         std::unique_ptr<llvm::Module> module;
 
-        // The target machine
-        llvm::TargetMachine* target_machine;
+        // The target machine. This is owned by the shared target machine
+        // cache, and set up when we start generating a module.
+        llvm::TargetMachine* target_machine = nullptr;
 
         ////
         // Helper methods
         ////
 
         // Get the LLVM IR type for a Rhea type.
-        llvm::Type* llvm_for_type(types::TypeInfo ti);
+        llvm::Type* llvm_for_type(const types::TypeInfo& ti);
+
+        // The type of a node. When we were given types from inference, this
+        // is the inferred type, and a node that has none (or whose type is
+        // still unknown) throws. Trees built by hand have no inferred types
+        // at all, so the node is asked for its own type. That answer is
+        // remembered once it's known, but not while it's still unknown.
+        const types::TypeInfo& type_of(ast::ASTNode* node);
+
+        // Give a node a type by hand, for trees that haven't been through
+        // inference.
+        void set_type_of(ast::ASTNode* node, const types::TypeInfo& type);
+
+        // What kind of target machine we want, given our current options.
+        TargetSpec target_spec() const;
+
+        // Mark a function with our target CPU and features, so the optimizer
+        // (especially the vectorizer) can use them. Functions that already
+        // have their own settings are left alone.
+        void set_target_attributes(llvm::Function* fn);
+
+        // Start generating into a new, empty module, and hand back the old one.
+        // Everything else (symbols, types, the target) carries over.
+        std::unique_ptr<llvm::Module> start_module(std::string name);
+
+        // The linkage to give top-level definitions.
+        llvm::GlobalValue::LinkageTypes global_linkage() const;
+
+        // Find a global variable in the current module. If it was defined
+        // in an earlier module, it's declared here, so the linker (or JIT)
+        // can resolve it.
+        llvm::GlobalVariable* find_global(const std::string& name, const types::TypeInfo& type);
 
         // Push a new declaration and allocation scope.
         void create_scope(std::string name);
@@ -92,20 +177,28 @@ namespace rhea { namespace codegen {
         // Private LLVM members
         ////
 
-        // Set up our general optimization passes
-        void initialize_passes();
-
         // Do some module init stuff, like creating an initial function
         void initialize_module();
 
         // Close out the initial function
         void finalize_module();
 
-        // Manager for function-level optimization
-        llvm::FunctionPassManager FPM;
-        llvm::FunctionAnalysisManager FAM;
+        // Get the target machine, if we don't already have it.
+        llvm::TargetMachine* ensure_target_machine();
+
+        // The type of every node we know about, by node ID.
+        ast::NodeMap<types::TypeId> node_types;
+
+        // Whether `node_types` came from inference, and should be complete.
+        bool has_inferred_types = false;
     };
 
+    template <>
+    llvm::Module* CodeGenerator::optimize(llvm::Module* code);
+
+    template <>
+    llvm::Function* CodeGenerator::optimize(llvm::Function* code);
+
     // Helper class to map Rhea types to those used in LLVM IR.
     struct TypeBuilder
     {
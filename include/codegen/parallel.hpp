@@ -0,0 +1,80 @@
+#ifndef RHEA_CODEGEN_PARALLEL_HPP
+#define RHEA_CODEGEN_PARALLEL_HPP
+
+#include <string>
+#include <vector>
+
+#include "../ast.hpp"
+#include "../types/type_table.hpp"
+#include "generator.hpp"
+#include "target.hpp"
+
+/*
+ * Parallel code generation. A program is split into units that don't
+ * depend on each other's code, such as separate source files, and each one
+ * is compiled to an object file of its own on a pool of worker threads.
+ *
+ * LLVM contexts, modules, and builders can't be shared between threads, so
+ * every unit gets a code generator of its own, and with it all three. Each
+ * worker also has its own target machines, which aren't thread-safe either.
+ * The only shared state is in the type, symbol, and string tables, which
+ * are all locked.
+ *
+ * The output doesn't depend on the number of threads, or on which thread
+ * compiled which unit. Results come back in the order the units were given,
+ * module names come from the units, and symbols use their stable hashes
+ * rather than IDs handed out in whatever order the workers get to them.
+ */
+namespace rhea { namespace codegen {
+    // A piece of a program that can be compiled on its own.
+    struct CompilationUnit
+    {
+        // The name of the unit's module. This has to be unique, since the
+        // module's init function is named after it.
+        std::string name;
+
+        // The code for the unit, which it doesn't own. Units are compiled
+        // as they are, so the tree should already have been through the
+        // constant folder (before inference, since folding replaces nodes).
+        ast::ASTNode* tree = nullptr;
+
+        // The types of the unit's nodes, from the inference engine. Type
+        // inference isn't thread-safe, so this has to be done beforehand.
+        // Trees that haven't been through inference leave this empty.
+        ast::NodeMap<types::TypeId> types;
+    };
+
+    struct CompiledUnit
+    {
+        std::string name;
+
+        // The contents of the unit's object file.
+        std::string object;
+    };
+
+    struct ParallelOptions
+    {
+        // Number of worker threads. Zero means one per hardware thread.
+        unsigned threads = 0;
+
+        // Used for every unit, as in a single code generator.
+        OptimizationOptions optimization;
+        TargetSelection target;
+
+        // Units are usually linked together, so their definitions have to
+        // be visible to each other.
+        bool export_globals = true;
+    };
+
+    // Compile units in parallel, optimizing each one and emitting it as an
+    // object file. If any units fail, the exception from the first of them
+    // (in the order given, not the order they were compiled) is rethrown,
+    // once all the workers are done.
+    std::vector<CompiledUnit> compile_parallel(const std::vector<CompilationUnit>& units,
+        const ParallelOptions& options = {});
+
+    // Emit a module as an object file, using a given target machine.
+    std::string emit_object(llvm::Module* module, llvm::TargetMachine* tm);
+}}
+
+#endif /* RHEA_CODEGEN_PARALLEL_HPP */
@@ -0,0 +1,104 @@
+#ifndef RHEA_CODEGEN_TARGET_HPP
+#define RHEA_CODEGEN_TARGET_HPP
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include <llvm/ADT/Optional.h>
+#include <llvm/Support/CodeGen.h>
+#include <llvm/Target/TargetMachine.h>
+
+/*
+ * Target setup for code generation. LLVM's target registry only needs to be
+ * initialized once per process, and target machines are expensive to create
+ * but never change once they are, so we keep them all in one place, where
+ * every code generator can share them.
+ */
+namespace rhea { namespace codegen {
+    // Everything that goes into creating a target machine.
+    struct TargetSpec
+    {
+        std::string triple;
+        std::string cpu = "generic";
+        std::string features;
+        llvm::CodeGenOpt::Level opt_level = llvm::CodeGenOpt::Default;
+        llvm::Optional<llvm::Reloc::Model> reloc_model;
+
+        bool operator<(const TargetSpec& other) const
+        {
+            return key() < other.key();
+        }
+
+        private:
+        using key_type = std::tuple<const std::string&, const std::string&, const std::string&, int, int>;
+
+        key_type key() const
+        {
+            return key_type {
+                triple, cpu, features,
+                static_cast<int>(opt_level),
+                reloc_model.hasValue() ? static_cast<int>(reloc_model.getValue()) : -1
+            };
+        }
+    };
+
+    // What the user asked for, like a C compiler's `-march` and feature
+    // flags. Anything left empty gets a sensible default. There's no
+    // `-mtune`, since the LLVM versions we support ignore it.
+    struct TargetSelection
+    {
+        // The target triple. Empty means the machine we're running on. Only
+        // the host's architecture is built in, though the OS and
+        // environment can differ.
+        std::string triple;
+
+        // The CPU to generate code for (`-march`). "native" means the host
+        // CPU, with all its features; empty means a generic CPU.
+        std::string cpu;
+
+        // Extra features, in LLVM's format: "+avx2,-sse4a". These are applied
+        // after those of the CPU, so they can turn its features off, too.
+        std::string features;
+    };
+
+    // Work out the full spec for a selection, detecting the host CPU and its
+    // features if needed. Only the target machine parts are filled in.
+    TargetSpec resolve_target(const TargetSelection& selection);
+
+    // The features of the host CPU, as a feature string. These are sorted,
+    // so the same machine always gives the same string.
+    std::string host_cpu_features();
+
+    // Set up LLVM's native target, along with its assembly parser and
+    // printer. Only the first call does anything.
+    void initialize_native_target();
+
+    // The triple for the machine we're running on.
+    std::string host_triple();
+
+    class TargetMachineCache
+    {
+        public:
+        // The cache shared by all code generators.
+        static TargetMachineCache& global();
+
+        // Get the target machine for a spec, creating it if we haven't seen
+        // that spec before. The cache owns the machine, and it lives as long
+        // as the cache does. Throws if LLVM doesn't know the target, or if
+        // it's for an architecture other than the host's.
+        llvm::TargetMachine* get(const TargetSpec& spec);
+
+        // Number of target machines created so far.
+        std::size_t size() const;
+
+        private:
+        mutable std::mutex m_mutex;
+        std::map<TargetSpec, std::unique_ptr<llvm::TargetMachine>> m_machines;
+    };
+}}
+
+#endif /* RHEA_CODEGEN_TARGET_HPP */
@@ -7,10 +7,12 @@
 
 #include <llvm/IR/Value.h>
 #include <llvm/IR/Type.h>
+#include <llvm/IR/Instruction.h>
 
 #include "generator_fwd.hpp"
 #include "../ast.hpp"
 #include "../types/types.hpp"
+#include "../types/conversion.hpp"
 #include "../types/to_string.hpp"
 
 /*
@@ -38,13 +40,16 @@ namespace rhea { namespace codegen {
      * cases where we really are making an explicit conversion. This includes the coercion
      * operator `^` and the `as` casting operator.
      */
-    Value* convert_type(CodeGenerator* gen, Value* value, types::TypeInfo from, types::TypeInfo to, bool explicit_);
+    Value* convert_type(CodeGenerator* gen, Value* value, const types::TypeInfo& from, const types::TypeInfo& to, bool explicit_);
 
     /*
      * Private helper functions
      */
     namespace internal {
-        bool can_implicitly_convert(types::TypeInfo from, types::TypeInfo to);
+        bool can_implicitly_convert(const types::TypeInfo& from, const types::TypeInfo& to);
+
+        // The LLVM instruction for one of our casts.
+        llvm::Instruction::CastOps llvm_cast_op(types::CastOp op);
 
         // Template for type conversion helpers. These are intended to be called by
         // a variant visitor in `convert_type()` above. It may *look* like there will
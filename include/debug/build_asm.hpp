@@ -15,13 +15,38 @@
 
 #include "../ast.hpp"
 #include "../codegen/generator.hpp"
+#include "../fold/constant_fold.hpp"
+#include "../inference/engine.hpp"
+#include "../state/module_tree.hpp"
 #include "../util/compat.hpp"
 
 namespace rhea { namespace debug {
+    namespace internal {
+        struct ASMPrinter
+        {
+            ASMPrinter() : generator("debug")
+            {
+                engine.module_scopes["debug"] = std::make_unique<state::ModuleScopeTree>("debug");
+                engine.visitor.module_scope = engine.module_scopes["debug"].get();
+
+                // Each input gets its own module, but can use earlier ones.
+                generator.export_globals = true;
+            }
+
+            codegen::CodeGenerator generator;
+            fold::ConstantFolder folder;
+            inference::TypeEngine engine;
+            std::size_t inputs = 0;
+            ast::NodeId first_new_node = 0;
+        };
+    }
+
     void print_asm(ast::ASTNode* tree)
     {
-        // This is static so we can add to it with each successive calll.
-        static codegen::CodeGenerator generator("debug");
+        // This is static so we can add to it with each successive call. Each
+        // call gets a new module, so only the new code is printed.
+        static internal::ASMPrinter asmp {};
+        auto& generator = asmp.generator;
 
         auto root = dynamic_cast<ast::Program*>(tree);
 
@@ -34,7 +59,16 @@ namespace rhea { namespace debug {
         {
             node = root->children.front().get();
         }
-        auto result = generator.generate(node);
+
+        asmp.folder.fold(node);
+
+        // As with the IR printer, types are worked out before codegen.
+        node->visit(&asmp.engine.visitor);
+        auto types = asmp.engine.finalize(asmp.first_new_node);
+        asmp.first_new_node = ast::ASTNode::id_count();
+
+        generator.start_module("debug_" + std::to_string(++asmp.inputs));
+        auto result = generator.generate(node, std::move(types));
 
         llvm::SmallString<0> output;
         llvm::raw_svector_ostream ostr(output);
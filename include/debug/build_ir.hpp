@@ -15,14 +15,29 @@
 
 #include "../ast.hpp"
 #include "../codegen/generator.hpp"
+#include "../fold/constant_fold.hpp"
+#include "../inference/engine.hpp"
+#include "../state/module_tree.hpp"
 #include "../util/compat.hpp"
 
 namespace rhea { namespace debug {
     namespace internal {
         struct IRPrinter
         {
-            IRPrinter() : generator("debug") {}
+            IRPrinter() : generator("debug")
+            {
+                engine.module_scopes["debug"] = std::make_unique<state::ModuleScopeTree>("debug");
+                engine.visitor.module_scope = engine.module_scopes["debug"].get();
+
+                // Each input gets its own module, but can use earlier ones.
+                generator.export_globals = true;
+            }
+
             codegen::CodeGenerator generator;
+            fold::ConstantFolder folder;
+            inference::TypeEngine engine;
+            std::size_t inputs = 0;
+            ast::NodeId first_new_node = 0;
         };
     }
 
@@ -42,7 +57,16 @@ namespace rhea { namespace debug {
         {
             node = root->children.front().get();
         }
-        auto result = irp.generator.generate(node);
+
+        irp.folder.fold(node);
+
+        // Types are worked out once, up front, and codegen uses those.
+        node->visit(&irp.engine.visitor);
+        auto types = irp.engine.finalize(irp.first_new_node);
+        irp.first_new_node = ast::ASTNode::id_count();
+
+        irp.generator.start_module("debug_" + std::to_string(++irp.inputs));
+        auto result = irp.generator.generate(node, std::move(types));
         irp.generator.module->print(llvm::outs(), nullptr, false, true);
     }
 }}
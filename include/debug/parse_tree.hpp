@@ -14,6 +14,7 @@
 #include "../ast/selector.hpp"
 #include "../ast/nodes.hpp"
 #include "../ast/parse_tree_node.hpp"
+#include "../source/source_file.hpp"
 
 namespace rhea { namespace debug {
     namespace pt = tao::pegtl::parse_tree;
@@ -113,6 +114,43 @@ namespace rhea { namespace debug {
         return nullptr;
     }
 
+    // Load and parse a whole source file. On failure, this prints the reason
+    // and returns null; on success, the returned file owns the parse tree.
+    std::unique_ptr<source::SourceFile> parse_file(std::string filename)
+    {
+        std::unique_ptr<source::SourceFile> file;
+
+        try
+        {
+            file = std::make_unique<source::SourceFile>(filename);
+        }
+        catch (std::exception& error)
+        {
+            std::cerr << filename << ": " << error.what() << '\n';
+            return nullptr;
+        }
+
+        try
+        {
+            if (file->parse() == nullptr)
+            {
+                std::cerr << filename << ": Parse error\n";
+                return nullptr;
+            }
+        }
+        catch (tao::pegtl::parse_error& error)
+        {
+            const auto p = error.positions.front();
+            std::cerr
+                << error.what() << '\n'
+                << file->input().line_at(p) << '\n'
+                << std::string(p.byte_in_line, ' ') << "^\n";
+            return nullptr;
+        }
+
+        return file;
+    }
+
 }}
 
 #endif /* RHEA_DEBUG_PARSE_TREE_HPP */
\ No newline at end of file
@@ -0,0 +1,121 @@
+#ifndef RHEA_FOLD_CONSTANT_FOLD_HPP
+#define RHEA_FOLD_CONSTANT_FOLD_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ast.hpp"
+#include "types/types.hpp"
+#include "types/mapper.hpp"
+#include "util/compat.hpp"
+#include "util/interned_string.hpp"
+#include "util/scoped_table.hpp"
+#include "visitor/visitor.hpp"
+#include "visitor/default.hpp"
+
+/*
+ * Constant folding and propagation on the AST. This runs after the AST is
+ * built and before type inference, and it replaces any expression whose
+ * value is known at compile time with a literal of the right type. That
+ * covers arithmetic, comparisons, and logic on literals, casts of literals,
+ * ternaries with a literal condition, and identifiers bound by a `const`
+ * whose value folded to a literal.
+ *
+ * Folding has to give exactly the answer the generated code would, so it
+ * follows the same rules as codegen: integers wrap at their own width, the
+ * right-hand operand is implicitly converted to the type of the left, and
+ * conversions use the table in types/conversion.hpp. Anything that would
+ * be undefined at runtime (division by zero, oversized shifts, and so on)
+ * is left alone for codegen to deal with.
+ *
+ * The folder only descends into nodes whose scoping rules it knows, so it
+ * never mistakes a local variable for a constant of the same name.
+ */
+namespace rhea { namespace fold {
+    // A value known at compile time. Integers (and booleans) are kept
+    // sign- or zero-extended to 64 bits, based on their type, and floats
+    // are kept as doubles, already rounded to the precision of their type.
+    struct ConstantValue
+    {
+        types::BasicType type = types::BasicType::Unknown;
+        std::uint64_t integer = 0;
+        double floating = 0.0;
+    };
+
+    // The value of a literal node, if it is one.
+    util::optional<ConstantValue> constant_value(ast::Expression* e);
+
+    // A literal node holding a value.
+    ast::expression_ptr make_literal(const ConstantValue& v);
+
+    // Convert a value to another type, as an explicit conversion would.
+    // Returns nothing if the conversion isn't allowed, or the result would
+    // be undefined (e.g., a float that's out of range for an integer).
+    util::optional<ConstantValue> convert_constant(const ConstantValue& v, types::BasicType to);
+
+    /*
+     * The folding pass. Visiting an expression returns the literal to
+     * replace it with, or null if it can't be folded; its children are
+     * folded in place either way. Visiting a statement folds everything
+     * inside it. State is kept between calls to `fold`, so constants from
+     * one tree can be used in the next (as the REPL needs).
+     */
+    class ConstantFolder : public visitor::DefaultVisitor<ast::expression_ptr>
+    {
+        public:
+        ConstantFolder();
+
+        // Fold everything in a tree. The root itself can't be replaced,
+        // since nothing here owns it, so it should be a statement (or a
+        // program or module).
+        void fold(ast::ASTNode* tree);
+
+        // Fold an expression, replacing it if it has a constant value.
+        void fold(ast::expression_ptr& e);
+
+        // Number of expressions replaced so far.
+        std::size_t folded_count() const { return m_folded; }
+
+        using visitor::DefaultVisitor<ast::expression_ptr>::visit;
+
+        ast::expression_ptr visit(ast::Identifier* n) override;
+        ast::expression_ptr visit(ast::BinaryOp* n) override;
+        ast::expression_ptr visit(ast::UnaryOp* n) override;
+        ast::expression_ptr visit(ast::TernaryOp* n) override;
+        ast::expression_ptr visit(ast::Cast* n) override;
+
+        ast::expression_ptr visit(ast::Program* n) override;
+        ast::expression_ptr visit(ast::Module* n) override;
+        ast::expression_ptr visit(ast::Block* n) override;
+        ast::expression_ptr visit(ast::BareExpression* n) override;
+        ast::expression_ptr visit(ast::Assign* n) override;
+        ast::expression_ptr visit(ast::CompoundAssign* n) override;
+        ast::expression_ptr visit(ast::TypeDeclaration* n) override;
+        ast::expression_ptr visit(ast::Variable* n) override;
+        ast::expression_ptr visit(ast::Constant* n) override;
+        ast::expression_ptr visit(ast::If* n) override;
+        ast::expression_ptr visit(ast::While* n) override;
+        ast::expression_ptr visit(ast::For* n) override;
+        ast::expression_ptr visit(ast::Match* n) override;
+        ast::expression_ptr visit(ast::On* n) override;
+        ast::expression_ptr visit(ast::Default* n) override;
+        ast::expression_ptr visit(ast::Def* n) override;
+        ast::expression_ptr visit(ast::Return* n) override;
+
+        private:
+        // A replacement literal, at the same place in the source.
+        ast::expression_ptr replace(ast::Expression* old, const ConstantValue& v);
+
+        // Names in scope, with their values if they're constants. Anything
+        // else that's declared is bound to nothing, so it hides any outer
+        // constant with the same name.
+        util::ScopedTable<util::InternedString, util::optional<ConstantValue>> m_constants;
+
+        // For looking up the targets of casts. Only builtin types matter.
+        types::TypeMapper m_types;
+
+        std::size_t m_folded = 0;
+    };
+}}
+
+#endif /* RHEA_FOLD_CONSTANT_FOLD_HPP */
@@ -56,6 +56,17 @@ namespace rhea { namespace grammar {
         >,
         ignored
     > {};
+
+    // A whole source file is either a module or a program. Unlike the
+    // rules above, this one must consume all of its input; anything left
+    // over at the end is an error rather than something to silently skip.
+    struct translation_unit : seq <
+        sor <
+            module_definition,
+            program_definition
+        >,
+        must <eof>
+    > {};
 }}
 
 #endif /* RHEA_GRAMMAR_MODULE_HPP */
\ No newline at end of file
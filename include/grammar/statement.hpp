@@ -190,7 +190,7 @@ namespace rhea { namespace grammar {
     struct on_case : seq <
         kw_on,
         separator,
-        constant_expression,
+        list <constant_expression, one <','>, ignored>,
         pad <one <':'>, ignored>,
         stmt_or_block
     > {};
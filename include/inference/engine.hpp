@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "ast.hpp"
+#include "ast/node_map.hpp"
 #include "state/module_tree.hpp"
 #include "state/module_node.hpp"
 #include "types/types.hpp"
@@ -27,15 +28,70 @@
 namespace rhea { namespace inference {
     using namespace rhea::types;
 
+    // Counts of how often inferred types were reused rather than recomputed.
+    struct CacheStats
+    {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t invalidations = 0;
+    };
+
     struct TypeEngine
     {
         TypeEngine();
 
         /*
-         * The core of the inference engine is a map connecting AST node
-         * pointers to the types that have been inferred.
+         * The core of the inference engine is a map connecting AST nodes
+         * to the types that have been inferred. It's indexed by node ID,
+         * so the lookups done for every node don't have to hash anything.
          */
-        std::unordered_map<ast::ASTNode*, InferredType> inferred_types;
+        ast::NodeMap<InferredType> inferred_types;
+
+        /*
+         * Record the inference for a node. If the node already had one, then
+         * anything that used it is invalidated, too.
+         */
+        void set_inferred_type(ast::ASTNode* node, InferredType type);
+
+        /*
+         * Get the inferred type for a node. Inference functions should use
+         * this for their child nodes, so that dependencies are recorded.
+         */
+        TypeInfo get_inferred_type(ast::ASTNode* node);
+
+        /*
+         * Throw away the cached type for a node and everything that depends
+         * on it, so they'll be recomputed the next time they're needed.
+         */
+        void invalidate(ast::ASTNode* node);
+
+        /*
+         * Look up a type by name in the mapper. Inference functions should
+         * use this rather than going to the mapper themselves, so that the
+         * lookup is recorded like any other dependency.
+         */
+        TypeInfo get_named_type(util::InternedString name);
+
+        /*
+         * Define or remove a named type, invalidating every inferred type
+         * that looked up that name. Like the mapper's own methods, adding
+         * doesn't replace an existing definition.
+         */
+        bool add_type_definition(util::InternedString name, TypeInfo type);
+        util::optional<TypeInfo> remove_type_definition(util::InternedString name);
+
+        /*
+         * Work out every type the engine knows about, and hand back the
+         * results as interned type IDs, indexed by node. This is the end of
+         * inference: code generation takes this map and never has to work
+         * out a type for itself.
+         *
+         * Giving a starting node ID only finalizes nodes created since then,
+         * which is what incremental compilation (e.g., the REPL) wants.
+         */
+        ast::NodeMap<TypeId> finalize(ast::NodeId first = 0);
+
+        CacheStats cache_stats;
 
         /*
          * We also hold a type mapper, which connects string representations
@@ -53,7 +109,7 @@ namespace rhea { namespace inference {
          * We hold a map of function call nodes and their scopes so that we can
          * do overload resolution later in the compilation.
          */
-        std::unordered_map<ast::ASTNode*, state::ModuleScopeNode*> call_nodes;
+        ast::NodeMap<state::ModuleScopeNode*> call_nodes;
 
         /*
          * As this is an AST traversal, we use a visitor utilizing the
@@ -61,6 +117,16 @@ namespace rhea { namespace inference {
          */
         InferenceVisitor visitor;
         friend InferenceVisitor;
+        friend InferredType;
+
+        private:
+        // The nodes whose types are being computed right now, innermost last.
+        std::vector<ast::ASTNode*> m_evaluating;
+
+        // Nodes whose inferred types used a named type, by name.
+        std::unordered_map<util::InternedString, std::vector<ast::ASTNode*>> m_named_type_users;
+
+        void invalidate_named_type(util::InternedString name);
     };
 }}
 
@@ -18,6 +18,12 @@
  * to function pointer. So we'll make an object that holds a lambda
  * without captures, as well as pointers to the type engine and the
  * node we're evaluating.
+ *
+ * Inference functions can be expensive, and they ask for the types of
+ * their children, which ask for theirs, and so on. So each one remembers
+ * its result the first time it's called. It also remembers which other
+ * nodes have used that result, so the engine can throw away those (and
+ * only those) when something changes. See `TypeEngine::invalidate`.
  */
 namespace rhea { namespace inference {
     using namespace rhea::ast;
@@ -29,10 +35,24 @@ namespace rhea { namespace inference {
 
         function_type function = [](TypeEngine*, ASTNode*){ return types::UnknownType(); };
 
-        TypeEngine* engine;
-        ASTNode* node;
+        TypeEngine* engine = nullptr;
+        ASTNode* node = nullptr;
 
-        types::TypeInfo operator()() { return function(engine, node); }
+        // Evaluate the function, or return the cached result if we already
+        // have one. This is defined in engine.cpp.
+        types::TypeInfo operator()();
+
+        // Forget the cached result, if any.
+        void reset() { cached = false; value = types::TypeInfo {}; }
+
+        // Memoization state. `evaluating` catches cycles (a type that depends
+        // on itself), which come out as unknown until we know more.
+        types::TypeInfo value;
+        bool cached = false;
+        bool evaluating = false;
+
+        // Nodes whose inferred types used this one.
+        std::vector<ASTNode*> dependents;
     };
 }}
 
@@ -21,9 +21,8 @@
  */
 namespace rhea { namespace inference {
     using namespace rhea::ast;
-    using util::any;
 
-    struct InferenceVisitor : visitor::DefaultVisitor
+    struct InferenceVisitor : visitor::DefaultVisitor<void>
     {
         InferenceVisitor(TypeEngine* e) : engine(e) {}
 
@@ -35,52 +34,55 @@ namespace rhea { namespace inference {
         state::ModuleScopeTree* module_scope;
 
         // We'll eventually override pretty much all the node-specific methods.
-        any visit(Boolean* n) override;
-        any visit(Integer* n) override;
-        any visit(Byte* n) override;
-        any visit(Long* n) override;
-        any visit(UnsignedInteger* n) override;
-        any visit(UnsignedByte* n) override;
-        any visit(UnsignedLong* n) override;
-        any visit(Float* n) override;
-        any visit(Double* n) override;
-        any visit(Symbol* n) override;
-        any visit(Nothing* n) override;
+        void visit(Boolean* n) override;
+        void visit(Integer* n) override;
+        void visit(Byte* n) override;
+        void visit(Long* n) override;
+        void visit(UnsignedInteger* n) override;
+        void visit(UnsignedByte* n) override;
+        void visit(UnsignedLong* n) override;
+        void visit(Float* n) override;
+        void visit(Double* n) override;
+        void visit(Symbol* n) override;
+        void visit(Nothing* n) override;
 
-        any visit(BinaryOp* n) override;
-        any visit(UnaryOp* n) override;
-        any visit(TernaryOp* n) override;
+        void visit(Identifier* n) override;
 
-        any visit(Typename*) override;
-        any visit(Variant*) override;
-        any visit(Optional*) override;
-        any visit(Cast*) override;
-        any visit(TypeCheck*) override;
-        any visit(Alias*) override;
-        any visit(Enum*) override;
-        any visit(SymbolList*) override;
+        void visit(BinaryOp* n) override;
+        void visit(UnaryOp* n) override;
+        void visit(TernaryOp* n) override;
+
+        void visit(Typename*) override;
+        void visit(Variant*) override;
+        void visit(Optional*) override;
+        void visit(Cast*) override;
+        void visit(TypeCheck*) override;
+        void visit(Alias*) override;
+        void visit(Enum*) override;
+        void visit(SymbolList*) override;
         
-        any visit(If* n) override;
-        any visit(BareExpression* n) override;
-        any visit(Block* n) override;
-        any visit(While*) override;
-        any visit(For*) override;
-        any visit(With*) override;
-        any visit(Break*) override;
-        any visit(Continue*) override;
-        any visit(Match*) override;
-        any visit(On*) override;
-        any visit(When*) override;
-        any visit(TypeCase*) override;
-        any visit(Default*) override;
-        any visit(PredicateCall*) override;
-        any visit(TypeDeclaration* n) override;
-        any visit(Variable* n) override;
-        any visit(Constant* n) override;
+        void visit(If* n) override;
+        void visit(BareExpression* n) override;
+        void visit(Block* n) override;
+        void visit(While*) override;
+        void visit(For*) override;
+        void visit(With*) override;
+        void visit(Break*) override;
+        void visit(Continue*) override;
+        void visit(Match*) override;
+        void visit(On*) override;
+        void visit(When*) override;
+        void visit(TypeCase*) override;
+        void visit(Default*) override;
+        void visit(PredicateCall*) override;
+        void visit(TypeDeclaration* n) override;
+        void visit(Variable* n) override;
+        void visit(Constant* n) override;
 
-        any visit(Def* n) override;
-        any visit(Arguments* n) override;
-        any visit(TypePair* n) override;
+        void visit(Def* n) override;
+        void visit(Call* n) override;
+        void visit(Arguments* n) override;
+        void visit(TypePair* n) override;
     };
 }}
 
@@ -0,0 +1,79 @@
+#ifndef RHEA_JIT_ENGINE_HPP
+#define RHEA_JIT_ENGINE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/Module.h>
+
+#include "../codegen/generator_fwd.hpp"
+
+/*
+ * The JIT engine runs Rhea code in the compiler's own process, using LLVM's
+ * ORC LLJIT. That lets us run scripts without a separate link step, and it
+ * gives us a way to benchmark generated code directly.
+ *
+ * Code generators own their LLVM context, but the JIT needs modules in a
+ * context it can own (and lock), so modules are copied in as bitcode. The
+ * generator keeps its module, and can go on adding to it.
+ *
+ * By default, compilation is lazy: a function is only compiled the first time
+ * it's called, so big programs can start quickly. Eager mode compiles each
+ * module as soon as something in it is looked up.
+ */
+namespace rhea { namespace jit {
+    struct EngineOptions
+    {
+        // Compile functions when they're first called, not all at once.
+        bool lazy = true;
+
+        // Let JIT code call functions from the host process (e.g., libc).
+        bool link_host_process = true;
+    };
+
+    class Engine
+    {
+        public:
+        Engine() : Engine(EngineOptions {}) {}
+        Engine(EngineOptions options);
+
+        Engine(const Engine&) = delete;
+        Engine& operator=(const Engine&) = delete;
+
+        // Add a copy of a module to the JIT.
+        void add_module(const llvm::Module& module);
+
+        // Add a copy of a code generator's current module.
+        void add(codegen::CodeGenerator& generator);
+
+        // Get the address of a symbol. Throws if it can't be found.
+        std::uint64_t lookup(const std::string& name);
+
+        // Does the JIT have this symbol?
+        bool has_symbol(const std::string& name);
+
+        // Get a symbol as a function pointer.
+        template <typename F>
+        F* function(const std::string& name)
+        {
+            return reinterpret_cast<F*>(static_cast<std::uintptr_t>(lookup(name)));
+        }
+
+        // Run a module's initializer (`<module>_init`), then `main` if there
+        // is one. Rhea's `main` takes no arguments and returns nothing, so the
+        // result is always 0 for now.
+        int run(const std::string& module_name);
+
+        // The underlying JIT, for anything not covered above.
+        llvm::orc::LLJIT& llvm_jit() { return *m_jit; }
+
+        private:
+        EngineOptions m_options;
+        std::unique_ptr<llvm::orc::LLJIT> m_jit;
+    };
+}}
+
+#endif /* RHEA_JIT_ENGINE_HPP */
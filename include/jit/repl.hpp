@@ -0,0 +1,56 @@
+#ifndef RHEA_JIT_REPL_HPP
+#define RHEA_JIT_REPL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../ast.hpp"
+#include "../codegen/generator.hpp"
+#include "../fold/constant_fold.hpp"
+#include "../inference/engine.hpp"
+#include "engine.hpp"
+
+/*
+ * An incremental session for the REPL. Each input is compiled into a small
+ * module of its own and added to a JIT that lives as long as the session, so
+ * only the new code is ever compiled. Definitions from earlier inputs stay
+ * available: the code generator and the type engine keep their symbol tables
+ * from one input to the next, and the JIT links each new module against the
+ * ones before it.
+ */
+namespace rhea { namespace jit {
+    class Session
+    {
+        public:
+        Session() : Session("repl") {}
+        Session(std::string name, EngineOptions options = {});
+
+        // Compile and run one input. The session keeps the tree, since later
+        // inputs may refer to it. Returns the name of the input's module.
+        std::string evaluate(std::unique_ptr<ast::ASTNode> input);
+
+        // Number of inputs evaluated so far.
+        std::size_t size() const { return m_inputs.size(); }
+
+        codegen::CodeGenerator& generator() { return m_generator; }
+        inference::TypeEngine& types() { return m_types; }
+        Engine& engine() { return m_engine; }
+
+        private:
+        std::string m_name;
+
+        fold::ConstantFolder m_folder;
+        inference::TypeEngine m_types;
+        codegen::CodeGenerator m_generator;
+        Engine m_engine;
+
+        std::vector<std::unique_ptr<ast::ASTNode>> m_inputs;
+
+        // Nodes before this one belong to earlier inputs.
+        ast::NodeId m_first_new_node = 0;
+    };
+}}
+
+#endif /* RHEA_JIT_REPL_HPP */
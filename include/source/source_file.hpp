@@ -0,0 +1,88 @@
+#ifndef RHEA_SOURCE_SOURCE_FILE_HPP
+#define RHEA_SOURCE_SOURCE_FILE_HPP
+
+#include <string>
+#include <memory>
+#include <cstddef>
+
+#include <tao/pegtl.hpp>
+
+#include "../ast/arena.hpp"
+#include "../ast/nodes/node_base.hpp"
+#include "../ast/parse_tree_node.hpp"
+#include "source_manager.hpp"
+
+/*
+ * Loading of Rhea source files. Rather than reading a file line by line
+ * and handing each line to the parser separately, we map the whole thing
+ * into memory and parse it as a single module or program. PEGTL's parse
+ * tree nodes hold pointers into their input, so the mapped file has to
+ * stay alive for as long as anything might look at the tree; a SourceFile
+ * owns both, and is meant to last for the whole compilation.
+ *
+ * The same goes for the file's AST. Its nodes are allocated from an arena
+ * that belongs to the file (see ast/arena.hpp), so the file owns the tree
+ * as well, and hands out plain pointers to it. The file's text is
+ * registered with the global SourceManager once, when it's opened, and
+ * removed when the file is destroyed, along with the tree.
+ */
+namespace rhea { namespace source {
+    // The input type used for whole files. The file is mapped read-only,
+    // so there's no copying, no matter how large it is.
+    using file_input = tao::pegtl::mmap_input<>;
+
+    class SourceFile
+    {
+        public:
+        // Map the named file into memory. Throws an exception if the file
+        // can't be opened or mapped.
+        SourceFile(std::string filename);
+
+        SourceFile(const SourceFile&) = delete;
+        SourceFile& operator=(const SourceFile&) = delete;
+
+        // Parse the whole file as a module or program definition. A syntax
+        // error throws tao::pegtl::parse_error. The tree is cached, so
+        // parsing more than once returns the same root.
+        ast::parser_node* parse();
+
+        // Build the AST for the whole file. This uses the single-pass
+        // builder (see ast/direct_builder.hpp) when it can, and otherwise
+        // parses the file first. A syntax error throws parse_error either
+        // way. The tree is cached, and the file owns it.
+        ast::ASTNode* ast();
+
+        // The arena holding the file's AST nodes.
+        const ast::Arena& arena() const { return m_arena; }
+
+        // The file name, exactly as it was given to the constructor.
+        const std::string& name() const { return m_name; }
+
+        // The raw contents of the file.
+        const char* begin() const { return m_input.begin(); }
+        const char* end() const { return m_input.end(); }
+        std::size_t size() const { return end() - begin(); }
+
+        // Access to the underlying input, mainly for error reporting
+        // (e.g., `input().line_at(position)`).
+        file_input& input() { return m_input; }
+
+        // The file's entry in the global SourceManager.
+        FileId file_id() const { return m_buffer.file(); }
+
+        private:
+        std::string m_name;
+        file_input m_input;
+        ScopedBuffer m_buffer;
+
+        // Everything below is destroyed before this, and the AST is
+        // destroyed first of all, before the memory under it goes away.
+        ast::Arena m_arena;
+
+        // Declared after the input so that it's destroyed first.
+        std::unique_ptr<ast::parser_node> m_tree;
+        std::unique_ptr<ast::ASTNode> m_ast;
+    };
+}}
+
+#endif /* RHEA_SOURCE_SOURCE_FILE_HPP */
@@ -0,0 +1,179 @@
+#ifndef RHEA_SOURCE_SOURCE_MANAGER_HPP
+#define RHEA_SOURCE_SOURCE_MANAGER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Source locations and the table of files they refer to.
+ *
+ * AST nodes used to carry a full PEGTL position, which includes a copy of
+ * the source name, so every node paid for a string allocation. Now, each
+ * node gets a SourceLocation, which is a single 32-bit number. Every source
+ * buffer we build an AST from is registered with the SourceManager, which
+ * gives it a contiguous range of those numbers, one for each byte plus one
+ * for the end of the buffer. Any location can then be turned back into a
+ * file and a byte offset.
+ *
+ * Whoever owns the text registers it, not the AST builders, so building a
+ * tree more than once from the same buffer doesn't add another entry. For
+ * short-lived text, like a line typed into a REPL, ScopedBuffer removes the
+ * entry again, and the locations it used are handed out to the next buffer.
+ *
+ * Line and column numbers aren't stored at all. When a file is registered,
+ * we record where each of its lines starts, and only work out the line and
+ * column of a location when something (usually an error message) asks.
+ */
+namespace rhea { namespace source {
+    // Index into the file table. 0 is never a valid file.
+    using FileId = std::uint32_t;
+
+    class SourceLocation
+    {
+        public:
+        SourceLocation() = default;
+        explicit SourceLocation(std::uint32_t raw) : m_raw(raw) {}
+
+        // Locations made by default, or for an unregistered buffer, don't
+        // refer to anything.
+        bool valid() const { return m_raw != 0; }
+        std::uint32_t raw() const { return m_raw; }
+
+        bool operator==(const SourceLocation& other) const { return m_raw == other.m_raw; }
+        bool operator!=(const SourceLocation& other) const { return m_raw != other.m_raw; }
+
+        private:
+        std::uint32_t m_raw = 0;
+    };
+
+    // A location decoded into human-friendly terms. Lines and columns are
+    // counted from 1, byte offsets from 0.
+    struct PresumedLocation
+    {
+        std::string name;
+        std::size_t line;
+        std::size_t column;
+        std::size_t offset;
+    };
+
+    class SourceManager
+    {
+        public:
+        SourceManager() = default;
+
+        SourceManager(const SourceManager&) = delete;
+        SourceManager& operator=(const SourceManager&) = delete;
+
+        // The table used by the AST builders and error messages.
+        static SourceManager& global();
+
+        // Register a buffer of source text under the given name. Only the
+        // line structure is recorded, so the buffer doesn't have to outlive
+        // the manager. Registering the same buffer again gives it a new ID,
+        // which is what later lookups by address will find.
+        FileId add_buffer(std::string name, const char* data, std::size_t size);
+
+        // Register the whole buffer behind a PEGTL memory input (including
+        // string_input and mmap_input), even if some of it has already been
+        // consumed.
+        template <typename Input>
+        FileId add_input(const Input& in)
+        {
+            auto consumed = in.iterator().byte;
+            return add_buffer(in.source(), in.current() - consumed, consumed + in.size());
+        }
+
+        // Remove a buffer, once nothing will ask about its locations any
+        // more. If it's the most recent one, its locations are reused by the
+        // next registration; otherwise only its name and line table go.
+        void remove_buffer(FileId file);
+
+        // Location of a byte in a registered file.
+        SourceLocation location(FileId file, std::size_t offset) const;
+
+        // Location of a byte in the most recently registered file that
+        // starts at `buffer`. If no such file exists, the location is
+        // invalid.
+        SourceLocation location(const char* buffer, std::size_t offset) const;
+
+        // Pieces of a location. These all expect a valid location. The name
+        // is a copy, since the table can move while the caller holds it.
+        FileId file(SourceLocation loc) const;
+        std::size_t offset(SourceLocation loc) const;
+        std::string name(SourceLocation loc) const;
+        std::size_t line(SourceLocation loc) const;
+        std::size_t column(SourceLocation loc) const;
+
+        PresumedLocation presumed(SourceLocation loc) const;
+
+        // Number of registered files, not counting removed ones.
+        std::size_t size() const;
+
+        private:
+        struct file_entry
+        {
+            std::string name;
+            const char* buffer;
+            std::uint32_t base;
+            std::uint32_t size;
+
+            // Offset of the first byte of each line after the first.
+            std::vector<std::uint32_t> line_starts;
+
+            bool removed = false;
+        };
+
+        const file_entry& entry(SourceLocation loc) const;
+        std::size_t line_index(const file_entry& f, std::size_t offset) const;
+
+        mutable std::mutex m_mutex;
+        std::vector<file_entry> m_files;
+        std::unordered_map<const char*, FileId> m_buffers;
+
+        // 0 is reserved for invalid locations.
+        std::uint32_t m_next_base = 1;
+        std::size_t m_removed = 0;
+
+        // Bumped on each registration, so lookup caches know to reset.
+        std::atomic<std::uint64_t> m_generation { 0 };
+    };
+
+    // Keeps a buffer registered for as long as it's in scope. The buffer's
+    // AST has to be gone, or at least never asked for a location again,
+    // before this is destroyed.
+    class ScopedBuffer
+    {
+        public:
+        ScopedBuffer(std::string name, const char* data, std::size_t size,
+            SourceManager& manager = SourceManager::global())
+            : m_manager(manager), m_file(manager.add_buffer(std::move(name), data, size))
+        {}
+
+        template <typename Input>
+        explicit ScopedBuffer(const Input& in, SourceManager& manager = SourceManager::global())
+            : m_manager(manager), m_file(manager.add_input(in))
+        {}
+
+        ScopedBuffer(const ScopedBuffer&) = delete;
+        ScopedBuffer& operator=(const ScopedBuffer&) = delete;
+
+        ~ScopedBuffer() { m_manager.remove_buffer(m_file); }
+
+        FileId file() const { return m_file; }
+
+        private:
+        SourceManager& m_manager;
+        FileId m_file;
+    };
+
+    // Prints `name:line:column`, using the global source manager.
+    std::ostream& operator<<(std::ostream& os, const SourceLocation& loc);
+}}
+
+#endif /* RHEA_SOURCE_SOURCE_MANAGER_HPP */
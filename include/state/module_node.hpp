@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "../ast/nodes/node_base.hpp"
+#include "../util/interned_string.hpp"
 
 /*
  * Nodes for the module symbol table/scope tree.
@@ -14,23 +15,23 @@
 namespace rhea { namespace state {
     struct ModuleScopeNode
     {
-        ModuleScopeNode(std::string n, ModuleScopeNode* p);
+        ModuleScopeNode(util::InternedString n, ModuleScopeNode* p);
         
         ModuleScopeNode();
         ModuleScopeNode(ModuleScopeNode* p);
-        ModuleScopeNode(std::string n);
+        ModuleScopeNode(util::InternedString n);
 
         // Find an AST node in this scope or its ancestors. Some parts of the compiler
         // may need to do this with only a pointer to a scope, so we add a method here.
-        ast::ASTNode* find_symbol(std::string sym);
+        ast::ASTNode* find_symbol(util::InternedString sym);
         
         // The name of this scope. Most scopes will be unnamed, but something such as
         // a function definition will have its name here.
-        std::string name;
+        util::InternedString name;
 
         // The symbol table for this scope, linking identifier names defined in the
         // scope with the AST nodes that define them.
-        std::unordered_map<std::string, ast::ASTNode*> symbol_table;
+        std::unordered_map<util::InternedString, ast::ASTNode*> symbol_table;
 
         // Non-owning pointer to this scope node's parent.
         ModuleScopeNode* parent;
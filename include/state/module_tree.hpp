@@ -8,6 +8,8 @@
 #include "../ast/nodes/node_base.hpp"
 
 #include "module_node.hpp"
+#include "../util/interned_string.hpp"
+#include "../util/scoped_table.hpp"
 
 /*
  * The module scope tree contains symbol tables for each scope, nested in a tree
@@ -20,19 +22,19 @@ namespace rhea { namespace state {
         ModuleScopeTree();
 
         // Create a new scope as a child of the current one.
-        void begin_scope(std::string name);
+        void begin_scope(util::InternedString name);
 
         // End the current scope and return to its parent.
         void end_scope();
 
         // Find a symbol in the current scope or its ancestors. Returns a null pointer
         // if the symbol cannot be found.
-        ast::ASTNode* find_symbol(std::string sym);
+        ast::ASTNode* find_symbol(util::InternedString sym);
 
         // Add a symbol to the current scope. Throws an exception if trying to add
         // to a null pointer. (This can happen with unbalanced begin/end calls,
         // which are an error, but it's better to play it safe.)
-        void add_symbol(std::string sym, ast::ASTNode* node);
+        void add_symbol(util::InternedString sym, ast::ASTNode* node);
 
         // The fully-qualified name of this module, or an empty string if it
         // represents a program instead.
@@ -49,6 +51,11 @@ namespace rhea { namespace state {
 
         // State variable linking to the current scope.
         ModuleScopeNode* current_scope;
+
+        private:
+        // Everything visible from the current scope, so lookups don't have
+        // to walk up the tree. The tree itself is kept for later passes.
+        util::ScopedTable<util::InternedString, ast::ASTNode*> m_visible;
     };
 }}
 
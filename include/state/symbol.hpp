@@ -12,6 +12,8 @@
 #include "../types/declaration.hpp"
 #include "../types/types.hpp"
 #include "../util/compat.hpp"
+#include "../util/interned_string.hpp"
+#include "../util/scoped_table.hpp"
 
 /*
  * The definition for an entry in the compiler's symbol tables.
@@ -22,33 +24,33 @@ namespace rhea { namespace state {
     // a particular declaration.
     struct SymbolEntry
     {
-        std::string name;
+        util::InternedString name;
         types::DeclarationType declaration;
         types::TypeInfo type_data;
         // more to add...
     };
 
-    // A symbol table is just a hashtable of strings and symbol entries.
+    // A symbol table is a scoped hashtable of names and symbol entries.
     // The keys are the "in-scope" names of the symbols, while the
-    // entries themselves will hold "canonical" names.
-    using SymbolTable = std::unordered_map<std::string, SymbolEntry>;
+    // entries themselves will hold "canonical" names. Names are interned,
+    // so hashing and comparing keys doesn't touch the strings at all.
+    using SymbolTable = util::ScopedTable<util::InternedString, SymbolEntry>;
 
     // This is a helper declaration for the result of a search through
     // the scope list. It's an optional pair of a symbol entry and the
-    // string name of the scope in which it was found.
+    // name of the scope in which it was found.
     using SymbolSearchResult = util::optional<
         std::pair<
             std::reference_wrapper<SymbolEntry>,
-            std::string
+            util::InternedString
         >
     >;
 
-    // A scope holds a symbol table and any extra information needed
-    // for type-checking and codegen.
+    // A scope holds any extra information needed for type-checking and
+    // codegen. Its symbols live in the manager's table, not here.
     struct Scope
     {
-        std::string name;
-        SymbolTable symbol_table;
+        util::InternedString name;
         // more to add...
     };
 
@@ -58,37 +60,48 @@ namespace rhea { namespace state {
     // the non-codegen aspects of symbols and scopes.
     struct ScopeManager
     {
-        ScopeManager() : m_stack({ {"$global", {}} }) {}
+        ScopeManager() : m_stack({ {"$global"} }) {}
 
         // Return the topmost (i.e., current) scope.
         Scope& current() { return m_stack.back(); }
 
         // Add a new scope to the stack. Note that this doesn't do any
-        // copying of values; the searcher will look in parent scopes.
-        void push() { m_stack.push_back({}); }
-        void push(std::string name) { m_stack.push_back({name, {}}); }
+        // copying of values; outer names stay visible until shadowed.
+        void push() { push({}); }
+        void push(util::InternedString name)
+        {
+            m_stack.push_back({name});
+            m_table.push();
+        }
 
         // Delete the current scope. This is done at the end of a scoping
         // block to prevent contamination of unrelated blocks.
-        void pop() { m_stack.pop_back(); }
+        void pop()
+        {
+            m_table.pop();
+            m_stack.pop_back();
+        }
 
         // Add a new entry to the current scope.
         void add_symbol(SymbolEntry sym);
 
         // Check to see if a symbol is defined in the current scope.
-        bool is_local(std::string s);
+        bool is_local(util::InternedString s);
 
         // Find an entry in the symbol table. If it isn't in the most
         // local scope, then keep trying parent scopes.
-        SymbolSearchResult find(std::string key);
+        SymbolSearchResult find(util::InternedString key);
 
         private:
         // We use a vector rather than a stack here, even though we call
         // it a stack. That's because the standard libaray's stack is
         // an adapter over vector (usually) which only allows access to
-        // the topmost item. We need to be able to iterate through the
-        // stack to find outer entries, so that won't work here.
+        // the topmost item. Search results need the name of the scope
+        // where a symbol was found, which we index by the table's depth.
         std::vector<Scope> m_stack;
+
+        // All the symbols from every open scope.
+        SymbolTable m_table;
     };
 }}
 
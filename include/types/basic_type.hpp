@@ -0,0 +1,34 @@
+#ifndef RHEA_TYPES_BASIC_TYPE_HPP
+#define RHEA_TYPES_BASIC_TYPE_HPP
+
+/*
+ * The basic (builtin) types. These live in their own header so that the
+ * conversion table can use them without needing the rest of the type system.
+ */
+namespace rhea { namespace types {
+    // This enum holds all the basic literal types Rhea understands.
+    enum class BasicType
+    {
+        Integer,
+        Byte,
+        Float,
+        Double,
+        Long,
+        UnsignedInteger,
+        UnsignedByte,
+        UnsignedLong,
+
+        Boolean,
+        String,
+        Symbol,
+        Any,
+        Nothing,
+        
+        Other,          // Used for structures, user-defined types, generics, etc.
+        
+        Promoted,       // Used for the coercion opertor `^`
+        Unknown = -1    // Error case
+    };
+}}
+
+#endif /* RHEA_TYPES_BASIC_TYPE_HPP */
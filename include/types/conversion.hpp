@@ -0,0 +1,231 @@
+#ifndef RHEA_TYPES_CONVERSION_HPP
+#define RHEA_TYPES_CONVERSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "basic_type.hpp"
+
+/*
+ * Conversion rules between the basic types. Every question of the form "can
+ * a value of type A be used where type B is expected, and what does it take
+ * to get there?" is answered here, by a single lookup in a table that's
+ * built at compile time. That way, type inference, overload resolution, and
+ * code generation can't disagree about what's allowed.
+ *
+ * The rules themselves are simple. Rhea only allows implicit conversions that
+ * widen a value without changing its signedness, like byte -> integer or
+ * float -> double. Any numeric type (including booleans) can be converted to
+ * any other explicitly, using `as` or the coercion operator `^`. Everything
+ * else (strings, symbols, etc.) can only "convert" to itself.
+ *
+ * The coercion operator gives its operand the special `Promoted` type, which
+ * is allowed anywhere. The conversion that actually happens is the explicit
+ * one from the operand's real type, so code generation looks that up instead.
+ */
+namespace rhea { namespace types {
+    // How a value gets from one type to another, from best to worst.
+    enum class Conversion : std::uint8_t
+    {
+        Identity,       // Same type, nothing to do
+        Implicit,       // Widening conversion, allowed anywhere
+        Coerced,        // From the coercion operator; uses the explicit rule
+        Explicit,       // Only with `as` or `^`
+        None            // Not allowed at all
+    };
+
+    // The instruction needed to perform a conversion. These map directly onto
+    // LLVM's cast instructions, except for the conversions to boolean, which
+    // compare against zero instead.
+    enum class CastOp : std::uint8_t
+    {
+        None,           // No code needed (e.g., integer <-> unsigned integer)
+        Trunc,
+        ZExt,
+        SExt,
+        FPTrunc,
+        FPExt,
+        FPToUI,
+        FPToSI,
+        UIToFP,
+        SIToFP,
+        IntToBool,      // icmp ne 0
+        FPToBool        // fcmp une 0.0
+    };
+
+    struct ConversionRule
+    {
+        Conversion kind = Conversion::None;
+        CastOp op = CastOp::None;
+    };
+
+    namespace internal {
+        // Number of rows and columns in the table. `Unknown` isn't in it,
+        // and never converts to or from anything.
+        constexpr std::size_t basic_type_count = static_cast<std::size_t>(BasicType::Promoted) + 1;
+
+        // What we need to know about a numeric type to work out conversions.
+        struct numeric_info
+        {
+            bool numeric;
+            bool floating;
+            bool is_signed;
+            unsigned bits;
+        };
+
+        constexpr numeric_info numeric_info_for(BasicType t)
+        {
+            switch (t)
+            {
+                case BasicType::Byte:               return { true, false, true, 8 };
+                case BasicType::Integer:            return { true, false, true, 32 };
+                case BasicType::Long:               return { true, false, true, 64 };
+                case BasicType::UnsignedByte:       return { true, false, false, 8 };
+                case BasicType::UnsignedInteger:    return { true, false, false, 32 };
+                case BasicType::UnsignedLong:       return { true, false, false, 64 };
+                case BasicType::Float:              return { true, true, true, 32 };
+                case BasicType::Double:             return { true, true, true, 64 };
+                case BasicType::Boolean:            return { true, false, false, 1 };
+                default:                            return { false, false, false, 0 };
+            }
+        }
+
+        // The rule for a single pair of types. This is only ever called while
+        // building the table, so it can be as slow and clear as it likes.
+        constexpr ConversionRule derive_rule(BasicType from, BasicType to)
+        {
+            if (from == to)
+            {
+                return { Conversion::Identity, CastOp::None };
+            }
+
+            if (from == BasicType::Promoted)
+            {
+                return { Conversion::Coerced, CastOp::None };
+            }
+
+            auto f = numeric_info_for(from);
+            auto t = numeric_info_for(to);
+
+            if (!f.numeric || !t.numeric)
+            {
+                return { Conversion::None, CastOp::None };
+            }
+
+            // Widening within the same family and signedness is implicit.
+            // Booleans are left out, since `true + 1` shouldn't be legal.
+            auto widening = from != BasicType::Boolean && to != BasicType::Boolean &&
+                f.floating == t.floating && f.is_signed == t.is_signed && f.bits < t.bits;
+            auto kind = widening ? Conversion::Implicit : Conversion::Explicit;
+
+            if (to == BasicType::Boolean)
+            {
+                return { kind, f.floating ? CastOp::FPToBool : CastOp::IntToBool };
+            }
+
+            if (f.floating && t.floating)
+            {
+                return { kind, f.bits < t.bits ? CastOp::FPExt : CastOp::FPTrunc };
+            }
+
+            if (f.floating)
+            {
+                return { kind, t.is_signed ? CastOp::FPToSI : CastOp::FPToUI };
+            }
+
+            if (t.floating)
+            {
+                return { kind, f.is_signed ? CastOp::SIToFP : CastOp::UIToFP };
+            }
+
+            // Integer to integer
+            if (f.bits == t.bits)
+            {
+                return { kind, CastOp::None };
+            }
+            else if (f.bits > t.bits)
+            {
+                return { kind, CastOp::Trunc };
+            }
+            else
+            {
+                return { kind, f.is_signed ? CastOp::SExt : CastOp::ZExt };
+            }
+        }
+
+        struct ConversionMatrix
+        {
+            constexpr ConversionMatrix() : rules{}
+            {
+                for (std::size_t f = 0; f < basic_type_count; ++f)
+                {
+                    for (std::size_t t = 0; t < basic_type_count; ++t)
+                    {
+                        rules[f][t] = derive_rule(static_cast<BasicType>(f), static_cast<BasicType>(t));
+                    }
+                }
+            }
+
+            ConversionRule rules[basic_type_count][basic_type_count];
+        };
+
+        constexpr ConversionMatrix conversion_matrix {};
+    }
+
+    // Numeric types are the ones arithmetic works on. Booleans convert like
+    // numbers, but they aren't numbers.
+    constexpr bool is_numeric_type(BasicType t)
+    {
+        return t != BasicType::Boolean && internal::numeric_info_for(t).numeric;
+    }
+
+    constexpr bool is_integral_type(BasicType t)
+    {
+        return is_numeric_type(t) && !internal::numeric_info_for(t).floating;
+    }
+
+    // The rule for converting a value of type `from` to type `to`.
+    constexpr ConversionRule conversion_rule(BasicType from, BasicType to)
+    {
+        return (static_cast<std::size_t>(from) < internal::basic_type_count &&
+            static_cast<std::size_t>(to) < internal::basic_type_count)
+            ? internal::conversion_matrix.rules[static_cast<std::size_t>(from)][static_cast<std::size_t>(to)]
+            : ConversionRule {};
+    }
+
+    // Can `from` be used where `to` is expected, without a cast?
+    constexpr bool is_implicitly_convertible(BasicType from, BasicType to)
+    {
+        return conversion_rule(from, to).kind <= Conversion::Coerced;
+    }
+
+    // Can `from` be converted to `to` at all?
+    constexpr bool is_explicitly_convertible(BasicType from, BasicType to)
+    {
+        return conversion_rule(from, to).kind != Conversion::None;
+    }
+
+    // How good a match `from` is for `to`, for overload resolution. Lower is
+    // better, and an exact match is 0.
+    constexpr unsigned conversion_rank(BasicType from, BasicType to)
+    {
+        return static_cast<unsigned>(conversion_rule(from, to).kind);
+    }
+
+    // Sanity checks on the table, so a change to `BasicType` can't silently
+    // break the rules.
+    static_assert(conversion_rule(BasicType::Byte, BasicType::Integer).kind == Conversion::Implicit,
+        "byte -> integer should be implicit");
+    static_assert(conversion_rule(BasicType::Integer, BasicType::Byte).op == CastOp::Trunc,
+        "integer -> byte should truncate");
+    static_assert(conversion_rule(BasicType::Float, BasicType::Double).op == CastOp::FPExt,
+        "float -> double should extend");
+    static_assert(!is_implicitly_convertible(BasicType::Integer, BasicType::Double),
+        "integer -> double must be explicit");
+    static_assert(!is_explicitly_convertible(BasicType::String, BasicType::Integer),
+        "strings aren't numbers");
+    static_assert(!is_explicitly_convertible(BasicType::Unknown, BasicType::Unknown),
+        "unknown types never convert");
+}}
+
+#endif /* RHEA_TYPES_CONVERSION_HPP */
@@ -1,12 +1,13 @@
 #ifndef RHEA_TYPES_MAPPER_HPP
 #define RHEA_TYPES_MAPPER_HPP
 
-#include <map>
+#include <unordered_map>
 #include <string>
 #include <memory>
 
 #include "types.hpp"
 #include "../util/compat.hpp"
+#include "../util/interned_string.hpp"
 
 namespace rhea { namespace types {
     /*
@@ -19,21 +20,24 @@ namespace rhea { namespace types {
         // Get the typeinfo object for a given typename string. If one hasn't been
         // declared, we return an unknown type rather than throwing an exception,
         // because this is technically a problem in the Rhea code, not the compiler.
-        TypeInfo get_type_for(std::string s)
-            { return is_type_defined(s) ? type_map[s] : TypeInfo(UnknownType()); }
+        TypeInfo get_type_for(util::InternedString s)
+        {
+            auto it = type_map.find(s);
+            return it != type_map.end() ? it->second : TypeInfo(UnknownType());
+        }
 
         // Add a new type to the map of known types. This returns true if the
         // insertion succeeded.
-        bool add_type_definition(std::string s, TypeInfo ti);
+        bool add_type_definition(util::InternedString s, TypeInfo ti);
 
         // Remove the definition of the type with the given name.
-        util::optional<TypeInfo> remove_type_definition(std::string s);
+        util::optional<TypeInfo> remove_type_definition(util::InternedString s);
 
         // Does the given typename have a known mapping?
         // (We use the map::count method rather than find to avoid iterator stuff.)
-        bool is_type_defined(std::string s) { return type_map.count(s) > 0; }
+        bool is_type_defined(util::InternedString s) { return type_map.count(s) > 0; }
 
-        std::map<std::string, TypeInfo> type_map;
+        std::unordered_map<util::InternedString, TypeInfo> type_map;
 
         private:
         void insert_builtin_types();
@@ -11,6 +11,7 @@
 #include "../util/compat.hpp"
 
 #include "types.hpp"
+#include "type_table.hpp"
 #include "to_string.hpp"
 
 namespace rhea { namespace types {
@@ -33,20 +34,21 @@ namespace rhea { namespace types {
 
     namespace internal {
         template <typename T>
-        std::string mangle_argument_name(T& argument_type)
+        std::string mangle_argument_name(const T& argument_type)
         { throw rhea::ast::unimplemented_type(to_string(argument_type)); }
 
         // Overloads for mangling different types. These aren't specializations,
         // because they sometimes have to recurse, and that takes more template
-        // trickery than I feel like doing.
+        // trickery than I feel like doing. Compound types recurse through the
+        // type table, which caches the mangled form of each type.
 
-        inline std::string mangle_argument_name(NothingType& argument_type)
+        inline std::string mangle_argument_name(const NothingType& argument_type)
         { return "v"; }
 
-        inline std::string mangle_argument_name(AnyType& argument_type)
+        inline std::string mangle_argument_name(const AnyType& argument_type)
         { return "a"; }
 
-        inline std::string mangle_argument_name(SimpleType& argument_type)
+        inline std::string mangle_argument_name(const SimpleType& argument_type)
         {
             switch (argument_type.type)
             {
@@ -77,23 +79,17 @@ namespace rhea { namespace types {
             }
         }
 
-        inline std::string mangle_argument_name(OptionalType& argument_type)
+        inline std::string mangle_argument_name(const OptionalType& argument_type)
         {
-            return "Op"s + util::visit(
-                [&] (auto& e) { return mangle_argument_name(e); },
-                argument_type.contained_type->type()
-            );
+            return "Op"s + TypeTable::global().mangled(argument_type.contained_type);
         }
 
-        inline std::string mangle_argument_name(VariantType& argument_type)
+        inline std::string mangle_argument_name(const VariantType& argument_type)
         {
             auto result = "V"s + std::to_string(argument_type.types.size());
-            for (auto&& t : argument_type.types)
+            for (auto t : argument_type.types)
             {
-                result += util::visit(
-                    [&] (auto& e) { return mangle_argument_name(e); },
-                    t->type()
-                );
+                result += TypeTable::global().mangled(t);
             }
             return result;
         }
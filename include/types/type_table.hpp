@@ -0,0 +1,89 @@
+#ifndef RHEA_TYPES_TYPE_TABLE_HPP
+#define RHEA_TYPES_TYPE_TABLE_HPP
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "types.hpp"
+
+/*
+ * The global type table. Each structurally distinct type is stored here
+ * exactly once (hash-consing), and everything else refers to it by its
+ * TypeId. Because compound types hold the IDs of their parts, which have
+ * already been interned, two types are the same exactly when their IDs
+ * are, and interning a type only has to look at its top level.
+ *
+ * The table also remembers things that are expensive to work out but
+ * never change for a given type: its printable name, its mangled form,
+ * and whether it's compatible with other types.
+ */
+namespace rhea { namespace types {
+    class TypeTable
+    {
+        public:
+        TypeTable();
+
+        TypeTable(const TypeTable&) = delete;
+        TypeTable& operator=(const TypeTable&) = delete;
+
+        // The table used by `intern_type` and friends.
+        static TypeTable& global();
+
+        // Get the ID for a type, adding it to the table if it's new.
+        TypeId intern(const TypeInfo& t);
+
+        // The type for an ID. References stay valid for the life of the table.
+        const TypeInfo& get(TypeId id) const;
+
+        // Cached queries.
+        bool compatible(TypeId lhs, TypeId rhs);
+        const std::string& name(TypeId id);
+        const std::string& mangled(TypeId id);
+
+        // Number of distinct types, including the unknown type.
+        std::size_t size() const;
+
+        private:
+        // A type's structure, with its parts already reduced to IDs.
+        struct key
+        {
+            std::size_t kind;
+            std::vector<std::uint64_t> parts;
+            std::vector<std::string> names;
+
+            bool operator==(const key& other) const
+            {
+                return kind == other.kind && parts == other.parts && names == other.names;
+            }
+        };
+
+        struct key_hash
+        {
+            std::size_t operator()(const key& k) const;
+        };
+
+        struct entry
+        {
+            TypeInfo type;
+
+            bool has_name = false;
+            std::string name;
+
+            bool has_mangled = false;
+            std::string mangled;
+        };
+
+        static key key_of(const TypeInfo& t);
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<key, TypeId, key_hash> m_ids;
+        std::deque<entry> m_entries;
+        std::unordered_map<std::uint64_t, bool> m_compatible;
+    };
+}}
+
+#endif /* RHEA_TYPES_TYPE_TABLE_HPP */
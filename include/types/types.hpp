@@ -1,6 +1,7 @@
 #ifndef RHEA_TYPES_INFO_HPP
 #define RHEA_TYPES_INFO_HPP
 
+#include <cstdint>
 #include <map>
 #include <vector>
 #include <string>
@@ -9,70 +10,61 @@
 
 #include "../util/compat.hpp"
 
+#include "basic_type.hpp"
+#include "conversion.hpp"
+
 /*
  * Type objects for Rhea data types. These use static polymorphism (variants),
  * rather than virtual functions.
  */
 namespace rhea { namespace types {
-    // This enum holds all the basic literal types Rhea understands.
-    enum class BasicType
-    {
-        Integer,
-        Byte,
-        Float,
-        Double,
-        Long,
-        UnsignedInteger,
-        UnsignedByte,
-        UnsignedLong,
-
-        Boolean,
-        String,
-        Symbol,
-        Any,
-        Nothing,
-        
-        Other,          // Used for structures, user-defined types, generics, etc.
-        
-        Promoted,       // Used for the coercion opertor `^`
-        Unknown = -1    // Error case
-    };
+    // Every structurally distinct type is interned in a global table (see
+    // type_table.hpp), and identified by its index there. Compound types
+    // refer to their parts by ID, so copying or comparing one never has to
+    // walk a tree of pointers. ID 0 is always the unknown type.
+    using TypeId = std::uint32_t;
 
     // Forward definition for our main type info container class
     struct TypeInfo;
-    bool compatible(TypeInfo& lhs, TypeInfo& rhs);
-    bool operator==(TypeInfo lhs, TypeInfo rhs);
+    bool compatible(const TypeInfo& lhs, const TypeInfo& rhs);
+    bool operator==(const TypeInfo& lhs, const TypeInfo& rhs);
+    bool operator!=(const TypeInfo& lhs, const TypeInfo& rhs);
+
+    // Getting from an ID to the type it stands for, and back. These are
+    // defined along with the type table.
+    TypeId intern_type(const TypeInfo& t);
+    const TypeInfo& type_for_id(TypeId id);
 
     // An unknown type, which can go anywhere, but can't be compared. It's
     // basically a NULL type.
     struct UnknownType
     {
         template <typename T>
-        bool is_compatible(T& other) { return false; }
+        bool is_compatible(const T& other) const { return false; }
 
-        bool operator==(UnknownType other) { return true; }
+        bool operator==(const UnknownType& other) const { return true; }
 
         template <typename T>
-        bool operator==(T other) { return false; }
+        bool operator==(const T& other) const { return false; }
     };
 
     // Simple types are those of literals, such as integers, doubles, strings, etc.
     struct SimpleType
     {
-        SimpleType(BasicType t) : type(t) {}
+        SimpleType(BasicType t) : type(t), is_numeric(is_numeric_type(t)), is_integral(is_integral_type(t)) {}
         SimpleType(BasicType t, bool n): type(t), is_numeric(n), is_integral(false) {}
         SimpleType(BasicType t, bool n, bool i) : type(t), is_numeric(n), is_integral(i) {}
         BasicType type;
-        bool is_numeric;
-        bool is_integral;
+        bool is_numeric = false;
+        bool is_integral = false;
 
         template <typename T>
-        bool is_compatible(T& other) { return false; }
+        bool is_compatible(const T& other) const { return false; }
 
-        bool operator==(SimpleType other) { return type == other.type; }
+        bool operator==(const SimpleType& other) const { return type == other.type; }
 
         template <typename T>
-        bool operator==(T other) { return false; }
+        bool operator==(const T& other) const { return false; }
     };
 
     // The nothing type is special, because it can't be converted to/from, but it can
@@ -80,12 +72,12 @@ namespace rhea { namespace types {
     struct NothingType
     {
         template <typename T>
-        bool is_compatible(T& other) { return false; }
+        bool is_compatible(const T& other) const { return false; }
 
-        bool operator==(NothingType other) { return true; }
+        bool operator==(const NothingType& other) const { return true; }
 
         template <typename T>
-        bool operator==(T other) { return false; }
+        bool operator==(const T& other) const { return false; }
     };
 
     // Function types need a map of strings to argument types, plus a return type.
@@ -93,65 +85,66 @@ namespace rhea { namespace types {
     // because we also have to preserve the *order* of arguments.
     struct FunctionType
     {
-        // We have to use pointers here because of the circular dependency. Using shared
-        // instead of unique pointers lets us avoid a lot of messy move stuff that would
-        // require some serious rewriting throughout the compiler. (I know it's a little
-        // slower, and it's poor form, but we all have to make sacrifices.)
-
-        using argument_type_pair = std::pair<std::string, std::shared_ptr<TypeInfo>>;
+        // The parts of a function type are stored as IDs, which breaks the
+        // circular dependency without needing pointers. A return type of 0
+        // (unknown) means the function didn't give one.
+        using argument_type_pair = std::pair<std::string, TypeId>;
         std::vector<argument_type_pair> argument_types;
-        std::shared_ptr<TypeInfo> return_type;
+        TypeId return_type = 0;
 
         template <typename T>
-        bool is_compatible(T& other) { return false; }
+        bool is_compatible(const T& other) const { return false; }
 
-        bool operator==(FunctionType other);
+        bool operator==(const FunctionType& other) const
+        {
+            return return_type == other.return_type && argument_types == other.argument_types;
+        }
 
         template <typename T>
-        bool operator==(T other) { return false; }
+        bool operator==(const T& other) const { return false; }
     };
 
     // An optional type just needs the contained type.
     struct OptionalType
     {
-        std::shared_ptr<TypeInfo> contained_type;
+        TypeId contained_type = 0;
 
         template <typename T>
-        bool is_compatible(T& other);
+        bool is_compatible(const T& other) const;
 
-        bool operator==(OptionalType other);
+        bool operator==(const OptionalType& other) const { return contained_type == other.contained_type; }
 
         template <typename T>
-        bool operator==(T other) { return false; }
+        bool operator==(const T& other) const { return false; }
     };
 
     // A variant needs multiple types.
     struct VariantType
     {
-        std::vector<std::shared_ptr<TypeInfo>> types;
+        std::vector<TypeId> types;
 
         template <typename T>
-        bool is_compatible(T& other) { return false; }
+        bool is_compatible(const T& other) const { return false; }
 
-        bool operator==(VariantType other) { return types == other.types; }
+        bool operator==(const VariantType& other) const { return types == other.types; }
 
         template <typename T>
-        bool operator==(T other) { return false; }
+        bool operator==(const T& other) const { return false; }
     };
 
     // A structure keeps a map of strings to field types.
     struct StructureType
     {
-        using field_type_pair = std::pair<std::string, std::shared_ptr<TypeInfo>>;
+        using field_type_pair = std::pair<std::string, TypeId>;
         std::vector<field_type_pair> fields;
 
         template <typename T>
-        bool is_compatible(T& other) { return false; }
+        bool is_compatible(const T& other) const { return false; }
         
-        bool operator==(StructureType other) { return fields == other.fields; }
+        bool operator==(const StructureType& other) const { return fields == other.fields; }
 
         template <typename T>
-        bool operator==(T other) { return false; }
+        bool operator==(const T& other) const { return false; }
     };
 
     // The "any" type can hold anything, but what it actually holds is an implemenation detail.
@@ -159,12 +152,12 @@ namespace rhea { namespace types {
     {
         // Any is technically compatible with any other type, but only if it's the LHS.
         template <typename T>
-        bool is_compatible(T& other) { return true; }
+        bool is_compatible(const T& other) const { return true; }
 
-        bool operator==(AnyType other) { return true; }
+        bool operator==(const AnyType& other) const { return true; }
 
         template <typename T>
-        bool operator==(T other) { return false; }
+        bool operator==(const T& other) const { return false; }
     };
 
     // The "base" for all types. This is a variant covering all defined structs.
@@ -189,6 +182,10 @@ namespace rhea { namespace types {
         TypeInfo(T t) : type_info_v(t) {}
 
         TypeInfoVariant& type() { return type_info_v; }
+        const TypeInfoVariant& type() const { return type_info_v; }
+
+        // The interned ID for this type.
+        TypeId id() const { return intern_type(*this); }
 
         private:
         TypeInfoVariant type_info_v;
@@ -198,24 +195,24 @@ namespace rhea { namespace types {
     // Specializations for type classes
     ////
 
-    // Scalar types are only compatible with themselves. (We can do things like promotion
-    // elsewhere in the compiler.)
+    // Scalar types are compatible with anything that converts to them implicitly,
+    // according to the conversion table.
     template <>
-    inline bool SimpleType::is_compatible(SimpleType& other)
+    inline bool SimpleType::is_compatible(const SimpleType& other) const
     {
-        return type == other.type;
+        return is_implicitly_convertible(other.type, type);
     }
 
     // The nothing type is only compatible with itself.
     template <>
-    inline bool NothingType::is_compatible(NothingType& other)
+    inline bool NothingType::is_compatible(const NothingType& other) const
     {
         return true;
     }
 
     // Function types are compatible if their signatures are.
     template <>
-    inline bool FunctionType::is_compatible(FunctionType& other)
+    inline bool FunctionType::is_compatible(const FunctionType& other) const
     {
          return (argument_types == other.argument_types && return_type == other.return_type);
     }
@@ -223,46 +220,40 @@ namespace rhea { namespace types {
     // Optionals types are compatible with other optionals holding the same type
     // *or* that type.
     template <typename T>
-    inline bool OptionalType::is_compatible(T& other)
+    inline bool OptionalType::is_compatible(const T& other) const
     {
+        const TypeInfo& contained = type_for_id(contained_type);
         return util::visit(
             [&](auto& ct) { return other.is_compatible(ct); },
-            contained_type->type()
+            contained.type()
         );
     }
 
     template <>
-    inline bool OptionalType::is_compatible(OptionalType& other)
+    inline bool OptionalType::is_compatible(const OptionalType& other) const
     {
-        return *contained_type == *(other.contained_type);
+        return contained_type == other.contained_type;
     }
 
     // Structures are compatible with structures that have the exact same layout.
     template <>
-    inline bool StructureType::is_compatible(StructureType& other)
+    inline bool StructureType::is_compatible(const StructureType& other) const
     {
          return fields == other.fields;
     }
 
-    inline bool FunctionType::operator==(FunctionType other)
-    {
-        return argument_types == other.argument_types && *return_type == *(other.return_type);
-    }
-
-    inline bool OptionalType::operator==(OptionalType other)
-    {
-        return *contained_type == *(other.contained_type);
-    }
-        
-    // Comparison function. This *only* checks for exact matches at this time.
-    inline bool compatible(TypeInfo& lhs, TypeInfo& rhs)
+    // Comparison function. This checks whether a value of type `rhs` can be used
+    // where `lhs` is expected. For simple types, that's anything the conversion
+    // table allows implicitly; everything else needs an exact match.
+    inline bool compatible(const TypeInfo& lhs, const TypeInfo& rhs)
     {
         auto fn = [&](auto& l, auto& r) { return l.is_compatible(r); };
         return util::visit(fn, lhs.type(), rhs.type());
     }
 
-    // The comparison operator delegates to the variants.
-    inline bool operator==(TypeInfo lhs, TypeInfo rhs)
+    // The comparison operator delegates to the variants. Since the parts of
+    // compound types are IDs, this never has to recurse.
+    inline bool operator==(const TypeInfo& lhs, const TypeInfo& rhs)
     {
         return lhs.type().index() == rhs.type().index() &&
             util::visit([](auto& l, auto& r) {
@@ -270,6 +261,11 @@ namespace rhea { namespace types {
             }, lhs.type(), rhs.type());
     }
 
+    inline bool operator!=(const TypeInfo& lhs, const TypeInfo& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
 }}
 
 #endif /* RHEA_TYPES_INFO_HPP */
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef RHEA_UTIL_INTERNED_STRING_HPP
+#define RHEA_UTIL_INTERNED_STRING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+/*
+ * Process-wide string interning. Names show up everywhere in the compiler:
+ * identifiers, module names, symbol table keys, typenames. Most of them are
+ * the same few strings over and over, and every table lookup used to hash
+ * and compare the whole thing (after copying it, more often than not).
+ *
+ * An InternedString is a 32-bit handle into a global table that holds a
+ * single copy of each distinct string. Two handles are equal exactly when
+ * their strings are, so comparison and hashing are O(1). The text itself
+ * never moves or goes away, so references from `str()` stay valid for the
+ * life of the process.
+ *
+ * Note that `operator<` orders by handle, not alphabetically. It's only
+ * meant for ordered containers; use `str()` if you need a real sort.
+ */
+namespace rhea { namespace util {
+    class InternedString
+    {
+        public:
+        // The empty string, which is always handle 0.
+        InternedString() = default;
+
+        // These are implicit on purpose, so that a plain string can be used
+        // wherever a name is expected.
+        InternedString(const std::string& s);
+        InternedString(const char* s);
+
+        // The interned text.
+        const std::string& str() const;
+
+        std::uint32_t id() const { return m_id; }
+        bool empty() const { return m_id == 0; }
+
+        bool operator==(const InternedString& other) const { return m_id == other.m_id; }
+        bool operator!=(const InternedString& other) const { return m_id != other.m_id; }
+        bool operator<(const InternedString& other) const { return m_id < other.m_id; }
+
+        private:
+        std::uint32_t m_id = 0;
+    };
+
+    // Number of distinct strings interned so far, including the empty one.
+    std::size_t interned_count();
+
+    inline std::ostream& operator<<(std::ostream& os, const InternedString& s)
+        { return os << s.str(); }
+}}
+
+namespace std {
+    template <>
+    struct hash<rhea::util::InternedString>
+    {
+        std::size_t operator()(const rhea::util::InternedString& s) const noexcept
+            { return s.id(); }
+    };
+}
+
+#endif /* RHEA_UTIL_INTERNED_STRING_HPP */
@@ -0,0 +1,137 @@
+#ifndef RHEA_UTIL_SCOPED_TABLE_HPP
+#define RHEA_UTIL_SCOPED_TABLE_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*
+ * A scoped hash table, the classic symbol table structure for block-scoped
+ * languages. Rather than one hash table per scope (which means searching
+ * every scope on a miss, and copying a whole table to check just one),
+ * there's a single table mapping each name to a stack of its bindings,
+ * innermost last. An undo log remembers which names each scope bound, so
+ * closing a scope only touches those.
+ *
+ * Looking up a name, checking if it's bound in the current scope, opening a
+ * scope, and binding a name are all O(1) (amortized). Closing a scope costs
+ * the number of names bound in it.
+ *
+ * Pointers returned by `find` and `find_local` stay valid until that name is
+ * rebound in an inner scope, or its scope is closed.
+ */
+namespace rhea { namespace util {
+    template <typename Key, typename Value, typename Hash = std::hash<Key>>
+    class ScopedTable
+    {
+        public:
+        ScopedTable() { push(); }
+
+        // Open a new scope.
+        void push() { m_marks.push_back(m_undo.size()); }
+
+        // Close the current scope, forgetting everything bound in it.
+        void pop()
+        {
+            assert(!m_marks.empty());
+
+            auto mark = m_marks.back();
+            m_marks.pop_back();
+
+            while (m_undo.size() > mark)
+            {
+                auto it = m_bindings.find(m_undo.back());
+                assert(it != m_bindings.end());
+
+                it->second.pop_back();
+                if (it->second.empty())
+                {
+                    m_bindings.erase(it);
+                }
+
+                m_undo.pop_back();
+            }
+        }
+
+        // Number of open scopes. The outermost is 1.
+        std::size_t depth() const { return m_marks.size(); }
+
+        // Bind a name in the current scope. If it's already bound there,
+        // the old value is replaced.
+        Value& insert(const Key& key, Value value)
+        {
+            if (m_marks.empty())
+            {
+                push();
+            }
+
+            auto& stack = m_bindings[key];
+
+            if (!stack.empty() && stack.back().depth == depth())
+            {
+                stack.back().value = std::move(value);
+            }
+            else
+            {
+                stack.push_back(binding { std::move(value), depth() });
+                m_undo.push_back(key);
+            }
+
+            return stack.back().value;
+        }
+
+        // The innermost binding of a name, or null if it's not bound.
+        Value* find(const Key& key)
+        {
+            auto it = m_bindings.find(key);
+            return it == m_bindings.end() ? nullptr : &it->second.back().value;
+        }
+
+        const Value* find(const Key& key) const
+        {
+            auto it = m_bindings.find(key);
+            return it == m_bindings.end() ? nullptr : &it->second.back().value;
+        }
+
+        // The binding of a name in the current scope only, or null.
+        Value* find_local(const Key& key)
+        {
+            auto it = m_bindings.find(key);
+            return (it == m_bindings.end() || it->second.back().depth != depth())
+                ? nullptr
+                : &it->second.back().value;
+        }
+
+        bool is_local(const Key& key) const
+        {
+            auto it = m_bindings.find(key);
+            return it != m_bindings.end() && it->second.back().depth == depth();
+        }
+
+        // The depth of the scope holding the innermost binding of a name,
+        // or 0 if it isn't bound at all.
+        std::size_t depth_of(const Key& key) const
+        {
+            auto it = m_bindings.find(key);
+            return it == m_bindings.end() ? 0 : it->second.back().depth;
+        }
+
+        private:
+        struct binding
+        {
+            Value value;
+            std::size_t depth;
+        };
+
+        std::unordered_map<Key, std::vector<binding>, Hash> m_bindings;
+
+        // Every name bound, in order, and where each scope's names start.
+        std::vector<Key> m_undo;
+        std::vector<std::size_t> m_marks;
+    };
+}}
+
+#endif /* RHEA_UTIL_SCOPED_TABLE_HPP */
@@ -13,6 +13,9 @@
  * Here, we define a simple FNV hash for symbols that operates on their
  * names as strings. Nothing too out of the ordinary, and it might be better
  * to get a library instead.
+ *
+ * Inside a program, symbols use dense IDs from the symbol table (see
+ * symbol_table.hpp). The hash is their stable value across modules.
  */
 namespace rhea { namespace util {
     // Magic constants for the hash function (we use 64-bit here)
@@ -0,0 +1,93 @@
+#ifndef RHEA_UTIL_SYMBOL_TABLE_HPP
+#define RHEA_UTIL_SYMBOL_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "symbol_hash.hpp"
+
+/*
+ * The whole-program table of Rhea symbols (`@foo`). Each distinct symbol
+ * gets a small, dense ID the first time it's seen, and that's what code
+ * generation uses for its value. Dense values mean a `match` over symbols
+ * can use a jump table, and anything keyed by symbols can index an array
+ * instead of hashing.
+ *
+ * The FNV hash from symbol_hash.hpp is still the stable, ABI-visible value
+ * of a symbol, for code that has to agree with modules compiled separately.
+ * It's worked out once per symbol and kept here. Since every symbol in the
+ * program passes through this table, it's also where we catch two symbols
+ * that hash to the same value, which would otherwise be silently equal.
+ *
+ * Enums are lists of symbols. Registering one interns its members in order,
+ * so an enum whose members are new gets a contiguous block of IDs.
+ */
+namespace rhea { namespace util {
+    using SymbolId = std::uint32_t;
+
+    // Two different symbols have the same ABI hash.
+    struct symbol_collision : public std::runtime_error
+    {
+        symbol_collision(std::string msg) : std::runtime_error(msg) {}
+    };
+
+    class SymbolTable
+    {
+        public:
+        using hash_function = std::uint64_t (*)(std::string);
+
+        // The hash function can be replaced for testing.
+        SymbolTable(hash_function h = symbol_hash);
+
+        SymbolTable(const SymbolTable&) = delete;
+        SymbolTable& operator=(const SymbolTable&) = delete;
+
+        // The table used by the compiler.
+        static SymbolTable& global();
+
+        // Get the ID for a symbol, adding it if it's new. Throws
+        // `symbol_collision` if its hash is already taken.
+        SymbolId intern(const std::string& name);
+
+        // Intern the members of an enum, returning their IDs in order.
+        // Declaring the same enum twice is fine as long as the members
+        // haven't changed.
+        std::vector<SymbolId> intern_enum(const std::string& name, const std::vector<std::string>& members);
+
+        // The members of an enum, or null if there's no such enum.
+        const std::vector<SymbolId>* enum_members(const std::string& name) const;
+
+        // The name and ABI hash for an ID. References stay valid for the
+        // life of the table.
+        const std::string& name(SymbolId id) const;
+        std::uint64_t abi_hash(SymbolId id) const;
+
+        // Number of distinct symbols.
+        std::size_t size() const;
+
+        private:
+        struct entry
+        {
+            std::string name;
+            std::uint64_t hash;
+        };
+
+        SymbolId intern_locked(const std::string& name);
+
+        hash_function m_hash;
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, SymbolId> m_ids;
+        std::unordered_map<std::uint64_t, SymbolId> m_hashes;
+        std::deque<entry> m_entries;
+        std::unordered_map<std::string, std::vector<SymbolId>> m_enums;
+    };
+}}
+
+#endif /* RHEA_UTIL_SYMBOL_TABLE_HPP */
@@ -26,119 +26,39 @@ namespace rhea { namespace visitor {
          */
 
         // First, the declaration.
-        template <typename... T>
+        template <typename R, typename List>
         struct DefaultVisitor;
 
         // Then, the recursive specialization.
-        template <typename T0, typename... T>
-        struct DefaultVisitor<T0, T...> : DefaultVisitor<T...>
+        template <typename R, typename T0, typename... T>
+        struct DefaultVisitor<R, node_list<T0, T...>> : DefaultVisitor<R, node_list<T...>>
         {
-            using DefaultVisitor<T...>::visit;
-            any visit(T0*) override { return {}; }
+            using DefaultVisitor<R, node_list<T...>>::visit;
+            R visit(T0*) override { return R(); }
         };
 
         // Last, we have the base case.
-        template <typename T0>
-        struct DefaultVisitor<T0> : Visitor
+        template <typename R, typename T0>
+        struct DefaultVisitor<R, node_list<T0>> : Visitor<R>
         {
-            any visit(T0*) override { return {}; }
+            using Visitor<R>::visit;
+            R visit(T0*) override { return R(); }
         };
     }
 
     /*
-     * The default visitor does nothing for all node types. It can be used as
-     * a base for compiler passes that don't care about certain types, such as
-     * the declaration checker. (Or even codegen, as concepts, for instance,
-     * produce no code themselves.)
+     * The default visitor does nothing for all node types, returning a
+     * default-constructed result (or nothing at all, for `void`). It can be
+     * used as a base for compiler passes that don't care about certain types,
+     * such as the declaration checker. (Or even codegen, as concepts, for
+     * instance, produce no code themselves.)
      * 
      * The way it works is simple: derive from the internal implementation,
-     * templated on every AST class that can be visited. This is still tedious,
-     * but not as much as writing out (or copy-pasting) the same method 100 times.
+     * templated on every AST class that can be visited. That list lives in
+     * visitor.hpp, so we don't have to keep two copies of it in sync.
      */
-    struct DefaultVisitor : internal::DefaultVisitor<
-        ASTNode,
-        Expression,
-        Statement,
-        Boolean,
-        Integer,
-        Byte,
-        Long,
-        UnsignedInteger,
-        UnsignedByte,
-        UnsignedLong,
-        Float,
-        Double,
-        String,
-        Symbol,
-        Nothing,
-        Identifier,
-        FullyQualified,
-        RelativeIdentifier,
-
-        BinaryOp,
-        UnaryOp,
-        TernaryOp,
-        Member,
-        Subscript,
-
-        GenericTypename,
-        Typename,
-        Variant,
-        Optional,
-        Cast,
-        TypeCheck,
-        Alias,
-        SymbolList,
-        Enum,
-        TypePair,
-
-        BareExpression,
-        If,
-        While,
-        For,
-        With,
-        Break,
-        Continue,
-        Match,
-        On,
-        When,
-        TypeCase,
-        Default,
-        PredicateCall,
-        NamedArgument,
-        Call,
-        Arguments,
-        Condition,
-        Def,
-        GenericDef,
-        Return,
-        Extern,
-
-        Block,
-        Assign,
-        CompoundAssign,
-        TypeDeclaration,
-        Variable,
-        Constant,
-        Do,
-        
-        Array,
-        List,
-        Tuple,
-        DictionaryEntry,
-        Dictionary,
-        Structure,
-
-        Try,
-        Catch,
-        Throw,
-        Finally,
-
-        Program,
-        Module
-        /* All AST classes */
-    >
-    {};
+    template <typename R>
+    struct DefaultVisitor : internal::DefaultVisitor<R, visitable_nodes> {};
 }}
 
 #endif /* RHEA_VISITOR_DEFAULT_HPP */
\ No newline at end of file
@@ -1,109 +1,224 @@
 #ifndef RHEA_VISITOR_HPP
 #define RHEA_VISITOR_HPP
 
+#include <utility>
+
 #include "../util/compat.hpp"
 #include "../ast.hpp"
-#include "../visitor/visitor.hpp"
+#include "visitor_fwd.hpp"
 
 namespace rhea { namespace visitor {
     using util::any;
     using namespace ast;
-    
+
     /*
-     * The AST visitor, along with individual `visit` methods in each AST class,
+     * The AST visitor, along with individual `accept` methods in each AST class,
      * allows us to implement this pattern using double dispatch, decoupling the
      * visitor logic from both the AST itself and the compiler passes that use it.
-     * 
+     *
      * Basically, it works like this. The visitor has a `visit` method taking a
      * pointer to each different kind of AST node. These methods are virtual, and
      * any child class (a codegen visitor, for example) will override them to
      * implement custom logic. In the article where I learned this technique,
      * the author made the visitor subclasses friends of the implementation classes.
      * That's optional here, though. And it'll depend on what kind of state, etc.,
-     * we need. Also, we return an `any` value instead of void (and we do the same
-     * in the AST methods) to allow for a variety of situations. If this turns out
-     * to be too slow, I may switch back to the more traditional visitor pattern.
+     * we need.
+     *
+     * We used to return an `any` from every visit, which turned out to be too slow:
+     * boxing each `llvm::Value*` meant a heap allocation per node, and unboxing it
+     * meant an RTTI check. Now each visitor says what it returns, as the template
+     * argument of `Visitor<R>`, and the AST hands back exactly that type. (`void`
+     * is fine, too, for passes that only record things as they go.)
+     *
+     * Since a virtual method can't be a template, the AST side of the dispatch is
+     * split in two. Each node overrides `accept`, which calls the untyped `dispatch`
+     * method for its own class on a `VisitorBase`. `Visitor<R>` implements each of
+     * those by calling the matching `visit` and holding onto the result, which the
+     * (non-virtual) `ASTNode::visit` template then returns to the caller.
+     */
+
+    // Every AST class that has its own visit method, in one place.
+    template <typename... T>
+    struct node_list {};
+
+    using visitable_nodes = node_list<
+        ASTNode,
+        Expression,
+        Statement,
+        Boolean,
+        Integer,
+        Byte,
+        Long,
+        UnsignedInteger,
+        UnsignedByte,
+        UnsignedLong,
+        Float,
+        Double,
+        String,
+        Symbol,
+        Nothing,
+        Identifier,
+        FullyQualified,
+        RelativeIdentifier,
+
+        BinaryOp,
+        UnaryOp,
+        TernaryOp,
+        Member,
+        Subscript,
+
+        GenericTypename,
+        Typename,
+        Variant,
+        Optional,
+        Cast,
+        TypeCheck,
+        Alias,
+        SymbolList,
+        Enum,
+        TypePair,
+
+        BareExpression,
+        If,
+        While,
+        For,
+        With,
+        Break,
+        Continue,
+        Match,
+        On,
+        When,
+        TypeCase,
+        Default,
+        PredicateCall,
+        NamedArgument,
+        Call,
+        Arguments,
+        Condition,
+        Def,
+        GenericDef,
+        Return,
+        Extern,
+
+        Block,
+        Assign,
+        CompoundAssign,
+        TypeDeclaration,
+        Variable,
+        Constant,
+        Do,
+
+        Array,
+        List,
+        Tuple,
+        DictionaryEntry,
+        Dictionary,
+        Structure,
+
+        Try,
+        Catch,
+        Throw,
+        Finally,
+
+        Program,
+        Module
+    >;
+
+    namespace internal {
+        /*
+         * As with the default visitor (see default.hpp), there's no variadic
+         * using declaration in C++14, so each of these is built up one node
+         * type at a time.
+         */
+
+        // The untyped half: one `dispatch` per node type.
+        template <typename List>
+        struct DispatchBase;
+
+        template <typename T0, typename... T>
+        struct DispatchBase<node_list<T0, T...>> : DispatchBase<node_list<T...>>
+        {
+            using DispatchBase<node_list<T...>>::dispatch;
+            virtual void dispatch(T0*) = 0;
+        };
+
+        template <typename T0>
+        struct DispatchBase<node_list<T0>>
+        {
+            virtual ~DispatchBase() {}
+            virtual void dispatch(T0*) = 0;
+        };
+
+        // Somewhere to keep the result of the last `visit` until the node
+        // can return it. For `void` visitors, there's nothing to keep.
+        template <typename R>
+        struct ResultSlot
+        {
+            template <typename V, typename N>
+            void store(V* v, N* n) { m_result = v->visit(n); }
+
+            R take() { return std::move(m_result); }
+
+            R m_result {};
+        };
+
+        template <>
+        struct ResultSlot<void>
+        {
+            template <typename V, typename N>
+            void store(V* v, N* n) { v->visit(n); }
+
+            void take() {}
+        };
+    }
+
+    struct VisitorBase : internal::DispatchBase<visitable_nodes> {};
+
+    namespace internal {
+        // The typed half: one `visit` per node type, and the `dispatch`
+        // that calls it.
+        template <typename R, typename List>
+        struct TypedVisitor;
+
+        template <typename R, typename T0, typename... T>
+        struct TypedVisitor<R, node_list<T0, T...>> : TypedVisitor<R, node_list<T...>>
+        {
+            using TypedVisitor<R, node_list<T...>>::visit;
+            using TypedVisitor<R, node_list<T...>>::dispatch;
+
+            virtual R visit(T0*) = 0;
+            void dispatch(T0* n) final { this->store(this, n); }
+        };
+
+        template <typename R, typename T0>
+        struct TypedVisitor<R, node_list<T0>> : VisitorBase, ResultSlot<R>
+        {
+            using VisitorBase::dispatch;
+
+            virtual R visit(T0*) = 0;
+            void dispatch(T0* n) final { this->store(this, n); }
+        };
+    }
+
+    /*
+     * The base for all visitors, templated on what each `visit` returns.
      */
-    struct Visitor
+    template <typename R>
+    struct Visitor : internal::TypedVisitor<R, visitable_nodes>
     {
-        virtual ~Visitor() {}
-
-        virtual any visit(ASTNode*) = 0;
-        virtual any visit(Expression*) = 0;
-        virtual any visit(Statement*) = 0;
-        virtual any visit(Boolean*) = 0;
-        virtual any visit(Integer*) = 0;
-        virtual any visit(Byte*) = 0;
-        virtual any visit(Long*) = 0;
-        virtual any visit(UnsignedInteger*) = 0;
-        virtual any visit(UnsignedByte*) = 0;
-        virtual any visit(UnsignedLong*) = 0;
-        virtual any visit(Float*) = 0;
-        virtual any visit(Double*) = 0;
-        virtual any visit(String*) = 0;
-        virtual any visit(Symbol*) = 0;
-        virtual any visit(Nothing*) = 0;
-        virtual any visit(Identifier*) = 0;
-        virtual any visit(FullyQualified*) = 0;
-        virtual any visit(RelativeIdentifier*) = 0;
-        virtual any visit(BinaryOp*) = 0;
-        virtual any visit(UnaryOp*) = 0;
-        virtual any visit(TernaryOp*) = 0;
-        virtual any visit(Member*) = 0;
-        virtual any visit(Subscript*) = 0;
-        virtual any visit(GenericTypename*) = 0;
-        virtual any visit(Typename*) = 0;
-        virtual any visit(Variant*) = 0;
-        virtual any visit(Optional*) = 0;
-        virtual any visit(Cast*) = 0;
-        virtual any visit(TypeCheck*) = 0;
-        virtual any visit(Alias*) = 0;
-        virtual any visit(Enum*) = 0;
-        virtual any visit(SymbolList*) = 0;
-        virtual any visit(TypePair*) = 0;
-
-        virtual any visit(BareExpression*) = 0;
-        virtual any visit(If*) = 0;
-        virtual any visit(While*) = 0;
-        virtual any visit(For*) = 0;
-        virtual any visit(With*) = 0;
-        virtual any visit(Break*) = 0;
-        virtual any visit(Continue*) = 0;
-        virtual any visit(Match*) = 0;
-        virtual any visit(On*) = 0;
-        virtual any visit(When*) = 0;
-        virtual any visit(TypeCase*) = 0;
-        virtual any visit(Default*) = 0;
-        virtual any visit(PredicateCall*) = 0;
-        virtual any visit(NamedArgument*) = 0;
-        virtual any visit(Call*) = 0;
-        virtual any visit(Arguments*) = 0;
-        virtual any visit(Condition*) = 0;
-        virtual any visit(Def*) = 0;
-        virtual any visit(GenericDef*) = 0;
-        virtual any visit(Return*) = 0;
-        virtual any visit(Extern*) = 0;
-        virtual any visit(TypeDeclaration*) = 0;
-        virtual any visit(Variable* n) = 0;
-        virtual any visit(Constant* n) = 0;
-        virtual any visit(Block* n) = 0;
-        virtual any visit(Assign* n) = 0;
-        virtual any visit(CompoundAssign* n) = 0;
-        virtual any visit(Do* n) = 0;
-        virtual any visit(Array* n) = 0;
-        virtual any visit(List* n) = 0;
-        virtual any visit(Tuple* n) = 0;
-        virtual any visit(DictionaryEntry* n) = 0;
-        virtual any visit(Dictionary* n) = 0;
-        virtual any visit(Structure* n) = 0;
-        virtual any visit(Try* n) = 0;
-        virtual any visit(Catch* n) = 0;
-        virtual any visit(Throw* n) = 0;
-        virtual any visit(Finally* n) = 0;
-
-        virtual any visit(Program* n) = 0;
-        virtual any visit(Module* n) = 0;
+        using result_type = R;
     };
 }}
 
-#endif /* RHEA_VISITOR_HPP */
\ No newline at end of file
+namespace rhea { namespace ast {
+    template <typename R>
+    R ASTNode::visit(visitor::Visitor<R>* v)
+    {
+        // A nested visit may overwrite the result slot, but this node's
+        // own `visit` finishes last, so what's left is the right answer.
+        accept(v);
+        return v->take();
+    }
+}}
+
+#endif /* RHEA_VISITOR_HPP */
@@ -0,0 +1,170 @@
+#include "ast/arena.hpp"
+#include "ast/nodes/node_base.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+namespace rhea { namespace ast {
+    namespace {
+        // The arena in use on this thread, if any.
+        thread_local Arena* current_arena = nullptr;
+
+        // The node whose destructor ran last on this thread, and where its
+        // memory came from. operator delete is called right after that, but
+        // the node is gone by then, so this is how it finds out.
+        struct destroyed_node
+        {
+            const void* node;
+            Arena* arena;
+        };
+
+        thread_local destroyed_node last_destroyed { nullptr, nullptr };
+
+        std::size_t align_up(std::size_t value, std::size_t align)
+        {
+            return (value + align - 1) & ~(align - 1);
+        }
+    }
+
+    Arena::Arena(std::size_t block_size)
+        : m_block_size(block_size)
+    {
+        assert(block_size > 0);
+    }
+
+    Arena::~Arena()
+    {
+        if (m_live != 0)
+        {
+            // The remaining nodes point into our blocks, and deleting them
+            // later would touch freed memory. There's no recovering from
+            // that, so stop now rather than corrupt the heap.
+            std::fprintf(stderr, "AST arena destroyed with %zu live nodes\n", m_live.load());
+            std::abort();
+        }
+
+        release();
+    }
+
+    void* Arena::allocate(std::size_t size, std::size_t align)
+    {
+        assert(align != 0 && (align & (align - 1)) == 0);
+
+        auto address = reinterpret_cast<std::uintptr_t>(m_next);
+        auto padding = align_up(address, align) - address;
+
+        if (m_next == nullptr || padding + size > static_cast<std::size_t>(m_end - m_next))
+        {
+            add_block(size + align);
+
+            address = reinterpret_cast<std::uintptr_t>(m_next);
+            padding = align_up(address, align) - address;
+        }
+
+        auto result = m_next + padding;
+        m_next = result + size;
+        m_used += padding + size;
+
+        return result;
+    }
+
+    void Arena::release()
+    {
+        if (m_live != 0)
+        {
+            // Anything still alive would be left pointing at freed memory.
+            throw std::logic_error(
+                "Can't release an AST arena with " + std::to_string(m_live.load()) + " live nodes"
+            );
+        }
+
+        for (auto block : m_blocks)
+        {
+            ::operator delete(block);
+        }
+
+        m_blocks.clear();
+        m_next = m_end = nullptr;
+        m_used = 0;
+    }
+
+    void Arena::add_block(std::size_t min_size)
+    {
+        // Oversized requests get a block of their own, which means the
+        // rest of the current one is wasted, but that should be rare for
+        // AST nodes.
+        auto size = std::max(m_block_size, min_size);
+
+        auto block = static_cast<char*>(::operator new(size));
+        m_blocks.push_back(block);
+
+        m_next = block;
+        m_end = block + size;
+    }
+
+    Arena* Arena::current()
+    {
+        return current_arena;
+    }
+
+    ArenaScope::ArenaScope(Arena& arena)
+        : m_previous(current_arena)
+    {
+        current_arena = &arena;
+    }
+
+    ArenaScope::~ArenaScope()
+    {
+        current_arena = m_previous;
+    }
+
+    void* ASTNode::operator new(std::size_t size)
+    {
+        auto arena = current_arena;
+
+        if (arena == nullptr)
+        {
+            return ::operator new(size);
+        }
+
+        auto memory = arena->allocate(size, alignof(std::max_align_t));
+        ++arena->m_live;
+
+        return memory;
+    }
+
+    ASTNode::~ASTNode()
+    {
+        last_destroyed = destroyed_node { this, m_arena };
+    }
+
+    void ASTNode::operator delete(void* ptr) noexcept
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+
+        // Normally, this node's destructor just ran and left its arena.
+        // If it never got that far (its constructor's arguments threw, for
+        // instance), operator new was only just called on this thread, so
+        // the memory came from the current arena.
+        auto arena = (last_destroyed.node == ptr) ? last_destroyed.arena : current_arena;
+        last_destroyed = destroyed_node { nullptr, nullptr };
+
+        if (arena != nullptr)
+        {
+            // Arena memory is only reclaimed in bulk.
+            --arena->m_live;
+            return;
+        }
+
+        ::operator delete(ptr);
+    }
+}}
@@ -13,14 +13,13 @@ namespace rhea { namespace ast {
     namespace internal {
         namespace gr = rhea::grammar;
         /*
-         * Except for rewriting a good chunk of PEGTL's parse tree builder,
-         * I don't see any obvious way to do this besides a big type switch.
-         * At the very least, we can break it down into more manageable parts.
-         * Thus, here we define a few node creation functions, one for each
-         * of the "main" AST node types. Unfortunately, there's not too much
-         * we can do with templates here, because the node constructors take
-         * different arguments, and we have to decide at run time which one
-         * to use.
+         * Here we define a few node creation functions, one for each of the
+         * "main" AST node types. The node constructors all take different
+         * arguments, and we have to decide at run time which one to use.
+         * For the small groups (identifiers, typenames, and so on), that's
+         * a simple type switch. Expressions and statements have far too many
+         * rules for that, so they look up a per-rule builder in a table
+         * indexed by the rule ID the parser stored in each node.
          */
 
         const std::map<std::string, BasicType> integer_suffixes {
@@ -31,6 +30,109 @@ namespace rhea { namespace ast {
             { "_ul", BasicType::UnsignedLong }
         };
         
+        // Builder helper for integer literals. An empty suffix means the
+        // literal had none, and so is a default signed integer.
+        expression_ptr create_integer_literal(const std::string& lit, const std::string& suffix)
+        {
+            if (suffix.empty())
+            {
+                // No suffix means use a default signed integer. This is 32-bit
+                // at present, though we may want to make it 64-bit later on.
+                int32_t i = std::stoi(lit);
+                return make_expression<Integer>(i);
+            }
+
+            auto inttype = integer_suffixes.at(suffix);
+            switch (inttype)
+            {
+                case BasicType::Byte:
+                {
+                    int8_t i = std::stoi(lit);
+                    return make_expression<Byte>(i);
+                }
+                case BasicType::Long:
+                {
+                    int64_t i = std::stoll(lit);
+                    return make_expression<Long>(i);
+                }
+                case BasicType::UnsignedInteger:
+                {
+                    uint32_t i = std::stoi(lit);
+                    return make_expression<UnsignedInteger>(i);
+                }
+                case BasicType::UnsignedByte:
+                {
+                    uint8_t i = std::stoi(lit);
+                    return make_expression<UnsignedByte>(i);
+                }
+                case BasicType::UnsignedLong:
+                {
+                    uint64_t i = std::stoll(lit);
+                    return make_expression<UnsignedLong>(i);
+                }
+                default:
+                    throw unimplemented_type(suffix);
+            }
+        }
+
+        // Builder helper for floating-point literals.
+        expression_ptr create_float_literal(const std::string& lit, bool float_suffix)
+        {
+            if (float_suffix)
+            {
+                return make_expression<Float>(std::stof(lit));
+            }
+            else
+            {
+                return make_expression<Double>(std::stod(lit));
+            }
+        }
+
+        // Builder helper for hexadecimal literals: these can be either 32-bit
+        // or 64-bit; 64-bit is autodetected if the literal contains more than 8
+        // hex digits. Note that hex literals are unsigned by default.
+        expression_ptr create_hex_literal(const std::string& lit)
+        {
+            // Check for size up to 10, because of the leading "0x"
+            if (lit.length() <= 10)
+            {
+                return make_expression<UnsignedInteger>(std::stoi(lit, nullptr, 16));
+            }
+            else
+            {
+                return make_expression<UnsignedLong>(std::stoll(lit, nullptr, 16));
+            }
+        }
+
+        FunctionType function_type_for_suffix(const std::string& suffix)
+        {
+            if (suffix == "?")
+            {
+                return FunctionType::Predicate;
+            }
+            else if (suffix == "!")
+            {
+                return FunctionType::Unchecked;
+            }
+            else if (suffix == "$")
+            {
+                return FunctionType::Operator;
+            }
+            else
+            {
+                throw syntax_error(fmt::format("Unknown function suffix {0}", suffix));
+            }
+        }
+
+        // Parse nodes know their byte offset and where that points, so we can
+        // work back to the start of the buffer they came from, which is what
+        // the source manager keys on.
+        source::SourceLocation location_of(parser_node* node)
+        {
+            auto& begin = node->m_begin;
+            return source::SourceManager::global().location(begin.data - begin.byte, begin.byte);
+        }
+
         // Builder for identifiers, for when a more general expression can't be used.
         std::unique_ptr<AnyIdentifier> create_identifier_node(parser_node* node)
         {
@@ -96,7 +198,7 @@ namespace rhea { namespace ast {
             }
 
             assert(ident != nullptr);
-            ident->position = node->begin();
+            ident->position = location_of(node);
             return ident;
         }
 
@@ -190,7 +292,7 @@ namespace rhea { namespace ast {
             }
 
             assert(tname != nullptr);
-            tname->position = node->begin();
+            tname->position = location_of(node);
             return tname;
         }
 
@@ -249,13 +351,10 @@ namespace rhea { namespace ast {
         }
 
         // Builder helper for dictionary keys
-        DictionaryKey create_dictionary_key(parser_node* node)
+        DictionaryKey create_dictionary_key(expression_ptr expr)
         {
-            auto expr = create_expression_node(node);
-
-            // create_expression_node gives us a unique_ptr to an Expression node,
-            // as its name suggests. But that means we have to inspect its type and
-            // cast to the proper key node.
+            // Keys are built as ordinary expressions, which means we have to
+            // inspect the type and cast to the proper key node.
             auto expr_type = expr->expression_type().type();
 
             types::SimpleType* simple_type = util::get_if<types::SimpleType>(&expr_type);
@@ -293,6 +392,11 @@ namespace rhea { namespace ast {
             }
         }
 
+        DictionaryKey create_dictionary_key(parser_node* node)
+        {
+            return create_dictionary_key(create_expression_node(node));
+        }
+
         // Builder helper for dictionary entries
         std::unique_ptr<DictionaryEntry> create_dictionary_entry(parser_node* node)
         {
@@ -384,10 +488,16 @@ namespace rhea { namespace ast {
             }
             else if (node->is<gr::on_case>())
             {
-                // On case has a simple constant expression and the body.
+                // On case has one or more constant expressions, then the body.
+                child_vector<Expression> values;
+                for (auto it = node->children.begin(); it != node->children.end() - 1; ++it)
+                {
+                    values.push_back(std::move(create_expression_node(it->get())));
+                }
+
                 result = std::make_unique<On>(
-                    std::move(create_expression_node(node->children.at(0).get())),
-                    std::move(create_statement_node(node->children.at(1).get()))
+                    values,
+                    std::move(create_statement_node(node->children.back().get()))
                 );
             }
             else if (node->is<gr::when_case>())
@@ -607,24 +717,7 @@ namespace rhea { namespace ast {
 
             if (cfn_node->children.size() > 1 && cfn_node->children.at(1)->is<gr::function_suffix>())
             {
-                auto& suffix = cfn_node->children.at(1);
-
-                if (suffix->string() == "?")
-                {
-                    function_type = FunctionType::Predicate;
-                }
-                else if (suffix->string() == "!")
-                {
-                    function_type = FunctionType::Unchecked;
-                }
-                else if (suffix->string() == "$")
-                {
-                    function_type = FunctionType::Operator;
-                }
-                else
-                {
-                    throw syntax_error(fmt::format("Unknown function suffix {0}", suffix->string()));
-                }
+                function_type = function_type_for_suffix(cfn_node->children.at(1)->string());
             }
 
             // The return type is the third child of the concept function type node,
@@ -724,789 +817,884 @@ namespace rhea { namespace ast {
                 throw unimplemented_type(node->name());
         }
 
-        // Builder for expressions.
-        expression_ptr create_expression_node(parser_node* node)
+        /*
+         * Expressions and statements are built by dispatching on the rule
+         * ID stored in each parse node (see rule_id.hpp). Every rule we know
+         * how to handle gets a specialization of one of the two templates
+         * below. The base templates throw, so a rule that doesn't have a
+         * specialization is reported as unimplemented, same as before.
+         */
+        template <typename Rule>
+        expression_ptr build_expression(parser_node* node)
         {
-            expression_ptr expr;
+            throw unimplemented_type(node->name());
+        }
 
-            // Floating-point literals
-            if (node->is<gr::float_literal>())
-            {
-                std::string lit { node->children.front()->string() };
+        template <typename Rule>
+        statement_ptr build_statement(parser_node* node)
+        {
+            throw unimplemented_type(node->name());
+        }
 
-                // If the float literal suffix "_f" is present, create a float,
-                // otherwise make it a double.
-                if (node->children.back()->is<gr::float_literal_suffix>())
-                {
-                    expr = make_expression<Float>(std::stof(lit));
-                }
-                else
-                {
-                    expr = make_expression<Double>(std::stod(lit));
-                }
-            }
+        // Floating-point literals
+        template <>
+        expression_ptr build_expression<gr::float_literal>(parser_node* node)
+        {
+            // If the float literal suffix "_f" is present, create a float,
+            // otherwise make it a double.
+            return create_float_literal(
+                node->children.front()->string(),
+                node->children.back()->is<gr::float_literal_suffix>()
+            );
+        }
 
-            // Integer literals
-            else if (node->is<gr::integer_literal>())
-            {
-                std::string lit { node->children.front()->string() };
+        // Integer literals
+        template <>
+        expression_ptr build_expression<gr::integer_literal>(parser_node* node)
+        {
+            auto& suffix = node->children.back();
 
-                if (!node->children.back()->is<gr::integer_literal_suffix>())
-                {
-                    // No suffix means use a default signed integer. This is 32-bit
-                    // at present, though we may want to make it 64-bit later on.
-                    int32_t i = std::stoi(lit);
-                    expr = make_expression<Integer>(i);
-                }
-                else
-                {
-                    auto inttype = integer_suffixes.at(node->children.back()->string());
-                    switch (inttype)
-                    {
-                        case BasicType::Byte:
-                        {
-                            int8_t i = std::stoi(lit);
-                            expr = make_expression<Byte>(i);
-                            break;
-                        }
-                        case BasicType::Long:
-                        {
-                            int64_t i = std::stoll(lit);
-                            expr = make_expression<Long>(i);
-                            break;
-                        }
-                        case BasicType::UnsignedInteger:
-                        {
-                            uint32_t i = std::stoi(lit);
-                            expr = make_expression<UnsignedInteger>(i);
-                            break;
-                        }
-                        case BasicType::UnsignedByte:
-                        {
-                            uint8_t i = std::stoi(lit);
-                            expr = make_expression<UnsignedByte>(i);
-                            break;
-                        }
-                        case BasicType::UnsignedLong:
-                        {
-                            uint64_t i = std::stoll(lit);
-                            expr = make_expression<UnsignedLong>(i);
-                            break;
-                        }
-                        default:
-                            throw unimplemented_type(node->name());
-                    }
-                }
-            }
+            return create_integer_literal(
+                node->children.front()->string(),
+                suffix->is<gr::integer_literal_suffix>() ? suffix->string() : ""
+            );
+        }
 
-            // Hexadecimal literals: these can be either 32-bit or 64-bit;
-            // 64-bit is autodetected if the literal contains more than 8
-            // hex digits. Note that hex literals are unsigned by default.
-            else if (node->is<gr::hex_literal>())
-            {
-                // Check for size up to 10, because of the leading "0x"
-                if (node->string().length() <= 10)
-                {
-                    expr = make_expression<UnsignedInteger>(std::stoi(node->string(), nullptr, 16));
-                }
-                else
-                {
-                    expr = make_expression<UnsignedLong>(std::stoll(node->string(), nullptr, 16));
-                }
-            }
+        // Hexadecimal literals
+        template <>
+        expression_ptr build_expression<gr::hex_literal>(parser_node* node)
+        {
+            return create_hex_literal(node->string());
+        }
 
-            // Boolean literals
-            else if (node->is<gr::boolean_literal>())
-            {
-                expr = std::make_unique<Boolean>(node->string() == "true");
-            }
+        // Boolean literals
+        template <>
+        expression_ptr build_expression<gr::boolean_literal>(parser_node* node)
+        {
+            return std::make_unique<Boolean>(node->string() == "true");
+        }
 
-            // "Nothing" type literals
-            else if (node->is<gr::nothing_literal>())
-            {
-                expr = std::make_unique<Nothing>();
-            }
+        // "Nothing" type literals
+        template <>
+        expression_ptr build_expression<gr::nothing_literal>(parser_node* node)
+        {
+            return std::make_unique<Nothing>();
+        }
 
-            // String literals: these are difficult, because we have to "unescape" them
-            // before passing them to codegen. I wrestled with the decision on where to
-            // do that, but I've decided to pass the buck here. Let the AST node itself
-            // be responsible for that when the time comes. That also helps serialization,
-            // since we don't have to go back and forth as much.
-            else if (node->is<gr::string_literal>())
-            {
-                // String literal parse nodes have a single child containing the string
-                // itself. These are wrapped in a "quote" node, because Rhea strings can
-                // be single or double quoted. But we don't care about that by this point,
-                // so they're normalized to double quotes in the AST, and we just ignore
-                // whatever the user initially chose.
-                expr = make_expression<String>(node->children.front()->string());
-            }
+        // String literals: these are difficult, because we have to "unescape" them
+        // before passing them to codegen. I wrestled with the decision on where to
+        // do that, but I've decided to pass the buck here. Let the AST node itself
+        // be responsible for that when the time comes. That also helps serialization,
+        // since we don't have to go back and forth as much.
+        template <>
+        expression_ptr build_expression<gr::string_literal>(parser_node* node)
+        {
+            // String literal parse nodes have a single child containing the string
+            // itself. These are wrapped in a "quote" node, because Rhea strings can
+            // be single or double quoted. But we don't care about that by this point,
+            // so they're normalized to double quotes in the AST, and we just ignore
+            // whatever the user initially chose.
+            return make_expression<String>(node->children.front()->string());
+        }
 
-            // Identifiers
-            else if (node->is<gr::identifier>() ||
-                node->is<gr::fully_qualified>() ||
-                node->is<gr::relative_identifier>())
-            {
-                expr = create_identifier_node(node);
-            }
+        // Identifiers
+        template <>
+        expression_ptr build_expression<gr::identifier>(parser_node* node)
+        {
+            return create_identifier_node(node);
+        }
+        template <>
+        expression_ptr build_expression<gr::fully_qualified>(parser_node* node)
+        {
+            return create_identifier_node(node);
+        }
+        template <>
+        expression_ptr build_expression<gr::relative_identifier>(parser_node* node)
+        {
+            return create_identifier_node(node);
+        }
 
-            // Symbols
-            else if (node->is<gr::symbol_name>())
-            {
-                // Symbol parse nodes always have a single child with the symbol name
-                // as its content.
-                expr = std::make_unique<Symbol>(node->children.at(0)->string());
-            }
+        // Symbols
+        template <>
+        expression_ptr build_expression<gr::symbol_name>(parser_node* node)
+        {
+            // Symbol parse nodes always have a single child with the symbol name
+            // as its content.
+            return std::make_unique<Symbol>(node->children.at(0)->string());
+        }
 
-            // Binary operators: all of these delegate to the helper defined above.
-            else if (node->is<gr::add_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::Add);
-            }
-            else if (node->is<gr::subtract_operator>())
+        // Binary operators: all of these delegate to the helper defined above.
+        template <>
+        expression_ptr build_expression<gr::add_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::Add);
+        }
+        template <>
+        expression_ptr build_expression<gr::subtract_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::Subtract);
+        }
+        template <>
+        expression_ptr build_expression<gr::multiply_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::Multiply);
+        }
+        template <>
+        expression_ptr build_expression<gr::divide_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::Divide);
+        }
+        template <>
+        expression_ptr build_expression<gr::modulus_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::Modulus);
+        }
+        template <>
+        expression_ptr build_expression<gr::exponent_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::Exponent);
+        }
+        template <>
+        expression_ptr build_expression<gr::left_shift_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::LeftShift);
+        }
+        template <>
+        expression_ptr build_expression<gr::right_shift_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::RightShift);
+        }
+        template <>
+        expression_ptr build_expression<gr::equals_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::Equals);
+        }
+        template <>
+        expression_ptr build_expression<gr::not_equal_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::NotEqual);
+        }
+        template <>
+        expression_ptr build_expression<gr::less_than_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::LessThan);
+        }
+        template <>
+        expression_ptr build_expression<gr::greater_than_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::GreaterThan);
+        }
+        template <>
+        expression_ptr build_expression<gr::less_equal_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::LessThanOrEqual);
+        }
+        template <>
+        expression_ptr build_expression<gr::greater_equal_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::GreaterThanOrEqual);
+        }
+        template <>
+        expression_ptr build_expression<gr::bitand_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::BitAnd);
+        }
+        template <>
+        expression_ptr build_expression<gr::bitor_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::BitOr);
+        }
+        template <>
+        expression_ptr build_expression<gr::bitxor_operator>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::BitXor);
+        }
+        template <>
+        expression_ptr build_expression<gr::kw_and>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::BooleanAnd);
+        }
+        template <>
+        expression_ptr build_expression<gr::kw_or>(parser_node* node)
+        {
+            return create_binop_node(node, BinaryOperators::BooleanOr);
+        }
+
+        // Unary operators: all of these delegate to the helper above.
+        template <>
+        expression_ptr build_expression<gr::coerce_operator>(parser_node* node)
+        {
+            return create_unary_node(node, UnaryOperators::Coerce);
+        }
+        template <>
+        expression_ptr build_expression<gr::bitnot_operator>(parser_node* node)
+        {
+            return create_unary_node(node, UnaryOperators::BitNot);
+        }
+        template <>
+        expression_ptr build_expression<gr::dereference_operator>(parser_node* node)
+        {
+            return create_unary_node(node, UnaryOperators::Dereference);
+        }
+        template <>
+        expression_ptr build_expression<gr::unary_plus_operator>(parser_node* node)
+        {
+            return create_unary_node(node, UnaryOperators::Plus);
+        }
+        template <>
+        expression_ptr build_expression<gr::unary_minus_operator>(parser_node* node)
+        {
+            return create_unary_node(node, UnaryOperators::Minus);
+        }
+        template <>
+        expression_ptr build_expression<gr::kw_not>(parser_node* node)
+        {
+            return create_unary_node(node, UnaryOperators::BooleanNot);
+        }
+        template <>
+        expression_ptr build_expression<gr::kw_ref>(parser_node* node)
+        {
+            return create_unary_node(node, UnaryOperators::Ref);
+        }
+        template <>
+        expression_ptr build_expression<gr::kw_ptr>(parser_node* node)
+        {
+            return create_unary_node(node, UnaryOperators::Ptr);
+        }
+
+        // Array expressions: `[1,2,3]`
+        template <>
+        expression_ptr build_expression<gr::array_expression>(parser_node* node)
+        {
+            std::vector<expression_ptr> exs;
+            auto& ch = node->children;
+            std::for_each(ch.begin(), ch.end(), 
+                [&](std::unique_ptr<parser_node>& el)
+                { exs.emplace_back(std::move(create_expression_node(el.get()))); }
+            );
+
+            return make_expression<Array>(exs);
+        }
+
+        // List expressions: `(1,2,3)`
+        template <>
+        expression_ptr build_expression<gr::list_expression>(parser_node* node)
+        {
+            std::vector<expression_ptr> exs;
+            auto& ch = node->children;
+            std::for_each(ch.begin(), ch.end(), 
+                [&](std::unique_ptr<parser_node>& el)
+                { exs.emplace_back(std::move(create_expression_node(el.get()))); }
+            );
+
+            return make_expression<List>(exs);
+        }
+
+        // Tuple expressions: `{1,2,3}`
+        template <>
+        expression_ptr build_expression<gr::tuple_expression>(parser_node* node)
+        {
+            std::vector<expression_ptr> exs;
+            auto& ch = node->children;
+            std::for_each(ch.begin(), ch.end(), 
+                [&](std::unique_ptr<parser_node>& el)
+                { exs.emplace_back(std::move(create_expression_node(el.get()))); }
+            );
+
+            return make_expression<Tuple>(exs);
+        }
+
+        // Symbol list expressions: `@{a,b,c}`
+        template <>
+        expression_ptr build_expression<gr::symbol_list_expression>(parser_node* node)
+        {
+            std::vector<std::string> syms;
+            auto& ch = node->children;
+            std::for_each(ch.begin(), ch.end(), 
+                [&](std::unique_ptr<parser_node>& el)
+                { syms.push_back(el->string()); }
+            );
+
+            return make_expression<SymbolList>(syms);
+        }
+
+        // Dictionary expressions: `{ @foo: "bar" }`
+        template <>
+        expression_ptr build_expression<gr::dictionary_expression>(parser_node* node)
+        {
+            std::vector<std::unique_ptr<DictionaryEntry>> entries;
+            auto& ch = node->children;
+            std::for_each(ch.begin(), ch.end(),
+                [&](std::unique_ptr<parser_node>& el)
+                { entries.emplace_back(std::move(create_dictionary_entry(el.get()))); }
+            );
+
+            return make_expression<Dictionary>(entries);
+        }
+
+        // Member access expressions: `x.y`
+        template <>
+        expression_ptr build_expression<gr::member_expr>(parser_node* node)
+        {
+            return make_expression<Member>(
+                std::move(std::make_unique<Identifier>(node->children.at(0)->string())),
+                std::move(create_expression_node(node->children.at(1).get()))
+            );
+        }
+
+        // Subscript expressions: `x[y]`
+        // Note that the order is swapped. This is intentional.
+        template <>
+        expression_ptr build_expression<gr::subscript_expr>(parser_node* node)
+        {
+            return make_expression<Subscript>(
+                std::move(create_expression_node(node->children.at(1).get())),
+                std::move(create_expression_node(node->children.at(0).get()))
+            );
+        }
+
+        // Ternary expressions: `if a then b else c`
+        template <>
+        expression_ptr build_expression<gr::ternary_op>(parser_node* node)
+        {
+            return make_expression<TernaryOp>(
+                std::move(create_expression_node(node->children.at(0).get())),
+                std::move(create_expression_node(node->children.at(1).get())),
+                std::move(create_expression_node(node->children.at(2).get()))
+            );
+        }
+
+        // Cast operation: `foo as bar`
+        template <>
+        expression_ptr build_expression<gr::kw_as>(parser_node* node)
+        {
+            return make_expression<Cast>(
+                std::move(create_expression_node(node->children.at(0).get())),
+                std::move(create_typename_node(node->children.at(1).get()))
+            );
+        }
+
+        // Type check operation: `foo is integer`
+        template <>
+        expression_ptr build_expression<gr::kw_is>(parser_node* node)
+        {
+            return make_expression<TypeCheck>(
+                std::move(create_expression_node(node->children.at(0).get())),
+                std::move(create_typename_node(node->children.at(1).get()))
+            );
+        }
+
+        // Function call expressions
+        template <>
+        expression_ptr build_expression<gr::function_call_expr>(parser_node* node)
+        {
+            // Function calls have 3 possible parse trees. In all cases, the called
+            // expression is the last child, while the 1st holds the match for the
+            // function's arguments, which can be one of 3 different parse rules.
+            // A suffix (`f(x)?`), if there is one, comes between them.
+            auto fn = create_expression_node(node->children.back().get());
+
+            auto& args = node->children.at(0);
+            std::unique_ptr<Call> call;
+
+            // Empty argument list: `f()`
+            if (args->is<gr::empty_argument_list>())
             {
-                expr = create_binop_node(node, BinaryOperators::Subtract);
+                call = std::make_unique<Call>(std::move(fn));
             }
-            else if (node->is<gr::multiply_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::Multiply);
-            }
-            else if (node->is<gr::divide_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::Divide);
-            }
-            else if (node->is<gr::modulus_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::Modulus);
-            }
-            else if (node->is<gr::exponent_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::Exponent);
-            }
-            else if (node->is<gr::left_shift_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::LeftShift);
-            }
-            else if (node->is<gr::right_shift_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::RightShift);
-            }
-            else if (node->is<gr::equals_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::Equals);
-            }
-            else if (node->is<gr::not_equal_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::NotEqual);
-            }
-            else if (node->is<gr::less_than_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::LessThan);
-            }
-            else if (node->is<gr::greater_than_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::GreaterThan);
-            }
-            else if (node->is<gr::less_equal_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::LessThanOrEqual);
-            }
-            else if (node->is<gr::greater_equal_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::GreaterThanOrEqual);
-            }
-            else if (node->is<gr::bitand_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::BitAnd);
-            }
-            else if (node->is<gr::bitor_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::BitOr);
-            }
-            else if (node->is<gr::bitxor_operator>())
-            {
-                expr = create_binop_node(node, BinaryOperators::BitXor);
-            }
-            else if (node->is<gr::kw_and>())
-            {
-                expr = create_binop_node(node, BinaryOperators::BooleanAnd);
-            }
-            else if (node->is<gr::kw_or>())
-            {
-                expr = create_binop_node(node, BinaryOperators::BooleanOr);
-            }
-
-            // Unary operators: all of these delegate to the helper above.
-            else if (node->is<gr::coerce_operator>())
-            {
-                expr = create_unary_node(node, UnaryOperators::Coerce);
-            }
-            else if (node->is<gr::bitnot_operator>())
-            {
-                expr = create_unary_node(node, UnaryOperators::BitNot);
-            }
-            else if (node->is<gr::dereference_operator>())
-            {
-                expr = create_unary_node(node, UnaryOperators::Dereference);
-            }
-            else if (node->is<gr::unary_plus_operator>())
-            {
-                expr = create_unary_node(node, UnaryOperators::Plus);
-            }
-            else if (node->is<gr::unary_minus_operator>())
-            {
-                expr = create_unary_node(node, UnaryOperators::Minus);
-            }
-            else if (node->is<gr::kw_not>())
-            {
-                expr = create_unary_node(node, UnaryOperators::BooleanNot);
-            }
-            else if (node->is<gr::kw_ref>())
-            {
-                expr = create_unary_node(node, UnaryOperators::Ref);
-            }
-            else if (node->is<gr::kw_ptr>())
-            {
-                expr = create_unary_node(node, UnaryOperators::Ptr);
-            }
-
-            // Array expressions: `[1,2,3]`
-            else if (node->is<gr::array_expression>())
-            {
-                std::vector<expression_ptr> exs;
-                auto& ch = node->children;
-                std::for_each(ch.begin(), ch.end(), 
-                    [&](std::unique_ptr<parser_node>& el)
-                    { exs.emplace_back(std::move(create_expression_node(el.get()))); }
-                );
-
-                expr = make_expression<Array>(exs);
-            }
-            // List expressions: `(1,2,3)`
-            else if (node->is<gr::list_expression>())
-            {
-                std::vector<expression_ptr> exs;
-                auto& ch = node->children;
-                std::for_each(ch.begin(), ch.end(), 
-                    [&](std::unique_ptr<parser_node>& el)
-                    { exs.emplace_back(std::move(create_expression_node(el.get()))); }
-                );
-
-                expr = make_expression<List>(exs);
-            }
-            // Tuple expressions: `{1,2,3}`
-            else if (node->is<gr::tuple_expression>())
+            // Positional argument list: `f(1,2)`
+            else if (args->is<gr::unnamed_argument_list>())
             {
                 std::vector<expression_ptr> exs;
-                auto& ch = node->children;
+                auto& ch = args->children;
                 std::for_each(ch.begin(), ch.end(), 
                     [&](std::unique_ptr<parser_node>& el)
                     { exs.emplace_back(std::move(create_expression_node(el.get()))); }
                 );
 
-                expr = make_expression<Tuple>(exs);
+                call = std::make_unique<Call>(std::move(fn), exs);
             }
-            // Symbol list expressions: `@{a,b,c}`
-            else if (node->is<gr::symbol_list_expression>())
+            // Named argument list: `f(a: 1, b: 2)`
+            else if (args->is<gr::named_argument_list>())
             {
-                std::vector<std::string> syms;
-                auto& ch = node->children;
+                std::vector<std::unique_ptr<NamedArgument>> exs;
+                auto& ch = args->children;
                 std::for_each(ch.begin(), ch.end(), 
                     [&](std::unique_ptr<parser_node>& el)
-                    { syms.push_back(el->string()); }
-                );
-
-                expr = make_expression<SymbolList>(syms);
-            }
-            // Dictionary expressions: `{ @foo: "bar" }`
-            else if (node->is<gr::dictionary_expression>())
-            {
-                std::vector<std::unique_ptr<DictionaryEntry>> entries;
-                auto& ch = node->children;
-                std::for_each(ch.begin(), ch.end(),
-                    [&](std::unique_ptr<parser_node>& el)
-                    { entries.emplace_back(std::move(create_dictionary_entry(el.get()))); }
-                );
-
-                expr = make_expression<Dictionary>(entries);
-            }
-
-            // Member access expressions: `x.y`
-            else if (node->is<gr::member_expr>())
-            {
-                expr = make_expression<Member>(
-                    std::move(std::make_unique<Identifier>(node->children.at(0)->string())),
-                    std::move(create_expression_node(node->children.at(1).get()))
+                    { exs.emplace_back(std::move(create_named_argument(el.get()))); }
                 );
-            }
 
-            // Subscript expressions: `x[y]`
-            // Note that the order is swapped. This is intentional.
-            else if (node->is<gr::subscript_expr>())
-            {
-                expr = make_expression<Subscript>(
-                    std::move(create_expression_node(node->children.at(1).get())),
-                    std::move(create_expression_node(node->children.at(0).get()))
-                );
+                call = std::make_unique<Call>(std::move(fn), exs);
             }
-
-            // Ternary expressions: `if a then b else c`
-            else if (node->is<gr::ternary_op>())
+            // Something else, which shouldn't happen unless someone's trying to
+            // manually construct a parse tree, or there's a bug in the grammar.
+            else
             {
-                expr = make_expression<TernaryOp>(
-                    std::move(create_expression_node(node->children.at(0).get())),
-                    std::move(create_expression_node(node->children.at(1).get())),
-                    std::move(create_expression_node(node->children.at(2).get()))
-                );
+                throw unimplemented_type(node->name());
             }
 
-            // Cast operation: `foo as bar`
-            else if (node->is<gr::kw_as>())
+            if (node->children.size() > 2 && node->children.at(1)->is<gr::function_suffix>())
             {
-                expr = make_expression<Cast>(
-                    std::move(create_expression_node(node->children.at(0).get())),
-                    std::move(create_typename_node(node->children.at(1).get()))
-                );
+                call->type = function_type_for_suffix(node->children.at(1)->string());
             }
 
-            // Type check operation: `foo is integer`
-            else if (node->is<gr::kw_is>())
-            {
-                expr = make_expression<TypeCheck>(
-                    std::move(create_expression_node(node->children.at(0).get())),
-                    std::move(create_typename_node(node->children.at(1).get()))
-                );
-            }
+            return std::move(call);
+        }
 
-            // Function call expressions
-            else if (node->is<gr::function_call_expr>())
-            {
-                // Function calls have 3 possible parse trees. In all cases, the called
-                // expression is the 2nd child, while the 1st holds the match for the
-                // function's arguments, which can be one of 3 different parse rules.
-                auto fn = create_expression_node(node->children.at(1).get());
+        // Bare expressions used in statement context: `foo();`
+        template <>
+        statement_ptr build_statement<gr::bare_expression>(parser_node* node)
+        {
+            return make_statement<BareExpression>(std::move(
+                create_expression_node(node->children.at(0).get())
+            ));
+        }
 
-                auto& args = node->children.at(0);
+        // Statement blocks: `{ foo(); bar(); }`
+        template <>
+        statement_ptr build_statement<gr::statement_block>(parser_node* node)
+        {
+            std::vector<statement_ptr> block_stmts;
+            auto& ch = node->children;
+            std::for_each(ch.begin(), ch.end(), 
+                [&](std::unique_ptr<parser_node>& el)
+                { block_stmts.emplace_back(std::move(create_statement_node(el.get()))); }
+            );
 
-                // Empty argument list: `f()`
-                if (args->is<gr::empty_argument_list>())
-                {
-                    expr = make_expression<Call>(std::move(fn));
-                }
-                // Positional argument list: `f(1,2)`
-                else if (args->is<gr::unnamed_argument_list>())
-                {
-                    std::vector<expression_ptr> exs;
-                    auto& ch = args->children;
-                    std::for_each(ch.begin(), ch.end(), 
-                        [&](std::unique_ptr<parser_node>& el)
-                        { exs.emplace_back(std::move(create_expression_node(el.get()))); }
-                    );
+            return make_statement<Block>(block_stmts);
+        }
 
-                    expr = make_expression<Call>(std::move(fn), exs);
-                }
-                // Named argument list: `f(a: 1, b: 2)`
-                else if (args->is<gr::named_argument_list>())
-                {
-                    std::vector<std::unique_ptr<NamedArgument>> exs;
-                    auto& ch = args->children;
-                    std::for_each(ch.begin(), ch.end(), 
-                        [&](std::unique_ptr<parser_node>& el)
-                        { exs.emplace_back(std::move(create_named_argument(el.get()))); }
-                    );
+        // Variable definition: `var x = y * z;`
+        template <>
+        statement_ptr build_statement<gr::variable_declaration>(parser_node* node)
+        {
+            return make_statement<Variable>(
+                std::move(std::make_unique<Identifier>(node->children.at(0)->string())),
+                std::move(create_expression_node(node->children.at(1).get()))
+            );
+        }
 
-                    expr = make_expression<Call>(std::move(fn), exs);
-                }
-                // Something else, which shouldn't happen unless someone's trying to
-                // manually construct a parse tree, or there's a bug in the grammar.
-                else
-                {
-                    throw unimplemented_type(node->name());
-                }
-            }
+        // Variable declaration: `var x as y;`
+        template <>
+        statement_ptr build_statement<gr::declaration_as_type>(parser_node* node)
+        {
+            return make_statement<TypeDeclaration>(
+                std::move(std::make_unique<Identifier>(node->children.at(0)->string())),
+                std::move(create_typename_node(node->children.at(1).get()))
+            );
+        }
 
-            else
-            {
-                throw unimplemented_type(node->name());
-            }
+        // Constant definitino: `const bar = 42;`
+        template <>
+        statement_ptr build_statement<gr::constant_declaration>(parser_node* node)
+        {
+            return make_statement<Constant>(
+                std::move(std::make_unique<Identifier>(node->children.at(0)->string())),
+                std::move(create_expression_node(node->children.at(1).get()))
+            );
+        }
 
-            assert(expr != nullptr);
-            expr->position = node->begin();
-            return expr;
+        // Variable assignment: `foo = bar ** 2;`
+        template <>
+        statement_ptr build_statement<gr::assignment>(parser_node* node)
+        {
+            return make_statement<Assign>(
+                std::move(create_expression_node(node->children.at(0).get())),
+                std::move(create_expression_node(node->children.at(1).get()))
+            );
         }
 
-        // Builder for statements.
-        statement_ptr create_statement_node(parser_node* node)
+        // Compound assignment: `i -= 1;`
+        template <>
+        statement_ptr build_statement<gr::compound_assignment>(parser_node* node)
         {
-            statement_ptr stmt;
+            return make_statement<CompoundAssign>(
+                std::move(create_expression_node(node->children.at(0).get())),
+                assignment_operator_type(node->children.at(1).get()),
+                std::move(create_expression_node(node->children.at(2).get()))
+            );
+        }
 
-            // Bare expressions used in statement context: `foo();`
-            if (node->is<gr::bare_expression>())
-            {
-                stmt = make_statement<BareExpression>(std::move(
-                    create_expression_node(node->children.at(0).get())
-                ));
-            }
+        // Type alias: `type T = |A,B,C|;`
+        template <>
+        statement_ptr build_statement<gr::type_alias>(parser_node* node)
+        {
+            return make_statement<Alias>(
+                std::move(std::make_unique<Identifier>(node->children.at(0)->string())),
+                std::move(create_typename_node(node->children.at(1).get()))
+            );
+        }
 
-            // Statement blocks: `{ foo(); bar(); }`
-            else if (node->is<gr::statement_block>())
-            {
-                std::vector<statement_ptr> block_stmts;
-                auto& ch = node->children;
-                std::for_each(ch.begin(), ch.end(), 
-                    [&](std::unique_ptr<parser_node>& el)
-                    { block_stmts.emplace_back(std::move(create_statement_node(el.get()))); }
-                );
+        // Enum declaration: `type En = @{a,b,c};`
+        template <>
+        statement_ptr build_statement<gr::enum_declaration>(parser_node* node)
+        {
+            std::vector<std::string> syms;
+            auto& ch = node->children.at(1)->children;
+            std::for_each(ch.begin(), ch.end(), 
+                [&](std::unique_ptr<parser_node>& el)
+                { syms.push_back(el->string()); }
+            );
 
-                stmt = make_statement<Block>(block_stmts);
-            }
+            return make_statement<Enum>(
+                std::move(std::make_unique<Identifier>(node->children.at(0)->string())),
+                std::move(std::make_unique<SymbolList>(syms))
+            );
+        }
 
-            // Variable definition: `var x = y * z;`
-            else if (node->is<gr::variable_declaration>())
-            {
-                stmt = make_statement<Variable>(
-                    std::move(std::make_unique<Identifier>(node->children.at(0)->string())),
-                    std::move(create_expression_node(node->children.at(1).get()))
-                );
-            }
+        // Structure declaration: `type Foo = { bar: string };`
+        template <>
+        statement_ptr build_statement<gr::structure_declaration>(parser_node* node)
+        {
+            child_vector<TypePair> fields;
+            auto& ch = node->children;
+            std::for_each(ch.begin()+1, ch.end(), 
+                [&](std::unique_ptr<parser_node>& el)
+                { fields.emplace_back(std::move(create_typepair_node(el.get()))); }
+            );
 
-            // Variable declaration: `var x as y;`
-            else if (node->is<gr::declaration_as_type>())
-            {
-                stmt = make_statement<TypeDeclaration>(
-                    std::move(std::make_unique<Identifier>(node->children.at(0)->string())),
-                    std::move(create_typename_node(node->children.at(1).get()))
-                );
-            }
+            return make_statement<Structure>(
+                std::move(std::make_unique<Identifier>(node->children.at(0)->string())),
+                fields
+            );                
+        }
 
-            // Constant definitino: `const bar = 42;`
-            else if (node->is<gr::constant_declaration>())
-            {
-                stmt = make_statement<Constant>(
-                    std::move(std::make_unique<Identifier>(node->children.at(0)->string())),
-                    std::move(create_expression_node(node->children.at(1).get()))
-                );
-            }
+        // Do statement: `do that;`
+        template <>
+        statement_ptr build_statement<gr::do_statement>(parser_node* node)
+        {
+            return make_statement<Do>(
+                std::move(create_expression_node(node->children.at(0).get()))
+            );
+        }
 
-            // Variable assignment: `foo = bar ** 2;`
-            else if (node->is<gr::assignment>())
-            {
-                stmt = make_statement<Assign>(
-                    std::move(create_expression_node(node->children.at(0).get())),
-                    std::move(create_expression_node(node->children.at(1).get()))
-                );
-            }
+        // If statement: `if (x > 0) { do this; } else { do that; }`
+        template <>
+        statement_ptr build_statement<gr::if_statement>(parser_node* node)
+        {
+            return make_statement<If>(
+                std::move(create_expression_node(node->children.at(0).get())),
+                std::move(create_statement_node(node->children.at(1).get())),
+                node->children.size() > 2
+                    ? std::move(create_statement_node(node->children.at(2).get()))
+                    : nullptr
+            );
+        }
 
-            // Compound assignment: `i -= 1;`
-            else if (node->is<gr::compound_assignment>())
-            {
-                stmt = make_statement<CompoundAssign>(
-                    std::move(create_expression_node(node->children.at(0).get())),
-                    assignment_operator_type(node->children.at(1).get()),
-                    std::move(create_expression_node(node->children.at(2).get()))
-                );
-            }
+        // Unless statement: `unless (x == nothing) { do x; }`
+        template <>
+        statement_ptr build_statement<gr::unless_statement>(parser_node* node)
+        {
+            // An "unless" is just an "if" with an inverted condition and no else.
+            // We model that by making an If AST node that has a null "then" part.
+            return make_statement<If>(
+                std::move(create_expression_node(node->children.at(0).get())),
+                nullptr,
+                std::move(create_statement_node(node->children.at(1).get()))
+            );
+        }
 
-            // Type alias: `type T = |A,B,C|;`
-            else if (node->is<gr::type_alias>())
-            {
-                stmt = make_statement<Alias>(
-                    std::move(std::make_unique<Identifier>(node->children.at(0)->string())),
-                    std::move(create_typename_node(node->children.at(1).get()))
-                );
-            }
+        // While statement: `while x < 10 { x += 1; }`
+        template <>
+        statement_ptr build_statement<gr::while_statement>(parser_node* node)
+        {
+            return make_statement<While>(
+                std::move(create_expression_node(node->children.at(0).get())),
+                std::move(create_statement_node(node->children.at(1).get()))
+            );
+        }
 
-            // Enum declaration: `type En = @{a,b,c};`
-            else if (node->is<gr::enum_declaration>())
-            {
-                std::vector<std::string> syms;
-                auto& ch = node->children.at(1)->children;
-                std::for_each(ch.begin(), ch.end(), 
-                    [&](std::unique_ptr<parser_node>& el)
-                    { syms.push_back(el->string()); }
-                );
+        // For statement: `for i in range { do foo; }`
+        template <>
+        statement_ptr build_statement<gr::for_statement>(parser_node* node)
+        {
+            return make_statement<For>(
+                node->children.at(0)->string(),
+                std::move(create_expression_node(node->children.at(1).get())),
+                std::move(create_statement_node(node->children.at(2).get()))
+            );
+        }
 
-                stmt = make_statement<Enum>(
-                    std::move(std::make_unique<Identifier>(node->children.at(0)->string())),
-                    std::move(std::make_unique<SymbolList>(syms))
-                );
-            }
+        // Break and continue statements are just empty nodes.
+        template <>
+        statement_ptr build_statement<gr::kw_break>(parser_node* node)
+        {
+            return make_statement<Break>();
+        }
+        template <>
+        statement_ptr build_statement<gr::kw_continue>(parser_node* node)
+        {
+            return make_statement<Continue>();
+        }
 
-            // Structure declaration: `type Foo = { bar: string };`
-            else if (node->is<gr::structure_declaration>())
-            {
-                child_vector<TypePair> fields;
-                auto& ch = node->children;
-                std::for_each(ch.begin()+1, ch.end(), 
-                    [&](std::unique_ptr<parser_node>& el)
-                    { fields.emplace_back(std::move(create_typepair_node(el.get()))); }
-                );
+        // With statement: `with (foo.is_bar?) { do baz; }
+        template <>
+        statement_ptr build_statement<gr::with_statement>(parser_node* node)
+        {
+            child_vector<PredicateCall> predicates;
+            auto& ch = node->children.at(0)->children;
+            std::for_each(ch.begin(), ch.end(), 
+                [&](std::unique_ptr<parser_node>& el)
+                { predicates.emplace_back(std::move(create_predicate_call(el.get()))); }
+            );
 
-                stmt = make_statement<Structure>(
-                    std::move(std::make_unique<Identifier>(node->children.at(0)->string())),
-                    fields
-                );                
-            }
+            return make_statement<With>(
+                predicates,
+                std::move(create_statement_node(node->children.at(1).get()))
+            );
+        }
 
-            // Do statement: `do that;`
-            else if (node->is<gr::do_statement>())
-            {
-                stmt = make_statement<Do>(
-                    std::move(create_expression_node(node->children.at(0).get()))
-                );
-            }
+        // Match statement, with different kinds of case. All three rules
+        // have the same shape, so the other two delegate to this one.
+        template <>
+        statement_ptr build_statement<gr::match_on_statement>(parser_node* node)
+        {
+            // The expression to match against is the first child.
+            auto target = create_expression_node(node->children.at(0).get());
+            
+            // Next is the list of cases.
+            child_vector<Case> cases;
+            auto& ch = node->children;
+            std::for_each(ch.begin()+1, ch.end(), 
+                [&](std::unique_ptr<parser_node>& el)
+                { cases.emplace_back(std::move(create_case_node(el.get()))); }
+            );
 
-            // If statement: `if (x > 0) { do this; } else { do that; }`
-            else if (node->is<gr::if_statement>())
-            {
-                stmt = make_statement<If>(
-                    std::move(create_expression_node(node->children.at(0).get())),
-                    std::move(create_statement_node(node->children.at(1).get())),
-                    node->children.size() > 2
-                        ? std::move(create_statement_node(node->children.at(2).get()))
-                        : nullptr
-                );
-            }
+            return make_statement<Match>(
+                std::move(target),
+                cases
+            );
+        }
+        template <>
+        statement_ptr build_statement<gr::match_when_statement>(parser_node* node)
+        {
+            return build_statement<gr::match_on_statement>(node);
+        }
+        template <>
+        statement_ptr build_statement<gr::match_type_statement>(parser_node* node)
+        {
+            return build_statement<gr::match_on_statement>(node);
+        }
 
-            // Unless statement: `unless (x == nothing) { do x; }`
-            else if (node->is<gr::unless_statement>())
-            {
-                // An "unless" is just an "if" with an inverted condition and no else.
-                // We model that by making an If AST node that has a null "then" part.
-                stmt = make_statement<If>(
-                    std::move(create_expression_node(node->children.at(0).get())),
-                    nullptr,
-                    std::move(create_statement_node(node->children.at(1).get()))
-                );
-            }
+        // Function definitions, of various kinds. The inner logic is handled
+        // in the `create_function_definition` helper above. Here, we only
+        // store the type of the function being declared.
+        template <>
+        statement_ptr build_statement<gr::basic_function_def>(parser_node* node)
+        {
+            return create_function_definition(node, FunctionType::Basic);
+        }
+        template <>
+        statement_ptr build_statement<gr::unchecked_function_def>(parser_node* node)
+        {
+            return create_function_definition(node, FunctionType::Unchecked);
+        }
+        template <>
+        statement_ptr build_statement<gr::predicate_function_def>(parser_node* node)
+        {
+            return create_function_definition(node, FunctionType::Predicate);
+        }
+        template <>
+        statement_ptr build_statement<gr::operator_function_def>(parser_node* node)
+        {
+            return create_function_definition(node, FunctionType::Operator);
+        }
 
-            // While statement: `while x < 10 { x += 1; }`
-            else if (node->is<gr::while_statement>())
-            {
-                stmt = make_statement<While>(
-                    std::move(create_expression_node(node->children.at(0).get())),
-                    std::move(create_statement_node(node->children.at(1).get()))
-                );
-            }
+        // Return statement: `return false;`
+        template <>
+        statement_ptr build_statement<gr::return_statement>(parser_node* node)
+        {
+            return make_statement<Return>(
+                std::move(create_expression_node(node->children.front().get()))
+            );
+        }
 
-            // For statement: `for i in range { do foo; }`
-            else if (node->is<gr::for_statement>())
-            {
-                stmt = make_statement<For>(
-                    node->children.at(0)->string(),
-                    std::move(create_expression_node(node->children.at(1).get())),
-                    std::move(create_statement_node(node->children.at(2).get()))
-                );
-            }
+        // Extern declaration: `extern foo;`
+        template <>
+        statement_ptr build_statement<gr::extern_declaration>(parser_node* node)
+        {
+            return make_statement<Extern>(node->children.front()->string());
+        }
 
-            // Break and continue statements are just empty nodes.
-            else if (node->is<gr::kw_break>())
-            {
-                stmt = make_statement<Break>();
-            }
-            else if (node->is<gr::kw_continue>())
-            {
-                stmt = make_statement<Continue>();
-            }
+        // Throw statement: `throw bad();`
+        template <>
+        statement_ptr build_statement<gr::throw_statement>(parser_node* node)
+        {
+            return make_statement<Throw>(
+                std::move(create_expression_node(node->children.front().get()))
+            );
+        }
 
-            // With statement: `with (foo.is_bar?) { do baz; }
-            else if (node->is<gr::with_statement>())
-            {
-                child_vector<PredicateCall> predicates;
-                auto& ch = node->children.at(0)->children;
-                std::for_each(ch.begin(), ch.end(), 
-                    [&](std::unique_ptr<parser_node>& el)
-                    { predicates.emplace_back(std::move(create_predicate_call(el.get()))); }
-                );
+        // Finally statement: `finally { do foo; }`
+        template <>
+        statement_ptr build_statement<gr::finally_statement>(parser_node* node)
+        {
+            return make_statement<Finally>(
+                std::move(create_statement_node(node->children.front().get()))
+            );
+        }
 
-                stmt = make_statement<With>(
-                    predicates,
-                    std::move(create_statement_node(node->children.at(1).get()))
-                );
-            }
+        // Catch statement: `catch { e: Error } { do bar; }`
+        template <>
+        statement_ptr build_statement<gr::catch_statement>(parser_node* node)
+        {
+            return make_statement<Catch>(
+                std::move(create_typepair_node(node->children.at(0).get())),
+                std::move(create_statement_node(node->children.at(1).get()))
+            );
+        }
 
-            // Match statement, with different kinds of case
-            else if (
-                node->is<gr::match_on_statement>() ||
-                node->is<gr::match_when_statement>() ||
-                node->is<gr::match_type_statement>()
-            )
-            {
-                // The expression to match against is the first child.
-                auto target = create_expression_node(node->children.at(0).get());
-                
-                // Next is the list of cases.
-                child_vector<Case> cases;
-                auto& ch = node->children;
-                std::for_each(ch.begin()+1, ch.end(), 
-                    [&](std::unique_ptr<parser_node>& el)
-                    { cases.emplace_back(std::move(create_case_node(el.get()))); }
-                );
+        // Try statement: `try { do x; }...`
+        template <>
+        statement_ptr build_statement<gr::try_statement>(parser_node* node)
+        {
+            child_vector<Catch> catches;
 
-                stmt = make_statement<Match>(
-                    std::move(target),
-                    cases
-                );
-            }
+            auto& ch = node->children;
+            auto& last_child = node->children.back();
+            auto has_finally = last_child->is<gr::finally_statement>();
 
-            // Function definitions, of various kinds. The inner logic is handled
-            // in the `create_function_definition` helper above. Here, we only
-            // store the type of the function being declared.
-            else if (node->is<gr::basic_function_def>())
-            {
-                stmt = std::move(create_function_definition(node, FunctionType::Basic));
-            }
-            else if (node->is<gr::unchecked_function_def>())
-            {
-                stmt = std::move(create_function_definition(node, FunctionType::Unchecked));
-            }
-            else if (node->is<gr::predicate_function_def>())
-            {
-                stmt = std::move(create_function_definition(node, FunctionType::Predicate));
-            }
-            else if (node->is<gr::operator_function_def>())
-            {
-                stmt = std::move(create_function_definition(node, FunctionType::Operator));
-            }
+            auto try_part = create_statement_node(ch.front().get());
 
-            // Return statement: `return false;`
-            else if (node->is<gr::return_statement>())
-            {
-                stmt = make_statement<Return>(
-                    std::move(create_expression_node(node->children.front().get()))
-                );
-            }
+            std::for_each(ch.begin()+1, ch.end()-(has_finally ? 1 : 0),
+                [&](std::unique_ptr<parser_node>& el)
+                {
+                    auto ptr = create_statement_node(el.get());
+                    auto c = util::unique_ptr_downcast<Statement, Catch>(ptr);
 
-            // Extern declaration: `extern foo;`
-            else if (node->is<gr::extern_declaration>())
-            {
-                stmt = make_statement<Extern>(node->children.front()->string());
-            }
+                    catches.emplace_back(std::move(c));
+                }
+            );
 
-            // Throw statement: `throw bad();`
-            else if (node->is<gr::throw_statement>())
+            if (has_finally)
             {
-                stmt = make_statement<Throw>(
-                    std::move(create_expression_node(node->children.front().get()))
-                );
-            }
+                auto fst = create_statement_node(last_child.get());
+                auto finally_part = util::unique_ptr_downcast<Statement, Finally>(fst);
 
-            // Finally statement: `finally { do foo; }`
-            else if (node->is<gr::finally_statement>())
-            {
-                stmt = make_statement<Finally>(
-                    std::move(create_statement_node(node->children.front().get()))
+                return make_statement<Try>(
+                    std::move(try_part),
+                    catches,
+                    std::move(finally_part)
                 );
             }
-
-            // Catch statement: `catch { e: Error } { do bar; }`
-            else if (node->is<gr::catch_statement>())
+            else
             {
-                stmt = make_statement<Catch>(
-                    std::move(create_typepair_node(node->children.at(0).get())),
-                    std::move(create_statement_node(node->children.at(1).get()))
-                );
+                return make_statement<Try>(std::move(try_part), catches);
             }
+        }
 
-            // Try statement: `try { do x; }...`
-            else if (node->is<gr::try_statement>())
-            {
-                child_vector<Catch> catches;
-
-                auto& ch = node->children;
-                auto& last_child = node->children.back();
-                auto has_finally = last_child->is<gr::finally_statement>();
-
-                auto try_part = create_statement_node(ch.front().get());
+        // Concept definitions: `concept C <T> = ...`
+        template <>
+        statement_ptr build_statement<gr::concept_definition>(parser_node* node)
+        {
+            return create_concept_definition(node);
+        }
 
-                std::for_each(ch.begin()+1, ch.end()-(has_finally ? 1 : 0),
-                    [&](std::unique_ptr<parser_node>& el)
-                    {
-                        auto ptr = create_statement_node(el.get());
-                        auto c = util::unique_ptr_downcast<Statement, Catch>(ptr);
+        // Module declaration: `module foo;`
+        template <>
+        statement_ptr build_statement<gr::module_statement>(parser_node* node)
+        {
+            // Delegate to the module name builder.
+            auto mname = create_module_name(node->children.front().get());
 
-                        catches.emplace_back(std::move(c));
-                    }
-                );
+            return make_statement<ModuleDef>(std::move(mname));
+        }
 
-                if (has_finally)
-                {
-                    auto fst = create_statement_node(last_child.get());
-                    auto finally_part = util::unique_ptr_downcast<Statement, Finally>(fst);
+        // Use declaration: `use foo;`
+        template <>
+        statement_ptr build_statement<gr::use_statement>(parser_node* node)
+        {
+            // Delegate to the module name builder.
+            auto mname = create_module_name(node->children.front().get());
 
-                    stmt = make_statement<Try>(
-                        std::move(try_part),
-                        catches,
-                        std::move(finally_part)
-                    );
-                }
-                else
-                {
-                    stmt = make_statement<Try>(std::move(try_part), catches);
-                }
-            }
+            return make_statement<Use>(std::move(mname));
+        }
 
-            // Concept definitions: `concept C <T> = ...`
-            else if (node->is<gr::concept_definition>())
-            {
-                stmt = std::move(create_concept_definition(node));
-            }
+        // Import declaration: `import { foo } from bar;`
+        template <>
+        statement_ptr build_statement<gr::import_statement>(parser_node* node)
+        {
+            auto mname = create_module_name(node->children.at(1).get());
 
-            // Module declaration: `module foo;`
-            else if (node->is<gr::module_statement>())
-            {
-                // Delegate to the module name builder.
-                auto mname = create_module_name(node->children.front().get());
+            child_vector<Identifier> import_list;
+            auto& ch = node->children.at(0)->children;
+            std::for_each(ch.begin(), ch.end(), 
+                [&](std::unique_ptr<parser_node>& el)
+                { import_list.emplace_back(std::make_unique<Identifier>(el->string())); }
+            );
 
-                stmt = make_statement<ModuleDef>(std::move(mname));
-            }
+            return make_statement<Import>(import_list, std::move(mname));
+        }
 
-            // Use declaration: `use foo;`
-            else if (node->is<gr::use_statement>())
-            {
-                // Delegate to the module name builder.
-                auto mname = create_module_name(node->children.front().get());
+        // Export declaration: `export { foo, bar };`
+        template <>
+        statement_ptr build_statement<gr::export_statement>(parser_node* node)
+        {
+            child_vector<Identifier> export_list;
+            auto& ch = node->children.front()->children;
+            std::for_each(ch.begin(), ch.end(), 
+                [&](std::unique_ptr<parser_node>& el)
+                { export_list.emplace_back(std::make_unique<Identifier>(el->string())); }
+            );
 
-                stmt = make_statement<Use>(std::move(mname));
-            }
+            return make_statement<Export>(export_list);
+        }
 
-            // Import declaration: `import { foo } from bar;`
-            else if (node->is<gr::import_statement>())
-            {
-                auto mname = create_module_name(node->children.at(1).get());
+        using expression_builder_fn = expression_ptr (*)(parser_node*);
+        using statement_builder_fn = statement_ptr (*)(parser_node*);
 
-                child_vector<Identifier> import_list;
-                auto& ch = node->children.at(0)->children;
-                std::for_each(ch.begin(), ch.end(), 
-                    [&](std::unique_ptr<parser_node>& el)
-                    { import_list.emplace_back(std::make_unique<Identifier>(el->string())); }
-                );
+        // Dispatch tables, one entry per rule ID plus a last one for unknown
+        // rules. These are made of constant function addresses, so they're
+        // laid out at compile time, not on first use.
+        template <typename... Rules>
+        const expression_builder_fn* expression_builders(rule_list<Rules...>)
+        {
+            static const expression_builder_fn table[] = {
+                &build_expression<Rules>...,
+                &build_expression<void>
+            };
+            static_assert(sizeof(table) / sizeof(table[0]) == rule_id_count + 1,
+                "expression table doesn't match rule IDs");
+
+            return table;
+        }
 
-                stmt = make_statement<Import>(import_list, std::move(mname));
-            }
+        template <typename... Rules>
+        const statement_builder_fn* statement_builders(rule_list<Rules...>)
+        {
+            static const statement_builder_fn table[] = {
+                &build_statement<Rules>...,
+                &build_statement<void>
+            };
+            static_assert(sizeof(table) / sizeof(table[0]) == rule_id_count + 1,
+                "statement table doesn't match rule IDs");
+
+            return table;
+        }
 
-            // Export declaration: `export { foo, bar };`
-            else if (node->is<gr::export_statement>())
-            {
-                child_vector<Identifier> export_list;
-                auto& ch = node->children.front()->children;
-                std::for_each(ch.begin(), ch.end(), 
-                    [&](std::unique_ptr<parser_node>& el)
-                    { export_list.emplace_back(std::make_unique<Identifier>(el->string())); }
-                );
+        // Builder for expressions.
+        expression_ptr create_expression_node(parser_node* node)
+        {
+            assert(node->rule <= unknown_rule_id);
+            auto expr = expression_builders(builder_rules{})[node->rule](node);
 
-                stmt = make_statement<Export>(export_list);
-            }
+            // We should have a non-null expression node by now, because every
+            // rule not handled should throw.
+            assert(expr != nullptr);
+            expr->position = location_of(node);
+            return expr;
+        }
 
-            else
-            {
-                throw unimplemented_type(node->name());
-            }
+        // Builder for statements.
+        statement_ptr create_statement_node(parser_node* node)
+        {
+            assert(node->rule <= unknown_rule_id);
+            auto stmt = statement_builders(builder_rules{})[node->rule](node);
 
             // We should have a non-null statement node by now, because every rule
             // not handled should throw.
             assert(stmt != nullptr);
-            stmt->position = node->begin();
+            stmt->position = location_of(node);
             return stmt;
         }
 
@@ -1529,13 +1717,27 @@ namespace rhea { namespace ast {
                 ast_node = std::make_unique<Program>(stmts);
             }
 
+            else if (node->is<gr::module_definition>())
+            {
+                // The first child is always the module statement, which the
+                // statement builder already turns into a ModuleDef.
+                std::vector<statement_ptr> stmts;
+                auto& ch = node->children;
+                std::for_each(ch.begin(), ch.end(), 
+                    [&](std::unique_ptr<parser_node>& el)
+                    { stmts.emplace_back(std::move(create_statement_node(el.get()))); }
+                );
+
+                ast_node = std::make_unique<Module>(stmts);
+            }
+
             else
             {
                 throw unimplemented_type(node->name());
             }
 
             assert(ast_node != nullptr);
-            ast_node->position = node->begin();
+            ast_node->position = location_of(node);
             return ast_node;
         }
     }
@@ -1549,7 +1751,6 @@ namespace rhea { namespace ast {
         // Since our grammar guarantees that we only ever have a single root, we
         // don't really need that, and we can just build our AST from the PEGTL root's
         // only child.
-        // TODO: We have to determine whether we're dealing with a module or program.
 
         auto& top = node->children.back();
 
@@ -1562,4 +1763,11 @@ namespace rhea { namespace ast {
             return internal::create_statement_node(top.get());
         }
     }
+
+    // Build an AST with all its nodes allocated from an arena.
+    std::unique_ptr<ASTNode> build_ast(parser_node* node, Arena& arena)
+    {
+        ArenaScope scope { arena };
+        return build_ast(node);
+    }
 }}
\ No newline at end of file
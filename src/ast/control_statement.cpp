@@ -41,6 +41,25 @@ namespace rhea { namespace ast {
         std::move(cs.begin(), cs.end(), std::back_inserter(cases));
     }
 
+    On::On(expression_ptr c, statement_ptr b)
+        : body(std::move(b))
+    {
+        case_values.push_back(std::move(c));
+    }
+
+    On::On(child_vector<Expression>& cs, statement_ptr b)
+        : body(std::move(b))
+    {
+        std::move(cs.begin(), cs.end(), std::back_inserter(case_values));
+    }
+
+    std::string On::to_string()
+    {
+        return fmt::format("(On{0},{1})",
+            util::serialize_array(case_values),
+            body->to_string());
+    }
+
     std::string Match::to_string()
     {
         // The usual vector printing, plus the matching expression.
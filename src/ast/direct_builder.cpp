@@ -0,0 +1,1198 @@
+#include "ast/direct_builder.hpp"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cassert>
+
+#include "ast/internal/builder.hpp"
+#include "ast/selector.hpp"
+#include "grammar.hpp"
+#include "source/source_manager.hpp"
+#include "util/downcast.hpp"
+
+/*
+ * The direct builder works a lot like a shift-reduce parser bolted onto
+ * PEGTL's recursive descent. Every rule that starts matching records how
+ * deep the build stack was at that point. If the rule fails, everything
+ * built since is thrown away, which takes care of backtracking. If it
+ * succeeds, the rule's "action" gets to reduce the items built by its
+ * subrules (the equivalent of a parse node's children) into whatever it
+ * represents: usually one finished AST node.
+ *
+ * Rules that the parse tree selector doesn't keep are transparent, just
+ * like in the parse tree: their subrules' items stay on the stack for the
+ * next rule up. Rules it *does* keep, but which don't have an action here,
+ * raise unimplemented_type, so we never quietly build a wrong tree.
+ *
+ * The actions mirror the transforms in ast/transform/ and the node
+ * creation code in builder.cpp, so both builders produce the same AST.
+ */
+namespace rhea { namespace ast {
+    namespace {
+        namespace gr = rhea::grammar;
+        namespace pegtl = tao::pegtl;
+
+        using iterator_type = pegtl::internal::iterator;
+
+        // What a build stack entry holds.
+        enum class item_kind
+        {
+            Expression,
+            Statement,
+            Typename,
+            Node,               // other AST nodes, like named arguments
+            Text,               // matched text needed by a parent, like a literal suffix
+            BinaryOperator,
+            UnaryOperator,
+            CastOperator,
+            TypeCheckOperator,
+            Subscript,          // postfix operators still waiting for their operand
+            Member,
+            Call,
+            NamedCall,
+            Arguments,          // argument lists, before they're attached to a call
+            NamedArguments,
+            GenericPart,        // pieces of a complex typename
+            ArrayPart
+        };
+
+        struct build_item
+        {
+            build_item(item_kind k, const iterator_type& b, const char* e, int o = 0)
+                : kind(k), begin(b), end(e), op(o) {}
+
+            item_kind kind;
+
+            // The extent of the match that created this item.
+            iterator_type begin;
+            const char* end;
+
+            // Operator enum value, for operator tokens, or the function type
+            // of a call.
+            int op;
+
+            // The finished node, if there is one.
+            node_ptr node;
+
+            // Children that haven't found their parent yet.
+            child_vector<ASTNode> group;
+
+            std::string text() const { return std::string(begin.data, end); }
+        };
+
+        struct stack_marker
+        {
+            std::size_t size;
+            iterator_type begin;
+        };
+
+        struct build_state
+        {
+            build_state(const char* b) : buffer(b) {}
+
+            std::vector<build_item> stack;
+            std::vector<stack_marker> markers;
+
+            // Start of the input, as registered with the source manager.
+            const char* buffer;
+        };
+
+        // View of the items built while matching a single rule.
+        class match_context
+        {
+            public:
+            match_context(build_state& s, std::size_t f, const iterator_type& b, const char* e)
+                : state(s), first(f), begin(b), end(e) {}
+
+            std::size_t size() const { return state.stack.size() - first; }
+            build_item& operator[](std::size_t i) { return state.stack[first + i]; }
+
+            std::string text() const { return std::string(begin.data, end); }
+
+            source::SourceLocation position() const { return position(begin); }
+            source::SourceLocation position(const iterator_type& it) const
+                { return source::SourceManager::global().location(state.buffer, it.byte); }
+
+            // Remove everything this rule built.
+            void discard()
+            {
+                state.stack.erase(state.stack.begin() + first, state.stack.end());
+            }
+
+            // Replace this rule's items with a new one.
+            void replace(build_item item)
+            {
+                discard();
+                state.stack.push_back(std::move(item));
+            }
+
+            // Replace this rule's items with a finished node.
+            template <typename T>
+            void replace(item_kind kind, std::unique_ptr<T> node)
+            {
+                build_item item { kind, begin, end };
+                item.node = std::move(node);
+                replace(std::move(item));
+            }
+
+            build_state& state;
+            const std::size_t first;
+            const iterator_type begin;
+            const char* const end;
+        };
+
+        ////
+        // Helpers to take finished nodes off the stack
+        ////
+
+        expression_ptr take_expression(build_item& item)
+        {
+            if (item.kind != item_kind::Expression)
+            {
+                throw syntax_error("Expected an expression");
+            }
+
+            return util::unique_ptr_downcast<ASTNode, Expression>(item.node);
+        }
+
+        statement_ptr take_statement(build_item& item)
+        {
+            if (item.kind != item_kind::Statement)
+            {
+                throw syntax_error("Expected a statement");
+            }
+
+            return util::unique_ptr_downcast<ASTNode, Statement>(item.node);
+        }
+
+        // Simple identifiers, for names that can't be qualified.
+        std::unique_ptr<Identifier> take_identifier(build_item& item)
+        {
+            if (item.kind != item_kind::Expression || dynamic_cast<Identifier*>(item.node.get()) == nullptr)
+            {
+                throw syntax_error("Expected an identifier");
+            }
+
+            return util::unique_ptr_downcast<ASTNode, Identifier>(item.node);
+        }
+
+        std::unique_ptr<AnyIdentifier> take_any_identifier(build_item& item)
+        {
+            if (item.kind != item_kind::Expression || dynamic_cast<AnyIdentifier*>(item.node.get()) == nullptr)
+            {
+                throw syntax_error("Expected an identifier");
+            }
+
+            return util::unique_ptr_downcast<ASTNode, AnyIdentifier>(item.node);
+        }
+
+        // Typenames, including the simple ones that are only identifiers.
+        std::unique_ptr<Typename> take_typename(build_item& item)
+        {
+            if (item.kind == item_kind::Typename)
+            {
+                return util::unique_ptr_downcast<ASTNode, Typename>(item.node);
+            }
+
+            auto ident = take_any_identifier(item);
+            auto position = ident->position;
+            auto tname = std::make_unique<Typename>(std::move(ident));
+            tname->position = position;
+            return tname;
+        }
+
+        template <typename T>
+        child_vector<T> take_group(build_item& item)
+        {
+            child_vector<T> result;
+            result.reserve(item.group.size());
+
+            for (auto& n : item.group)
+            {
+                result.emplace_back(util::unique_ptr_downcast<ASTNode, T>(n));
+            }
+
+            return result;
+        }
+
+        AssignOperator assignment_operator_type(int op)
+        {
+            switch (static_cast<BinaryOperators>(op))
+            {
+                case BinaryOperators::Add: return AssignOperator::Add;
+                case BinaryOperators::Subtract: return AssignOperator::Subtract;
+                case BinaryOperators::Multiply: return AssignOperator::Multiply;
+                case BinaryOperators::Divide: return AssignOperator::Divide;
+                case BinaryOperators::Modulus: return AssignOperator::Modulus;
+                case BinaryOperators::Exponent: return AssignOperator::Exponent;
+                case BinaryOperators::LeftShift: return AssignOperator::LeftShift;
+                case BinaryOperators::RightShift: return AssignOperator::RightShift;
+                case BinaryOperators::BitAnd: return AssignOperator::BitAnd;
+                case BinaryOperators::BitOr: return AssignOperator::BitOr;
+                case BinaryOperators::BitXor: return AssignOperator::BitXor;
+                default:
+                    throw unimplemented_type("Invalid compound assignment operator");
+            }
+        }
+
+        ////
+        // Actions
+        ////
+
+        // The default: rules the parse tree doesn't keep are transparent,
+        // and anything it keeps that we can't build is an error.
+        template <typename Rule, bool Selected = tree_selector<Rule>::value>
+        struct direct_action
+        {
+            static void reduce(match_context&) {}
+        };
+
+        template <typename Rule>
+        struct direct_action<Rule, true>
+        {
+            static void reduce(match_context&)
+            {
+                throw unimplemented_type(pegtl::internal::demangle<Rule>());
+            }
+        };
+
+        // For rules the parse tree only uses to fold or group children.
+        struct passthrough_action
+        {
+            static void reduce(match_context&) {}
+        };
+
+        // Equivalent of discard_subtree: lookahead rules throw away whatever
+        // was built while looking ahead.
+        struct discard_action
+        {
+            static void reduce(match_context& ctx) { ctx.discard(); }
+        };
+
+        // Text that a parent rule needs, but which isn't a node by itself.
+        struct text_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                ctx.replace(build_item { item_kind::Text, ctx.begin, ctx.end });
+            }
+        };
+
+        template <BinaryOperators Op>
+        struct binary_token_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                ctx.replace(build_item { item_kind::BinaryOperator, ctx.begin, ctx.end, static_cast<int>(Op) });
+            }
+        };
+
+        template <UnaryOperators Op>
+        struct unary_token_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                ctx.replace(build_item { item_kind::UnaryOperator, ctx.begin, ctx.end, static_cast<int>(Op) });
+            }
+        };
+
+        template <item_kind Kind>
+        struct token_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                ctx.replace(build_item { Kind, ctx.begin, ctx.end });
+            }
+        };
+
+        // Identifiers
+
+        struct identifier_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto ident = std::make_unique<Identifier>(ctx.text());
+                ident->position = ctx.position();
+                ctx.replace(item_kind::Expression, std::move(ident));
+            }
+        };
+
+        struct fully_qualified_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                // A single identifier folds, as in the parse tree.
+                if (ctx.size() == 1)
+                {
+                    return;
+                }
+
+                std::vector<std::string> parts;
+                for (std::size_t i = 0; i < ctx.size(); ++i)
+                {
+                    parts.emplace_back(ctx[i].text());
+                }
+
+                auto ident = std::make_unique<FullyQualified>(parts);
+                ident->position = ctx.position();
+                ctx.replace(item_kind::Expression, std::move(ident));
+            }
+        };
+
+        struct relative_identifier_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto& child = ctx[0].node;
+                std::unique_ptr<AnyIdentifier> ident;
+
+                if (dynamic_cast<Identifier*>(child.get()) != nullptr)
+                {
+                    ident = std::make_unique<RelativeIdentifier>(
+                        util::unique_ptr_downcast<ASTNode, Identifier>(child)
+                    );
+                }
+                else if (dynamic_cast<FullyQualified*>(child.get()) != nullptr)
+                {
+                    ident = std::make_unique<RelativeIdentifier>(
+                        util::unique_ptr_downcast<ASTNode, FullyQualified>(child)
+                    );
+                }
+                else
+                {
+                    throw unimplemented_type("relative_identifier");
+                }
+
+                ident->position = ctx.position();
+                ctx.replace(item_kind::Expression, std::move(ident));
+            }
+        };
+
+        // Literals
+
+        struct integer_literal_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto expr = internal::create_integer_literal(
+                    ctx[0].text(),
+                    ctx.size() > 1 ? ctx[1].text() : ""
+                );
+                expr->position = ctx.position();
+                ctx.replace(item_kind::Expression, std::move(expr));
+            }
+        };
+
+        struct float_literal_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto expr = internal::create_float_literal(ctx[0].text(), ctx.size() > 1);
+                expr->position = ctx.position();
+                ctx.replace(item_kind::Expression, std::move(expr));
+            }
+        };
+
+        struct hex_literal_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto expr = internal::create_hex_literal(ctx.text());
+                expr->position = ctx.position();
+                ctx.replace(item_kind::Expression, std::move(expr));
+            }
+        };
+
+        struct boolean_literal_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto expr = make_expression<Boolean>(ctx.text() == "true");
+                expr->position = ctx.position();
+                ctx.replace(item_kind::Expression, std::move(expr));
+            }
+        };
+
+        struct nothing_literal_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto expr = make_expression<Nothing>();
+                expr->position = ctx.position();
+                ctx.replace(item_kind::Expression, std::move(expr));
+            }
+        };
+
+        struct string_literal_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto expr = make_expression<String>(ctx[0].text());
+                expr->position = ctx.position();
+                ctx.replace(item_kind::Expression, std::move(expr));
+            }
+        };
+
+        struct symbol_name_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto expr = make_expression<Symbol>(ctx[0].text());
+                expr->position = ctx.position();
+                ctx.replace(item_kind::Expression, std::move(expr));
+            }
+        };
+
+        // Operators
+
+        // Equivalent of binop_rearrange. The items alternate between operands
+        // and operators, and we fold them from the left.
+        struct binop_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                if (ctx.size() == 1)
+                {
+                    return;
+                }
+
+                auto result = take_expression(ctx[0]);
+                for (std::size_t i = 1; i + 1 < ctx.size(); i += 2)
+                {
+                    auto& op = ctx[i];
+                    result = make_expression<BinaryOp>(
+                        static_cast<BinaryOperators>(op.op),
+                        std::move(result),
+                        take_expression(ctx[i+1])
+                    );
+                    result->position = ctx.position(op.begin);
+                }
+
+                ctx.replace(item_kind::Expression, std::move(result));
+            }
+        };
+
+        // Equivalent of unary_rearrange.
+        struct unary_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                if (ctx.size() == 1)
+                {
+                    return;
+                }
+
+                auto& op = ctx[0];
+                if (op.kind != item_kind::UnaryOperator)
+                {
+                    throw unimplemented_type("Unknown unary operator");
+                }
+
+                auto expr = make_expression<UnaryOp>(
+                    static_cast<UnaryOperators>(op.op),
+                    take_expression(ctx[1])
+                );
+                expr->position = ctx.position(op.begin);
+                ctx.replace(item_kind::Expression, std::move(expr));
+            }
+        };
+
+        // Equivalent of typecheck_rearrange.
+        struct typecheck_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                if (ctx.size() == 1)
+                {
+                    return;
+                }
+
+                auto& op = ctx[1];
+                auto lhs = take_expression(ctx[0]);
+                auto rhs = take_typename(ctx[2]);
+                expression_ptr expr;
+
+                if (op.kind == item_kind::CastOperator)
+                {
+                    expr = make_expression<Cast>(std::move(lhs), std::move(rhs));
+                }
+                else
+                {
+                    expr = make_expression<TypeCheck>(std::move(lhs), std::move(rhs));
+                }
+
+                expr->position = ctx.position(op.begin);
+                ctx.replace(item_kind::Expression, std::move(expr));
+            }
+        };
+
+        // Equivalent of ternary_transform.
+        struct ternary_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                if (ctx.size() == 1)
+                {
+                    return;
+                }
+
+                auto expr = make_expression<TernaryOp>(
+                    take_expression(ctx[0]),
+                    take_expression(ctx[1]),
+                    take_expression(ctx[2])
+                );
+                expr->position = ctx.position();
+                ctx.replace(item_kind::Expression, std::move(expr));
+            }
+        };
+
+        // Equivalent of postfix_rearrange. Each postfix operator becomes the
+        // parent of everything before it.
+        struct postfix_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                if (ctx.size() == 1)
+                {
+                    return;
+                }
+
+                auto result = take_expression(ctx[0]);
+                for (std::size_t i = 1; i < ctx.size(); ++i)
+                {
+                    auto& pf = ctx[i];
+
+                    switch (pf.kind)
+                    {
+                        case item_kind::Subscript:
+                        {
+                            auto index = util::unique_ptr_downcast<ASTNode, Expression>(pf.group.front());
+                            result = make_expression<Subscript>(std::move(result), std::move(index));
+                            break;
+                        }
+                        case item_kind::Member:
+                        {
+                            auto member = util::unique_ptr_downcast<ASTNode, Identifier>(pf.group.front());
+                            result = make_expression<Member>(std::move(member), std::move(result));
+                            break;
+                        }
+                        case item_kind::Call:
+                        {
+                            std::unique_ptr<Call> call;
+                            if (pf.group.empty())
+                            {
+                                call = std::make_unique<Call>(std::move(result));
+                            }
+                            else
+                            {
+                                auto args = take_group<Expression>(pf);
+                                call = std::make_unique<Call>(std::move(result), args);
+                            }
+                            call->type = static_cast<FunctionType>(pf.op);
+                            result = std::move(call);
+                            break;
+                        }
+                        case item_kind::NamedCall:
+                        {
+                            auto args = take_group<NamedArgument>(pf);
+                            auto call = std::make_unique<Call>(std::move(result), args);
+                            call->type = static_cast<FunctionType>(pf.op);
+                            result = std::move(call);
+                            break;
+                        }
+                        default:
+                            throw unimplemented_type("Unknown postfix operator");
+                    }
+
+                    result->position = ctx.position(pf.begin);
+                }
+
+                ctx.replace(item_kind::Expression, std::move(result));
+            }
+        };
+
+        // Postfix operators and argument lists only gather their children
+        // here; the postfix action puts them together.
+        template <item_kind Kind>
+        struct group_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                build_item item { Kind, ctx.begin, ctx.end };
+                for (std::size_t i = 0; i < ctx.size(); ++i)
+                {
+                    item.group.emplace_back(std::move(ctx[i].node));
+                }
+
+                ctx.replace(std::move(item));
+            }
+        };
+
+        struct function_call_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto& args = ctx[0];
+                auto kind = args.kind == item_kind::NamedArguments
+                    ? item_kind::NamedCall
+                    : item_kind::Call;
+
+                // The suffix, if any, is left as text after the arguments.
+                auto type = ctx.size() > 1
+                    ? internal::function_type_for_suffix(ctx[1].text())
+                    : FunctionType::Basic;
+
+                build_item item { kind, ctx.begin, ctx.end, static_cast<int>(type) };
+                item.group = std::move(args.group);
+                ctx.replace(std::move(item));
+            }
+        };
+
+        struct named_argument_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto name = take_identifier(ctx[0]);
+                auto arg = std::make_unique<NamedArgument>(name->name.str(), take_expression(ctx[1]));
+                arg->position = ctx.position();
+                ctx.replace(item_kind::Node, std::move(arg));
+            }
+        };
+
+        // Containers
+
+        template <typename Container>
+        struct container_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                child_vector<Expression> exs;
+                for (std::size_t i = 0; i < ctx.size(); ++i)
+                {
+                    exs.emplace_back(take_expression(ctx[i]));
+                }
+
+                auto expr = make_expression<Container>(exs);
+                expr->position = ctx.position();
+                ctx.replace(item_kind::Expression, std::move(expr));
+            }
+        };
+
+        struct symbol_list_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                std::vector<std::string> syms;
+                for (std::size_t i = 0; i < ctx.size(); ++i)
+                {
+                    syms.push_back(ctx[i].text());
+                }
+
+                auto expr = make_expression<SymbolList>(syms);
+                expr->position = ctx.position();
+                ctx.replace(item_kind::Expression, std::move(expr));
+            }
+        };
+
+        struct dictionary_entry_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto entry = std::make_unique<DictionaryEntry>(
+                    internal::create_dictionary_key(take_expression(ctx[0])),
+                    take_expression(ctx[1])
+                );
+                entry->position = ctx.position();
+                ctx.replace(item_kind::Node, std::move(entry));
+            }
+        };
+
+        struct dictionary_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                child_vector<DictionaryEntry> entries;
+                for (std::size_t i = 0; i < ctx.size(); ++i)
+                {
+                    entries.emplace_back(util::unique_ptr_downcast<ASTNode, DictionaryEntry>(ctx[i].node));
+                }
+
+                auto expr = make_expression<Dictionary>(entries);
+                expr->position = ctx.position();
+                ctx.replace(item_kind::Expression, std::move(expr));
+            }
+        };
+
+        // Typenames
+
+        struct generic_type_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                build_item item { item_kind::GenericPart, ctx.begin, ctx.end };
+                for (std::size_t i = 0; i < ctx.size(); ++i)
+                {
+                    item.group.emplace_back(take_typename(ctx[i]));
+                }
+
+                ctx.replace(std::move(item));
+            }
+        };
+
+        struct complex_type_name_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto base_type = take_any_identifier(ctx[0]);
+
+                std::unique_ptr<GenericTypename> generic_part = nullptr;
+                child_vector<Expression> aparts;
+
+                for (std::size_t i = 1; i < ctx.size(); ++i)
+                {
+                    auto& part = ctx[i];
+
+                    if (part.kind == item_kind::GenericPart)
+                    {
+                        auto gparts = take_group<Typename>(part);
+                        generic_part = std::make_unique<GenericTypename>(gparts);
+                    }
+                    else
+                    {
+                        assert(part.kind == item_kind::ArrayPart);
+                        aparts.emplace_back(util::unique_ptr_downcast<ASTNode, Expression>(part.group.front()));
+                    }
+                }
+
+                std::unique_ptr<ArrayTypename> array_part = nullptr;
+                if (!aparts.empty())
+                {
+                    array_part = std::make_unique<ArrayTypename>(aparts);
+                }
+
+                auto tname = std::make_unique<Typename>(
+                    std::move(base_type),
+                    std::move(generic_part),
+                    std::move(array_part)
+                );
+                tname->position = ctx.position();
+                ctx.replace(item_kind::Typename, std::move(tname));
+            }
+        };
+
+        struct optional_type_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto tname = std::make_unique<Optional>(take_typename(ctx[0]));
+                tname->position = ctx.position();
+                ctx.replace(item_kind::Typename, std::move(tname));
+            }
+        };
+
+        struct variant_type_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                child_vector<Typename> vtypes;
+                for (std::size_t i = 0; i < ctx.size(); ++i)
+                {
+                    vtypes.emplace_back(take_typename(ctx[i]));
+                }
+
+                auto tname = std::make_unique<Variant>(vtypes);
+                tname->position = ctx.position();
+                ctx.replace(item_kind::Typename, std::move(tname));
+            }
+        };
+
+        // Statements
+
+        struct bare_expression_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto stmt = make_statement<BareExpression>(take_expression(ctx[0]));
+                stmt->position = ctx.position();
+                ctx.replace(item_kind::Statement, std::move(stmt));
+            }
+        };
+
+        struct statement_block_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                child_vector<Statement> stmts;
+                for (std::size_t i = 0; i < ctx.size(); ++i)
+                {
+                    stmts.emplace_back(take_statement(ctx[i]));
+                }
+
+                auto stmt = make_statement<Block>(stmts);
+                stmt->position = ctx.position();
+                ctx.replace(item_kind::Statement, std::move(stmt));
+            }
+        };
+
+        // The top level of a file. Modules need their module statement,
+        // which isn't covered yet, so they go to the two-phase builder.
+        struct program_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                child_vector<Statement> stmts;
+                for (std::size_t i = 0; i < ctx.size(); ++i)
+                {
+                    stmts.emplace_back(take_statement(ctx[i]));
+                }
+
+                auto program = std::make_unique<Program>(stmts);
+                program->position = ctx.position();
+                ctx.replace(item_kind::Node, std::move(program));
+            }
+        };
+
+        // Shared by variable and constant definitions.
+        template <typename Stmt>
+        struct definition_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                // A variable declared with a type has already been built.
+                if (ctx.size() == 1)
+                {
+                    return;
+                }
+
+                auto stmt = make_statement<Stmt>(take_identifier(ctx[0]), take_expression(ctx[1]));
+                stmt->position = ctx.position();
+                ctx.replace(item_kind::Statement, std::move(stmt));
+            }
+        };
+
+        struct declaration_as_type_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto stmt = make_statement<TypeDeclaration>(take_identifier(ctx[0]), take_typename(ctx[1]));
+                stmt->position = ctx.position();
+                ctx.replace(item_kind::Statement, std::move(stmt));
+            }
+        };
+
+        struct assignment_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto stmt = make_statement<Assign>(take_expression(ctx[0]), take_expression(ctx[1]));
+                stmt->position = ctx.position();
+                ctx.replace(item_kind::Statement, std::move(stmt));
+            }
+        };
+
+        struct compound_assignment_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto stmt = make_statement<CompoundAssign>(
+                    take_expression(ctx[0]),
+                    assignment_operator_type(ctx[1].op),
+                    take_expression(ctx[2])
+                );
+                stmt->position = ctx.position();
+                ctx.replace(item_kind::Statement, std::move(stmt));
+            }
+        };
+
+        struct if_statement_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto stmt = make_statement<If>(
+                    take_expression(ctx[0]),
+                    take_statement(ctx[1]),
+                    ctx.size() > 2 ? take_statement(ctx[2]) : nullptr
+                );
+                stmt->position = ctx.position();
+                ctx.replace(item_kind::Statement, std::move(stmt));
+            }
+        };
+
+        struct unless_statement_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                // As in the regular builder, an "unless" is an If with no "then" part.
+                auto stmt = make_statement<If>(
+                    take_expression(ctx[0]),
+                    nullptr,
+                    take_statement(ctx[1])
+                );
+                stmt->position = ctx.position();
+                ctx.replace(item_kind::Statement, std::move(stmt));
+            }
+        };
+
+        struct while_statement_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto stmt = make_statement<While>(take_expression(ctx[0]), take_statement(ctx[1]));
+                stmt->position = ctx.position();
+                ctx.replace(item_kind::Statement, std::move(stmt));
+            }
+        };
+
+        struct do_statement_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto stmt = make_statement<Do>(take_expression(ctx[0]));
+                stmt->position = ctx.position();
+                ctx.replace(item_kind::Statement, std::move(stmt));
+            }
+        };
+
+        template <typename Stmt>
+        struct empty_statement_action
+        {
+            static void reduce(match_context& ctx)
+            {
+                auto stmt = make_statement<Stmt>();
+                stmt->position = ctx.position();
+                ctx.replace(item_kind::Statement, std::move(stmt));
+            }
+        };
+    }
+
+    ////
+    // Rule to action mapping
+    ////
+
+    namespace {
+        // Grouping and folding rules
+        template <> struct direct_action<gr::numeric_literal> : passthrough_action {};
+        template <> struct direct_action<gr::any_identifier> : passthrough_action {};
+        template <> struct direct_action<gr::postfix_expr> : passthrough_action {};
+        template <> struct direct_action<gr::type_name> : passthrough_action {};
+        template <> struct direct_action<gr::simple_type_name> : passthrough_action {};
+        template <> struct direct_action<gr::either_type_name> : passthrough_action {};
+        template <> struct direct_action<gr::tagged_union> : passthrough_action {};
+        template <> struct direct_action<gr::constant_expression> : passthrough_action {};
+        template <> struct direct_action<gr::assignment_rhs> : passthrough_action {};
+        template <> struct direct_action<gr::augment_operators> : passthrough_action {};
+        template <> struct direct_action<gr::statement> : passthrough_action {};
+        template <> struct direct_action<gr::stmt_or_block> : passthrough_action {};
+        template <> struct direct_action<gr::else_block> : passthrough_action {};
+
+        // Lookahead and syntax-only rules
+        template <> struct direct_action<gr::complex_type_lookahead> : discard_action {};
+        template <> struct direct_action<gr::type_declaration_operator> : discard_action {};
+
+        // Tokens
+        template <> struct direct_action<gr::signed_integer> : text_action {};
+        template <> struct direct_action<gr::function_suffix> : text_action {};
+        template <> struct direct_action<gr::integer_literal_suffix> : text_action {};
+        template <> struct direct_action<gr::floating_point_number> : text_action {};
+        template <> struct direct_action<gr::float_literal_suffix> : text_action {};
+        template <> struct direct_action<gr::character_string<'\''>> : text_action {};
+        template <> struct direct_action<gr::character_string<'"'>> : text_action {};
+
+        template <> struct direct_action<gr::add_operator> : binary_token_action<BinaryOperators::Add> {};
+        template <> struct direct_action<gr::subtract_operator> : binary_token_action<BinaryOperators::Subtract> {};
+        template <> struct direct_action<gr::multiply_operator> : binary_token_action<BinaryOperators::Multiply> {};
+        template <> struct direct_action<gr::divide_operator> : binary_token_action<BinaryOperators::Divide> {};
+        template <> struct direct_action<gr::modulus_operator> : binary_token_action<BinaryOperators::Modulus> {};
+        template <> struct direct_action<gr::exponent_operator> : binary_token_action<BinaryOperators::Exponent> {};
+        template <> struct direct_action<gr::left_shift_operator> : binary_token_action<BinaryOperators::LeftShift> {};
+        template <> struct direct_action<gr::right_shift_operator> : binary_token_action<BinaryOperators::RightShift> {};
+        template <> struct direct_action<gr::equals_operator> : binary_token_action<BinaryOperators::Equals> {};
+        template <> struct direct_action<gr::not_equal_operator> : binary_token_action<BinaryOperators::NotEqual> {};
+        template <> struct direct_action<gr::less_than_operator> : binary_token_action<BinaryOperators::LessThan> {};
+        template <> struct direct_action<gr::greater_than_operator> : binary_token_action<BinaryOperators::GreaterThan> {};
+        template <> struct direct_action<gr::less_equal_operator> : binary_token_action<BinaryOperators::LessThanOrEqual> {};
+        template <> struct direct_action<gr::greater_equal_operator> : binary_token_action<BinaryOperators::GreaterThanOrEqual> {};
+        template <> struct direct_action<gr::bitand_operator> : binary_token_action<BinaryOperators::BitAnd> {};
+        template <> struct direct_action<gr::bitor_operator> : binary_token_action<BinaryOperators::BitOr> {};
+        template <> struct direct_action<gr::bitxor_operator> : binary_token_action<BinaryOperators::BitXor> {};
+        template <> struct direct_action<gr::kw_and> : binary_token_action<BinaryOperators::BooleanAnd> {};
+        template <> struct direct_action<gr::kw_or> : binary_token_action<BinaryOperators::BooleanOr> {};
+
+        template <> struct direct_action<gr::coerce_operator> : unary_token_action<UnaryOperators::Coerce> {};
+        template <> struct direct_action<gr::bitnot_operator> : unary_token_action<UnaryOperators::BitNot> {};
+        template <> struct direct_action<gr::dereference_operator> : unary_token_action<UnaryOperators::Dereference> {};
+        template <> struct direct_action<gr::unary_plus_operator> : unary_token_action<UnaryOperators::Plus> {};
+        template <> struct direct_action<gr::unary_minus_operator> : unary_token_action<UnaryOperators::Minus> {};
+        template <> struct direct_action<gr::kw_not> : unary_token_action<UnaryOperators::BooleanNot> {};
+        template <> struct direct_action<gr::kw_ref> : unary_token_action<UnaryOperators::Ref> {};
+        template <> struct direct_action<gr::kw_ptr> : unary_token_action<UnaryOperators::Ptr> {};
+
+        template <> struct direct_action<gr::kw_as> : token_action<item_kind::CastOperator> {};
+        template <> struct direct_action<gr::kw_is> : token_action<item_kind::TypeCheckOperator> {};
+
+        // Identifiers and literals
+        template <> struct direct_action<gr::identifier> : identifier_action {};
+        template <> struct direct_action<gr::builtin_types> : identifier_action {};
+        template <> struct direct_action<gr::fully_qualified> : fully_qualified_action {};
+        template <> struct direct_action<gr::relative_identifier> : relative_identifier_action {};
+        template <> struct direct_action<gr::integer_literal> : integer_literal_action {};
+        template <> struct direct_action<gr::float_literal> : float_literal_action {};
+        template <> struct direct_action<gr::hex_literal> : hex_literal_action {};
+        template <> struct direct_action<gr::boolean_literal> : boolean_literal_action {};
+        template <> struct direct_action<gr::nothing_literal> : nothing_literal_action {};
+        template <> struct direct_action<gr::string_literal> : string_literal_action {};
+        template <> struct direct_action<gr::symbol_name> : symbol_name_action {};
+
+        // Expressions
+        template <> struct direct_action<gr::exponential_binop> : binop_action {};
+        template <> struct direct_action<gr::multiplicative_binop> : binop_action {};
+        template <> struct direct_action<gr::additive_binop> : binop_action {};
+        template <> struct direct_action<gr::shift_binop> : binop_action {};
+        template <> struct direct_action<gr::relation_binop> : binop_action {};
+        template <> struct direct_action<gr::bitwise_binop> : binop_action {};
+        template <> struct direct_action<gr::boolean_binop> : binop_action {};
+        template <> struct direct_action<gr::unary_prefix_op> : unary_action {};
+        template <> struct direct_action<gr::boolean_not_op> : unary_action {};
+        template <> struct direct_action<gr::assignment_lhs> : unary_action {};
+        template <> struct direct_action<gr::cast_op> : typecheck_action {};
+        template <> struct direct_action<gr::type_check_op> : typecheck_action {};
+        template <> struct direct_action<gr::ternary_op> : ternary_action {};
+        template <> struct direct_action<gr::postfix_op> : postfix_action {};
+
+        template <> struct direct_action<gr::subscript_expr> : group_action<item_kind::Subscript> {};
+        template <> struct direct_action<gr::member_expr> : group_action<item_kind::Member> {};
+        template <> struct direct_action<gr::function_call_expr> : function_call_action {};
+        template <> struct direct_action<gr::unnamed_argument_list> : group_action<item_kind::Arguments> {};
+        template <> struct direct_action<gr::empty_argument_list> : group_action<item_kind::Arguments> {};
+        template <> struct direct_action<gr::named_argument_list> : group_action<item_kind::NamedArguments> {};
+        template <> struct direct_action<gr::named_argument> : named_argument_action {};
+
+        template <> struct direct_action<gr::array_expression> : container_action<Array> {};
+        template <> struct direct_action<gr::list_expression> : container_action<List> {};
+        template <> struct direct_action<gr::tuple_expression> : container_action<Tuple> {};
+        template <> struct direct_action<gr::symbol_list_expression> : symbol_list_action {};
+        template <> struct direct_action<gr::dictionary_entry> : dictionary_entry_action {};
+        template <> struct direct_action<gr::dictionary_expression> : dictionary_action {};
+
+        // Typenames
+        template <> struct direct_action<gr::generic_type> : generic_type_action {};
+        template <> struct direct_action<gr::array_type> : group_action<item_kind::ArrayPart> {};
+        template <> struct direct_action<gr::complex_type_name> : complex_type_name_action {};
+        template <> struct direct_action<gr::optional_type> : optional_type_action {};
+        template <> struct direct_action<gr::variant_type_list> : variant_type_action {};
+
+        // Statements
+        template <> struct direct_action<gr::bare_expression> : bare_expression_action {};
+        template <> struct direct_action<gr::statement_block> : statement_block_action {};
+        template <> struct direct_action<gr::variable_declaration> : definition_action<Variable> {};
+        template <> struct direct_action<gr::constant_declaration> : definition_action<Constant> {};
+        template <> struct direct_action<gr::declaration_as_type> : declaration_as_type_action {};
+        template <> struct direct_action<gr::assignment> : assignment_action {};
+        template <> struct direct_action<gr::compound_assignment> : compound_assignment_action {};
+        template <> struct direct_action<gr::if_statement> : if_statement_action {};
+        template <> struct direct_action<gr::unless_statement> : unless_statement_action {};
+        template <> struct direct_action<gr::while_statement> : while_statement_action {};
+        template <> struct direct_action<gr::do_statement> : do_statement_action {};
+        template <> struct direct_action<gr::kw_break> : empty_statement_action<Break> {};
+        template <> struct direct_action<gr::kw_continue> : empty_statement_action<Continue> {};
+
+        // Top level
+        template <> struct direct_action<gr::top_level_statement> : passthrough_action {};
+        template <> struct direct_action<gr::program_definition> : program_action {};
+
+        ////
+        // Control
+        ////
+
+        // The control class drives everything. Every rule marks the stack
+        // when it starts, so that a failure anywhere (including inside a
+        // rule we don't otherwise care about) can throw away partial work.
+        template <typename Rule>
+        struct direct_control : pegtl::normal<Rule>
+        {
+            template <typename Input>
+            static void start(const Input& in, build_state& state)
+            {
+                state.markers.push_back(stack_marker { state.stack.size(), in.iterator() });
+            }
+
+            template <typename Input>
+            static void success(const Input& in, build_state& state)
+            {
+                auto m = state.markers.back();
+                state.markers.pop_back();
+
+                match_context ctx { state, m.size, m.begin, in.current() };
+                direct_action<Rule>::reduce(ctx);
+            }
+
+            template <typename Input>
+            static void failure(const Input&, build_state& state)
+            {
+                auto size = state.markers.back().size;
+                state.markers.pop_back();
+
+                state.stack.erase(state.stack.begin() + size, state.stack.end());
+            }
+        };
+
+        // Parse the input, returning the single node that should be left.
+        template <typename Rule, typename Input>
+        node_ptr build_direct(Input& in, item_kind expected)
+        {
+            build_state state { in.current() - in.iterator().byte };
+
+            if (!pegtl::parse<Rule, pegtl::nothing, direct_control>(in, state))
+            {
+                return nullptr;
+            }
+
+            assert(state.markers.empty());
+
+            if (state.stack.size() != 1 || state.stack.back().kind != expected)
+            {
+                throw syntax_error("Direct AST builder did not produce a single node");
+            }
+
+            return std::move(state.stack.back().node);
+        }
+    }
+
+    template <typename Input>
+    expression_ptr build_expression_direct(Input& in)
+    {
+        auto node = build_direct<gr::expression>(in, item_kind::Expression);
+        return util::unique_ptr_downcast<ASTNode, Expression>(node);
+    }
+
+    template <typename Input>
+    statement_ptr build_statement_direct(Input& in)
+    {
+        auto node = build_direct<gr::stmt_or_block>(in, item_kind::Statement);
+        return util::unique_ptr_downcast<ASTNode, Statement>(node);
+    }
+
+    template <typename Input>
+    node_ptr build_program_direct(Input& in)
+    {
+        return build_direct<gr::translation_unit>(in, item_kind::Node);
+    }
+
+    // The inputs we support. Anything else is a link error.
+    template expression_ptr build_expression_direct(tao::pegtl::memory_input<>&);
+    template statement_ptr build_statement_direct(tao::pegtl::memory_input<>&);
+    template node_ptr build_program_direct(tao::pegtl::memory_input<>&);
+
+    template expression_ptr build_expression_direct(tao::pegtl::string_input<>&);
+    template statement_ptr build_statement_direct(tao::pegtl::string_input<>&);
+    template node_ptr build_program_direct(tao::pegtl::string_input<>&);
+
+    template expression_ptr build_expression_direct(tao::pegtl::mmap_input<>&);
+    template statement_ptr build_statement_direct(tao::pegtl::mmap_input<>&);
+    template node_ptr build_program_direct(tao::pegtl::mmap_input<>&);
+
+    template expression_ptr build_expression_direct(file_view_input&);
+    template statement_ptr build_statement_direct(file_view_input&);
+    template node_ptr build_program_direct(file_view_input&);
+}}
@@ -20,6 +20,18 @@ namespace rhea { namespace ast {
         std::move(args.begin(), args.end(), std::back_inserter(arguments));
     }
 
+    types::TypeInfo Call::expression_type()
+    {
+        // Predicates always return a boolean. Anything else depends on which
+        // function gets called, which we don't know yet.
+        if (type == FunctionType::Predicate)
+        {
+            return types::SimpleType(types::BasicType::Boolean);
+        }
+
+        return types::UnknownType();
+    }
+
     std::string Call::to_string()
     {
         return fmt::format("(Call,{0}{1})",
@@ -34,7 +34,7 @@ namespace rhea { namespace ast {
         for (auto&& id : children)
         {
             s += ',';
-            s += id->name;
+            s += id->name.str();
         }
 
         return fmt::format("(FullyQualified{0})", s);
@@ -46,7 +46,7 @@ namespace rhea { namespace ast {
         std::string s;
         for (auto&& id : children)
         {
-            s += id->name;
+            s += id->name.str();
             s += ':';
         }
 
@@ -59,13 +59,13 @@ namespace rhea { namespace ast {
         return s;
     }
 
-    RelativeIdentifier::RelativeIdentifier(std::unique_ptr<Identifier> id, std::string mn)
+    RelativeIdentifier::RelativeIdentifier(std::unique_ptr<Identifier> id, util::InternedString mn)
         : module_name(mn)
     {
         children.emplace_back(std::move(id));
     }
 
-    RelativeIdentifier::RelativeIdentifier(std::unique_ptr<FullyQualified> id, std::string mn)
+    RelativeIdentifier::RelativeIdentifier(std::unique_ptr<FullyQualified> id, util::InternedString mn)
         : module_name(mn)
     {
         // We need a slightly different setup here, because we're taking
@@ -82,7 +82,7 @@ namespace rhea { namespace ast {
         for (auto&& id : children)
         {
             s += ',';
-            s += id->name;
+            s += id->name.str();
         }
 
         return fmt::format("(RelativeIdentifier{0})", s);
@@ -101,9 +101,9 @@ namespace rhea { namespace ast {
         for (auto&& id : children)
         {
             s += ':';
-            s += id->name;
+            s += id->name.str();
         }
 
-        return fmt::format("{0}{1}", module_name, s);
+        return fmt::format("{0}{1}", module_name.str(), s);
     }
 }}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include "ast/nodes/node_base.hpp"
+
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+
+namespace rhea { namespace ast {
+    namespace {
+        std::atomic<NodeId> node_id_counter { 0 };
+    }
+
+    NodeId ASTNode::next_id()
+    {
+        auto id = node_id_counter.fetch_add(1, std::memory_order_relaxed);
+
+        if (id == std::numeric_limits<NodeId>::max())
+        {
+            throw std::overflow_error("Too many AST nodes");
+        }
+
+        return id;
+    }
+
+    NodeId ASTNode::id_count()
+    {
+        return node_id_counter.load(std::memory_order_relaxed);
+    }
+}}
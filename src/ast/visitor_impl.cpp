@@ -2,7 +2,7 @@
 #include "visitor/visitor.hpp"
 
 /*
- * Each AST node class needs to have a visit method override, because
+ * Each AST node class needs to have an accept method override, because
  * the way this double dispatch method works requires the child class's
  * `this`, even if we're calling through a pointer to base class. If we
  * were using C++17, this would be easy: we could just make a mixin with
@@ -15,263 +15,262 @@
  */
 
 namespace rhea { namespace ast {
-    using visitor::Visitor;
-    using util::any;
+    using visitor::VisitorBase;
 
-    any ASTNode::visit(Visitor* v)
-    { return v->visit(this); }
+    void ASTNode::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Expression::visit(Visitor* v)
-    { return v->visit(this); }
+    void Expression::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Statement::visit(Visitor* v)
-    { return v->visit(this); }
+    void Statement::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Boolean::visit(Visitor* v)
-    { return v->visit(this); }
+    void Boolean::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
     template <>
-    any Integer::visit(Visitor* v)
-    { return v->visit(this); }
+    void Integer::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
     template <>
-    any Byte::visit(Visitor* v)
-    { return v->visit(this); }
+    void Byte::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
     template <>
-    any Long::visit(Visitor* v)
-    { return v->visit(this); }
+    void Long::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
     template <>
-    any UnsignedInteger::visit(Visitor* v)
-    { return v->visit(this); }
+    void UnsignedInteger::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
     template <>
-    any UnsignedByte::visit(Visitor* v)
-    { return v->visit(this); }
+    void UnsignedByte::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
     template <>
-    any UnsignedLong::visit(Visitor* v)
-    { return v->visit(this); }
+    void UnsignedLong::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
     template <>
-    any Float::visit(Visitor* v)
-    { return v->visit(this); }
+    void Float::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
     template <>
-    any Double::visit(Visitor* v)
-    { return v->visit(this); }
+    void Double::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any String::visit(Visitor* v)
-    { return v->visit(this); }
+    void String::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Symbol::visit(Visitor* v)
-    { return v->visit(this); }
+    void Symbol::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Nothing::visit(Visitor* v)
-    { return v->visit(this); }
+    void Nothing::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Identifier::visit(Visitor* v)
-    { return v->visit(this); }
+    void Identifier::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any FullyQualified::visit(Visitor* v)
-    { return v->visit(this); }
+    void FullyQualified::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any RelativeIdentifier::visit(Visitor* v)
-    { return v->visit(this); }
+    void RelativeIdentifier::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any BinaryOp::visit(Visitor* v)
-    { return v->visit(this); }
+    void BinaryOp::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any UnaryOp::visit(Visitor* v)
-    { return v->visit(this); }
+    void UnaryOp::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any TernaryOp::visit(Visitor* v)
-    { return v->visit(this); }
+    void TernaryOp::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Member::visit(Visitor* v)
-    { return v->visit(this); }
+    void Member::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Subscript::visit(Visitor* v)
-    { return v->visit(this); }
+    void Subscript::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any GenericTypename::visit(Visitor* v)
-    { return v->visit(this); }
+    void GenericTypename::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any ArrayTypename::visit(Visitor* v)
-    { return v->visit(this); }
+    void ArrayTypename::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Typename::visit(Visitor* v)
-    { return v->visit(this); }
+    void Typename::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Variant::visit(Visitor* v)
-    { return v->visit(this); }
+    void Variant::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Optional::visit(Visitor* v)
-    { return v->visit(this); }
+    void Optional::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Cast::visit(Visitor* v)
-    { return v->visit(this); }
+    void Cast::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any TypeCheck::visit(Visitor* v)
-    { return v->visit(this); }
+    void TypeCheck::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Alias::visit(Visitor* v)
-    { return v->visit(this); }
+    void Alias::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Enum::visit(Visitor* v)
-    { return v->visit(this); }
+    void Enum::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any SymbolList::visit(Visitor* v)
-    { return v->visit(this); }
+    void SymbolList::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any TypePair::visit(Visitor* v)
-    { return v->visit(this); }
+    void TypePair::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any TypeDeclaration::visit(Visitor* v)
-    { return v->visit(this); }
+    void TypeDeclaration::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Variable::visit(Visitor* v)
-    { return v->visit(this); }
+    void Variable::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Constant::visit(Visitor* v)
-    { return v->visit(this); }
+    void Constant::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Block::visit(Visitor* v)
-    { return v->visit(this); }
+    void Block::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Assign::visit(Visitor* v)
-    { return v->visit(this); }
+    void Assign::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any CompoundAssign::visit(Visitor* v)
-    { return v->visit(this); }
+    void CompoundAssign::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Do::visit(Visitor* v)
-    { return v->visit(this); }
+    void Do::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any BareExpression::visit(Visitor* v)
-    { return v->visit(this); }
+    void BareExpression::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any If::visit(Visitor* v)
-    { return v->visit(this); }
+    void If::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any While::visit(Visitor* v)
-    { return v->visit(this); }
+    void While::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any For::visit(Visitor* v)
-    { return v->visit(this); }
+    void For::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any With::visit(Visitor* v)
-    { return v->visit(this); }
+    void With::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Break::visit(Visitor* v)
-    { return v->visit(this); }
+    void Break::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Continue::visit(Visitor* v)
-    { return v->visit(this); }
+    void Continue::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Match::visit(Visitor* v)
-    { return v->visit(this); }
+    void Match::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any On::visit(Visitor* v)
-    { return v->visit(this); }
+    void On::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any When::visit(Visitor* v)
-    { return v->visit(this); }
+    void When::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any TypeCase::visit(Visitor* v)
-    { return v->visit(this); }
+    void TypeCase::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Default::visit(Visitor* v)
-    { return v->visit(this); }
+    void Default::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any PredicateCall::visit(Visitor* v)
-    { return v->visit(this); }
+    void PredicateCall::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any NamedArgument::visit(Visitor* v)
-    { return v->visit(this); }
+    void NamedArgument::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Call::visit(Visitor* v)
-    { return v->visit(this); }
+    void Call::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Arguments::visit(Visitor* v)
-    { return v->visit(this); }
+    void Arguments::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Condition::visit(Visitor* v)
-    { return v->visit(this); }
+    void Condition::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Def::visit(Visitor* v)
-    { return v->visit(this); }
+    void Def::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any GenericDef::visit(Visitor* v)
-    { return v->visit(this); }
+    void GenericDef::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Return::visit(Visitor* v)
-    { return v->visit(this); }
+    void Return::accept(VisitorBase* v)
+    { v->dispatch(this); }
     
-    any Extern::visit(Visitor* v)
-    { return v->visit(this); }
+    void Extern::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Array::visit(Visitor* v)
-    { return v->visit(this); }
+    void Array::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any List::visit(Visitor* v)
-    { return v->visit(this); }
+    void List::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Tuple::visit(Visitor* v)
-    { return v->visit(this); }
+    void Tuple::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any DictionaryEntry::visit(Visitor* v)
-    { return v->visit(this); }
+    void DictionaryEntry::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Dictionary::visit(Visitor* v)
-    { return v->visit(this); }
+    void Dictionary::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Structure::visit(Visitor* v)
-    { return v->visit(this); }
+    void Structure::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Try::visit(Visitor* v)
-    { return v->visit(this); }
+    void Try::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Catch::visit(Visitor* v)
-    { return v->visit(this); }
+    void Catch::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Throw::visit(Visitor* v)
-    { return v->visit(this); }
+    void Throw::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Finally::visit(Visitor* v)
-    { return v->visit(this); }
+    void Finally::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Program::visit(Visitor* v)
-    { return v->visit(this); }
+    void Program::accept(VisitorBase* v)
+    { v->dispatch(this); }
     
-    any Module::visit(Visitor* v)
-    { return v->visit(this); }
+    void Module::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any ModuleName::visit(Visitor* v)
-    { return v->visit(this); }
+    void ModuleName::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any ModuleDef::visit(Visitor* v)
-    { return v->visit(this); }
+    void ModuleDef::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Use::visit(Visitor* v)
-    { return v->visit(this); }
+    void Use::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Import::visit(Visitor* v)
-    { return v->visit(this); }
+    void Import::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Export::visit(Visitor* v)
-    { return v->visit(this); }
+    void Export::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any ConceptMatch::visit(Visitor* v)
-    { return v->visit(this); }
+    void ConceptMatch::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any MemberCheck::visit(Visitor* v)
-    { return v->visit(this); }
+    void MemberCheck::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any FunctionCheck::visit(Visitor* v)
-    { return v->visit(this); }
+    void FunctionCheck::accept(VisitorBase* v)
+    { v->dispatch(this); }
 
-    any Concept::visit(Visitor* v)
-    { return v->visit(this); }
+    void Concept::accept(VisitorBase* v)
+    { v->dispatch(this); }
 }}
\ No newline at end of file
@@ -10,30 +10,24 @@ namespace rhea { namespace codegen {
             push();
         }
 
-        m_stack.front().alloca_table[name] = ai;
+        m_table.insert(name, ai);
     }
 
     bool AllocationManager::is_local(std::string s)
     {
-        const auto local = m_stack.back();
-        return (local.alloca_table.find(s) != local.alloca_table.end());
+        return m_table.is_local(s);
     }
 
     util::optional<llvm::AllocaInst*> AllocationManager::find(std::string key)
     {
-        util::optional<llvm::AllocaInst*> opt({});
+        util::optional<llvm::AllocaInst*> opt {};
 
-        // We search backwards through the scope stack to find the latest declaration
-        // of the desired symbol.
-        for (auto s = m_stack.rbegin(); s != m_stack.rend(); ++s)
-        {
-            auto ai = s->alloca_table.find(key);
+        // The table gives us the latest declaration of the desired symbol.
+        auto ai = m_table.find(key);
 
-            if (ai != s->alloca_table.end())
-            {
-                opt = ai->second;
-                break;
-            }
+        if (ai != nullptr)
+        {
+            opt = *ai;
         }
 
         return opt;
@@ -1,6 +1,12 @@
 #include "codegen/code_visitor.hpp"
 #include "codegen/generator.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <llvm/IR/MDBuilder.h>
+
 namespace rhea { namespace codegen {
     using namespace rhea::ast;
     using llvm::Value;
@@ -42,7 +48,7 @@ namespace rhea { namespace codegen {
         }
 
         llvm::AllocaInst* create_allocation(
-            llvm::Function* fn, std::string name, types::TypeInfo type, CodeGenerator* gen)
+            llvm::Function* fn, std::string name, const types::TypeInfo& type, CodeGenerator* gen)
         {
             if (gen->scope_manager.is_local(name))
             {
@@ -65,9 +71,161 @@ namespace rhea { namespace codegen {
                 return nullptr;
             }
         }
+
+        // Create a global for a top-level definition. If the value is known
+        // at compile time (the builder folds constant expressions for us),
+        // it becomes the global's initializer, and a constant goes in
+        // read-only memory. Otherwise, the module's init function has to
+        // store it at startup.
+        llvm::GlobalVariable* create_global(
+            std::string name, llvm::Type* type, Value* value, bool constant, CodeGenerator* gen)
+        {
+            auto init = llvm::dyn_cast<llvm::Constant>(value);
+            if (init != nullptr && init->getType() != type)
+            {
+                init = nullptr;
+            }
+
+            // LLVM likes to take ownership of...well, everything. So we can't
+            // use a unique_ptr here, apparently.
+            auto gvar = new llvm::GlobalVariable(
+                *(gen->module),
+                type,
+                constant && init != nullptr,
+                gen->global_linkage(),
+                init != nullptr ? init : llvm::Constant::getNullValue(type),
+                name
+            );
+
+            if (init == nullptr)
+            {
+                gen->builder.CreateStore(value, gvar);
+            }
+
+            return gvar;
+        }
+
+        // Convert an operand to a boolean, looking through the coercion
+        // operator if it's there.
+        Value* boolean_operand(Value* v, Expression* e, CodeGenerator* gen)
+        {
+            auto& et = gen->type_of(e);
+            auto es = util::get_if<types::SimpleType>(&(et.type()));
+
+            if (es != nullptr && es->type == BasicType::Promoted)
+            {
+                auto& ty = gen->type_of((dynamic_cast<ast::UnaryOp*>(e))->operand.get());
+                return convert_type(gen, v, ty, BasicType::Boolean, true);
+            }
+
+            return convert_type(gen, v, et, BasicType::Boolean, false);
+        }
+
+        // Is an expression unlikely to be evaluated? Calls to predicates
+        // (`valid(x)?`) are checks that are expected to pass, so code that
+        // leads to one is treated as the cold path.
+        bool is_cold(Expression* e)
+        {
+            auto call = dynamic_cast<ast::Call*>(e);
+            return call != nullptr && call->type == ast::FunctionType::Predicate;
+        }
+
+        // Branch weights for a likely/unlikely pair, the same ones Clang
+        // uses for `__builtin_expect`.
+        constexpr std::uint32_t likely_weight = 2000;
+        constexpr std::uint32_t unlikely_weight = 1;
+
+        // Lowering for `and` and `or`, which branch around their RHS.
+        Value* short_circuit(BinaryOp* n, CodeVisitor* visitor)
+        {
+            auto gen = visitor->generator;
+            auto is_and = (n->op == ast::BinaryOperators::BooleanAnd);
+            auto& builder = gen->builder;
+
+            auto& lt = gen->type_of(n->left.get()).type();
+            auto lt_simple = util::get_if<types::SimpleType>(&lt);
+            if (lt_simple != nullptr && lt_simple->type == BasicType::Promoted)
+            {
+                throw syntax_error("Can't use the coercion operator on the left-hand side of an expression");
+            }
+
+            Value* lhs = boolean_operand(n->left->visit(visitor), n->left.get(), gen);
+
+            // The LHS may have created blocks of its own (e.g., `a and b and c`),
+            // so the PHI needs to know where we really came from.
+            llvm::BasicBlock* lhs_block = builder.GetInsertBlock();
+            llvm::Function* parent_fn = lhs_block->getParent();
+
+            llvm::BasicBlock* rhs_block = llvm::BasicBlock::Create(
+                gen->context, is_and ? "and.rhs" : "or.rhs", parent_fn);
+            llvm::BasicBlock* end_block = llvm::BasicBlock::Create(
+                gen->context, is_and ? "and.end" : "or.end");
+
+            // `and` needs the RHS when the LHS is true, `or` when it's false.
+            llvm::MDNode* weights = nullptr;
+            if (is_cold(n->right.get()))
+            {
+                llvm::MDBuilder md { gen->context };
+                weights = is_and
+                    ? md.createBranchWeights(unlikely_weight, likely_weight)
+                    : md.createBranchWeights(likely_weight, unlikely_weight);
+            }
+
+            if (is_and)
+            {
+                builder.CreateCondBr(lhs, rhs_block, end_block, weights);
+            }
+            else
+            {
+                builder.CreateCondBr(lhs, end_block, rhs_block, weights);
+            }
+
+            builder.SetInsertPoint(rhs_block);
+            Value* rhs = boolean_operand(n->right->visit(visitor), n->right.get(), gen);
+            builder.CreateBr(end_block);
+            rhs_block = builder.GetInsertBlock();
+
+            parent_fn->getBasicBlockList().push_back(end_block);
+            builder.SetInsertPoint(end_block);
+
+            auto phi = builder.CreatePHI(llvm::Type::getInt1Ty(gen->context), 2, is_and ? "andtmp" : "ortmp");
+            phi->addIncoming(
+                is_and ? llvm::ConstantInt::getFalse(gen->context) : llvm::ConstantInt::getTrue(gen->context),
+                lhs_block
+            );
+            phi->addIncoming(rhs, rhs_block);
+
+            return phi;
+        }
+
+        // The false arm of a ternary, converted to the type of the true arm.
+        Value* false_branch_value(TernaryOp* n, CodeVisitor* visitor)
+        {
+            auto gen = visitor->generator;
+            Value* f_branch = n->false_branch->visit(visitor);
+
+            auto& tbt = gen->type_of(n->true_branch.get());
+            auto& fbt = gen->type_of(n->false_branch.get());
+            auto fbt_simple = util::get_if<types::SimpleType>(&(fbt.type()));
+
+            // Implicit conversion of the false branch, because the true branch
+            // controls the result type.
+
+            auto coerce = (fbt_simple != nullptr && fbt_simple->type == BasicType::Promoted);
+            if (!coerce)
+            {
+                return convert_type(gen, f_branch, fbt, tbt, false);
+            }
+            else
+            {
+                // Explicit conversion from the coercion operator
+                auto& ty = gen->type_of((dynamic_cast<ast::UnaryOp*>(n->false_branch.get()))->operand.get());
+                return convert_type(gen, f_branch, ty, tbt, true);
+            }
+        }
     }
 
-    any CodeVisitor::visit(Boolean* n)
+    Value* CodeVisitor::visit(Boolean* n)
     {
         Value* ret;
         if (n->value)
@@ -82,7 +240,7 @@ namespace rhea { namespace codegen {
         return ret;
     }
 
-    any CodeVisitor::visit(Integer* n)
+    Value* CodeVisitor::visit(Integer* n)
     {
         auto ret = internal::integral_value<
             Integer::template_type,
@@ -93,7 +251,7 @@ namespace rhea { namespace codegen {
         return ret;
     }
 
-    any CodeVisitor::visit(Byte* n)
+    Value* CodeVisitor::visit(Byte* n)
     {
         auto ret = internal::integral_value<
             Byte::template_type,
@@ -104,7 +262,7 @@ namespace rhea { namespace codegen {
         return ret;
     }
 
-    any CodeVisitor::visit(Long* n)
+    Value* CodeVisitor::visit(Long* n)
     {
         auto ret = internal::integral_value<
             Long::template_type,
@@ -115,7 +273,7 @@ namespace rhea { namespace codegen {
         return ret;
     }
 
-    any CodeVisitor::visit(UnsignedInteger* n)
+    Value* CodeVisitor::visit(UnsignedInteger* n)
     {
         auto ret = internal::integral_value<
             UnsignedInteger::template_type,
@@ -126,7 +284,7 @@ namespace rhea { namespace codegen {
         return ret;
     }
 
-    any CodeVisitor::visit(UnsignedByte* n)
+    Value* CodeVisitor::visit(UnsignedByte* n)
     {
         auto ret = internal::integral_value<
             UnsignedByte::template_type,
@@ -137,7 +295,7 @@ namespace rhea { namespace codegen {
         return ret;
     }
 
-    any CodeVisitor::visit(UnsignedLong* n)
+    Value* CodeVisitor::visit(UnsignedLong* n)
     {
         auto ret = internal::integral_value<
             UnsignedLong::template_type,
@@ -148,7 +306,7 @@ namespace rhea { namespace codegen {
         return ret;
     }
 
-    any CodeVisitor::visit(Float* n)
+    Value* CodeVisitor::visit(Float* n)
     {
         auto ret = internal::fp_value<
             Float::template_type
@@ -157,7 +315,7 @@ namespace rhea { namespace codegen {
         return ret;
     }
 
-    any CodeVisitor::visit(Double* n)
+    Value* CodeVisitor::visit(Double* n)
     {
         auto ret = internal::fp_value<
             Double::template_type
@@ -166,18 +324,23 @@ namespace rhea { namespace codegen {
         return ret;
     }
 
-    any CodeVisitor::visit(Symbol* n)
+    Value* CodeVisitor::visit(Symbol* n)
     {
+        // Symbols get a dense ID from the whole-program table, which also
+        // catches hash collisions. The hash itself is only for the ABI.
+        auto& symbols = util::SymbolTable::global();
+        auto id = symbols.intern(n->value);
+
         auto ret = internal::integral_value<
             uint64_t,
             64,
             false
-        >(util::symbol_hash(n->value), generator);
+        >(generator->hashed_symbols ? symbols.abi_hash(id) : id, generator);
 
         return ret;
     }
 
-    any CodeVisitor::visit(Nothing* n)
+    Value* CodeVisitor::visit(Nothing* n)
     {
         // Maybe change this, since some functions can return an actual nothing
         // instead of just being void.
@@ -186,7 +349,7 @@ namespace rhea { namespace codegen {
         return ret;
     }
 
-    any CodeVisitor::visit(Identifier* n)
+    Value* CodeVisitor::visit(Identifier* n)
     {
         // This visitor implements read access for identifiers. Assignment and
         // variable definition handle write access in their own way.
@@ -200,7 +363,7 @@ namespace rhea { namespace codegen {
         {
             // Now we can actually unpack the search result.
             state::SymbolEntry var;
-            std::string scope;
+            util::InternedString scope;
             std::tie(var, scope) = varopt.value();
 
             switch (var.declaration)
@@ -211,25 +374,23 @@ namespace rhea { namespace codegen {
                     if (scope == "$global")
                     {
                         // Global variables are accessed differently.
-                        auto gvar = generator->module->getGlobalVariable(var.name, true);
-                        ret = generator->builder.CreateLoad(gvar, var.name);
+                        auto gvar = generator->find_global(var.name.str(), var.type_data);
+                        ret = generator->builder.CreateLoad(gvar, var.name.str());
                     }
                     else
                     {
                         // Local variables need a load instruction with the proper address.
-                        auto lvar = generator->allocation_manager.find(var.name);
+                        auto lvar = generator->allocation_manager.find(var.name.str());
                         if (lvar)
                         {
-                            ret = generator->builder.CreateLoad(*lvar, var.name);
+                            ret = generator->builder.CreateLoad(*lvar, var.name.str());
                         }
                         else
                         {
-                            throw std::invalid_argument("Variable " + var.name + " not in allocation table");
+                            throw std::invalid_argument("Variable " + var.name.str() + " not in allocation table");
                         }
                     }
 
-                    n->set_expression_type(var.type_data);
-
                     break;
                 }
                 default:
@@ -239,28 +400,34 @@ namespace rhea { namespace codegen {
         else
         {
             // Variable is not defined
-            throw syntax_error("Identifier " + n->name + " is not defined");
+            throw syntax_error("Identifier " + n->name.str() + " is not defined");
         }
 
         return ret;
     }
 
-    any CodeVisitor::visit(BinaryOp* n)
+    Value* CodeVisitor::visit(BinaryOp* n)
     {
         using ast::BinaryOperators;
 
-        Value* lhs = util::any_cast<Value*>(n->left->visit(this));
-        Value* rhs = util::any_cast<Value*>(n->right->visit(this));
+        // `and` and `or` only evaluate their RHS if they have to.
+        if (n->op == BinaryOperators::BooleanAnd || n->op == BinaryOperators::BooleanOr)
+        {
+            return internal::short_circuit(n, this);
+        }
+
+        Value* lhs = n->left->visit(this);
+        Value* rhs = n->right->visit(this);
 
         // The type of the whole expression
-        auto et = n->expression_type().type();
+        auto& et = generator->type_of(n).type();
         auto as_simple = util::get_if<types::SimpleType>(&et);
 
         // The types of the operands
-        auto lt = n->left->expression_type().type();
+        auto& lt = generator->type_of(n->left.get()).type();
         auto lt_simple = util::get_if<types::SimpleType>(&lt);
 
-        auto rt = n->right->expression_type().type();
+        auto& rt = generator->type_of(n->right.get()).type();
         auto rt_simple = util::get_if<types::SimpleType>(&rt);
 
         // Not allowed to use the coercion operator on the LHS
@@ -280,7 +447,7 @@ namespace rhea { namespace codegen {
         else
         {
             // If this is an explicit conversion from the coercion operator
-            auto ty = (dynamic_cast<ast::UnaryOp*>(n->right.get()))->operand->expression_type();
+            auto& ty = generator->type_of((dynamic_cast<ast::UnaryOp*>(n->right.get()))->operand.get());
             rhs = convert_type(generator, rhs, ty, lt, true);
         }
 
@@ -422,24 +589,6 @@ namespace rhea { namespace codegen {
                         break;
                 }
             }
-            else if (as_simple->type == BasicType::Boolean && lt_simple->type == BasicType::Boolean)
-            {
-                // Boolean operations
-                switch (n->op)
-                {
-                    case BinaryOperators::BooleanAnd:
-                        ret = generator->builder.CreateAnd(lhs, rhs, "andtmp");
-                        break;
-                    case BinaryOperators::BooleanOr:
-                        ret = generator->builder.CreateOr(lhs, rhs, "ortmp");
-                        break;
-                    default:
-                        // Other operations are not defined on boolean values,
-                        // so should we throw an error here?
-                        // throw syntax_error("Invalid type for operation");
-                        break;
-                }
-            }
             else
             {
                 // Operations on other simple types
@@ -450,18 +599,18 @@ namespace rhea { namespace codegen {
         return ret;
     }
 
-    any CodeVisitor::visit(UnaryOp* n)
+    Value* CodeVisitor::visit(UnaryOp* n)
     {
         using ast::UnaryOperators;
 
-        Value* operand = util::any_cast<Value*>(n->operand->visit(this));
+        Value* operand = n->operand->visit(this);
 
         // The type of the whole expression
-        auto et = n->expression_type().type();
+        auto& et = generator->type_of(n).type();
         auto as_simple = util::get_if<types::SimpleType>(&et);
 
         // The type of the operand, which we will need for, e.g., promotion
-        auto ot = n->operand->expression_type().type();
+        auto& ot = generator->type_of(n->operand.get()).type();
         auto ot_simple = util::get_if<types::SimpleType>(&ot);
 
         Value* ret = nullptr;
@@ -540,47 +689,98 @@ namespace rhea { namespace codegen {
         return ret;
     }
 
-    any CodeVisitor::visit(TernaryOp* n)
+    Value* CodeVisitor::visit(TernaryOp* n)
     {
-        // The ternary operator in Rhea is an expression. Luckily for us,
-        // LLVM provides a `select` instruction that does pretty much exactly
-        // what we want.
+        // The ternary operator in Rhea is an expression. If both arms are
+        // cheap and can't have side effects, LLVM's `select` instruction
+        // does exactly what we want. Otherwise, only the arm that's chosen
+        // can be evaluated, so we branch to it, like an `if`.
 
         // First get the condition expression as a boolean
-        Value* cond = util::any_cast<Value*>(n->condition->visit(this));
-        cond = convert_type(generator, cond, n->condition->expression_type(), BasicType::Boolean, false);
+        Value* cond = n->condition->visit(this);
+        cond = convert_type(generator, cond, generator->type_of(n->condition.get()), BasicType::Boolean, false);
 
-        Value* t_branch = util::any_cast<Value*>(n->true_branch->visit(this));
-        Value* f_branch = util::any_cast<Value*>(n->false_branch->visit(this));
+        if (should_use_select(n))
+        {
+            Value* t_branch = n->true_branch->visit(this);
+            Value* f_branch = internal::false_branch_value(n, this);
 
-        auto tbt = n->true_branch->expression_type();
-        auto fbt = n->false_branch->expression_type();
-        auto fbt_simple = util::get_if<types::SimpleType>(&(fbt.type()));
+            return generator->builder.CreateSelect(
+                cond, t_branch, f_branch, "ternaryop"
+            );
+        }
 
-        // Implicit conversion of the false branch, because the true branch
-        // controls the result type.
+        auto& builder = generator->builder;
+        llvm::Function* parent_fn = builder.GetInsertBlock()->getParent();
 
-        auto coerce = (fbt_simple != nullptr && fbt_simple->type == BasicType::Promoted);
-        if (!coerce)
+        llvm::BasicBlock* true_block = llvm::BasicBlock::Create(generator->context, "tern.true", parent_fn);
+        llvm::BasicBlock* false_block = llvm::BasicBlock::Create(generator->context, "tern.false");
+        llvm::BasicBlock* end_block = llvm::BasicBlock::Create(generator->context, "tern.end");
+
+        builder.CreateCondBr(cond, true_block, false_block);
+
+        // Each arm can create blocks of its own, so the PHI needs the block
+        // we end up in, not the one we started with.
+        builder.SetInsertPoint(true_block);
+        Value* t_branch = n->true_branch->visit(this);
+        builder.CreateBr(end_block);
+        true_block = builder.GetInsertBlock();
+
+        parent_fn->getBasicBlockList().push_back(false_block);
+        builder.SetInsertPoint(false_block);
+        Value* f_branch = internal::false_branch_value(n, this);
+        builder.CreateBr(end_block);
+        false_block = builder.GetInsertBlock();
+
+        parent_fn->getBasicBlockList().push_back(end_block);
+        builder.SetInsertPoint(end_block);
+
+        auto phi = builder.CreatePHI(t_branch->getType(), 2, "ternaryop");
+        phi->addIncoming(t_branch, true_block);
+        phi->addIncoming(f_branch, false_block);
+
+        return phi;
+    }
+
+    Value* CodeVisitor::visit(Call* n)
+    {
+        // Functions aren't compiled yet, so we call one by name, declaring it
+        // if this module doesn't have it, and leave it to the linker (or JIT)
+        // to find. That needs the return type, which, for now, we only know
+        // for predicates.
+        auto target = dynamic_cast<Identifier*>(n->target.get());
+        if (target == nullptr)
         {
-            f_branch = convert_type(generator, f_branch, fbt, tbt, false);
+            throw unimplemented_type("Only named functions can be called");
         }
-        else
+
+        auto return_type = generator->llvm_for_type(generator->type_of(n));
+        if (return_type == nullptr)
         {
-            // Explicit conversion from the coercion operator
-            auto ty = (dynamic_cast<ast::UnaryOp*>(n->false_branch.get()))->operand->expression_type();
-            f_branch = convert_type(generator, f_branch, ty, tbt, true);
+            throw unimplemented_type("Unknown return type for " + target->name.str());
         }
 
-        Value* ret = generator->builder.CreateSelect(
-            cond, t_branch, f_branch, "ternaryop"
-        );
+        std::vector<Value*> args;
+        std::vector<llvm::Type*> arg_types;
+        for (auto& a : n->arguments)
+        {
+            auto positional = util::get_if<expression_ptr>(&a);
+            if (positional == nullptr)
+            {
+                throw unimplemented_type("Named arguments in a call to " + target->name.str());
+            }
 
-        // TODO Anything else?
-        return ret;
+            args.push_back((*positional)->visit(this));
+            arg_types.push_back(args.back()->getType());
+        }
+
+        auto fn_type = llvm::FunctionType::get(return_type, arg_types, false);
+        auto callee = generator->module->getOrInsertFunction(target->name.str(), fn_type);
+
+        return generator->builder.CreateCall(callee, args, "calltmp");
     }
 
-    any CodeVisitor::visit(BareExpression* n)
+    Value* CodeVisitor::visit(BareExpression* n)
     {
         // Bare expressions aren't really statements, but expressions evaluated
         // in a statement context. They're most useful for function calls, which
@@ -589,7 +789,7 @@ namespace rhea { namespace codegen {
 
         // static unsigned int count = 0u;
 
-        auto value = util::any_cast<Value*>(n->expression->visit(this));
+        auto value = n->expression->visit(this);
 
         auto result = generator->builder.CreateSelect(
             llvm::ConstantInt::getTrue(generator->context),
@@ -638,7 +838,7 @@ namespace rhea { namespace codegen {
         // }
     }
 
-    any CodeVisitor::visit(Block* n)
+    Value* CodeVisitor::visit(Block* n)
     {
         // Blocks do not produce IR basic blocks, but they do introduce a new declaration scope.
         
@@ -649,7 +849,7 @@ namespace rhea { namespace codegen {
 
         // Blocks have no real return values, but we'll do like a lot of other languages
         // and keep the value of the last statement in the block.
-        util::any ret;
+        Value* ret = nullptr;
 
         // Codegen for the block is easy: loop through all the statements.
         for (auto& statement : n->children)
@@ -663,13 +863,13 @@ namespace rhea { namespace codegen {
         return ret;
     }
 
-    any CodeVisitor::visit(If* n)
+    Value* CodeVisitor::visit(If* n)
     {
-        util::any ret;
+        Value* ret = nullptr;
 
         // Get the condition expression as a boolean (no implicit conversion in Rhea)
-        auto cond = util::any_cast<Value*>(n->condition->visit(this));
-        cond = convert_type(generator, cond, n->condition->expression_type(), BasicType::Boolean, false);
+        auto cond = n->condition->visit(this);
+        cond = convert_type(generator, cond, generator->type_of(n->condition.get()), BasicType::Boolean, false);
 
         // Create blocks for the cases, then the "merge" block at the end
         llvm::Function* parent_fn = generator->builder.GetInsertBlock()->getParent();
@@ -687,8 +887,8 @@ namespace rhea { namespace codegen {
         // normal ifs won't, either.
         if (n->then_case != nullptr)
         {
-            util::any then_result = n->then_case->visit(this);
-            if (then_result.empty())    // Change to !has_value() for C++17 any
+            Value* then_result = n->then_case->visit(this);
+            if (then_result == nullptr)
             {
                 // Something went wrong with codegen, but not enough to throw an error
                 return nullptr;
@@ -708,8 +908,8 @@ namespace rhea { namespace codegen {
         // Not all ifs will have elses.
         if (n->else_case != nullptr)
         {
-            util::any else_result = n->else_case->visit(this);
-            if (else_result.empty())    // Change to !has_value() for C++17 any
+            Value* else_result = n->else_case->visit(this);
+            if (else_result == nullptr)
             {
                 // Something went wrong with codegen, but not enough to throw an error
                 return nullptr;
@@ -733,13 +933,166 @@ namespace rhea { namespace codegen {
         return ret;
     }
 
-    any CodeVisitor::visit(TypeDeclaration* n)
+    Value* CodeVisitor::visit(Match* n)
+    {
+        // A `match ... on` becomes an LLVM switch, which the backend turns
+        // into a jump table or a binary search, whichever fits the values.
+        // Matches with `when` or `type` cases can't work like that.
+        for (auto& c : n->cases)
+        {
+            if (dynamic_cast<On*>(c.get()) == nullptr && dynamic_cast<Default*>(c.get()) == nullptr)
+            {
+                throw unimplemented_type("Only match-on statements can be compiled");
+            }
+        }
+
+        Value* subject = n->expression->visit(this);
+
+        auto& st = generator->type_of(n->expression.get());
+        auto st_simple = util::get_if<types::SimpleType>(&(st.type()));
+        if (st_simple == nullptr ||
+            !(types::is_integral_type(st_simple->type) || st_simple->type == BasicType::Symbol))
+        {
+            throw syntax_error(fmt::format("Can't match on a value of type {0}", types::to_string(st)));
+        }
+
+        auto subject_type = llvm::cast<llvm::IntegerType>(subject->getType());
+        auto is_signed = !internal::is_unsigned_type(st_simple->type);
+
+        llvm::Function* parent_fn = generator->builder.GetInsertBlock()->getParent();
+        llvm::BasicBlock* end_block = llvm::BasicBlock::Create(generator->context, "match.end");
+        llvm::BasicBlock* default_block = nullptr;
+
+        // Create the switch first, pointing at the end, and fix the default
+        // destination up later if there is one.
+        auto sw = generator->builder.CreateSwitch(subject, end_block, n->cases.size());
+
+        // Every case gets one block, however many values it matches.
+        std::vector<std::pair<Case*, llvm::BasicBlock*>> bodies;
+        for (auto& c : n->cases)
+        {
+            if (dynamic_cast<Default*>(c.get()) != nullptr)
+            {
+                if (default_block != nullptr)
+                {
+                    throw syntax_error("A match can only have one default case");
+                }
+
+                default_block = llvm::BasicBlock::Create(generator->context, "match.default");
+                sw->setDefaultDest(default_block);
+                bodies.emplace_back(c.get(), default_block);
+                continue;
+            }
+
+            auto on = static_cast<On*>(c.get());
+            auto block = llvm::BasicBlock::Create(generator->context, "match.on");
+
+            for (auto& v : on->case_values)
+            {
+                auto& vt = generator->type_of(v.get());
+                auto vt_simple = util::get_if<types::SimpleType>(&(vt.type()));
+                auto is_symbol = (vt_simple != nullptr && vt_simple->type == BasicType::Symbol);
+                if (is_symbol != (st_simple->type == BasicType::Symbol))
+                {
+                    throw syntax_error(fmt::format("Case value {0} doesn't match type {1}",
+                        v->to_string(), types::to_string(st)));
+                }
+
+                auto value = llvm::dyn_cast_or_null<llvm::ConstantInt>(v->visit(this));
+                if (value == nullptr)
+                {
+                    throw syntax_error(fmt::format("Case value {0} is not a constant", v->to_string()));
+                }
+
+                // Case values are usually plain integer literals, so let any
+                // of them through as long as they fit the subject's type.
+                // That's a question of the value itself, read with its own
+                // signedness, so `255_ub` doesn't fit a byte, even though
+                // they're the same width.
+                if (vt_simple == nullptr || vt_simple->type != st_simple->type)
+                {
+                    auto bits = subject_type->getBitWidth();
+                    auto& ap = value->getValue();
+
+                    // One extra bit, so no value of either signedness wraps.
+                    auto wide_bits = std::max(ap.getBitWidth(), bits) + 1;
+                    auto value_signed = !(vt_simple != nullptr && internal::is_unsigned_type(vt_simple->type));
+                    auto wide = value_signed ? ap.sext(wide_bits) : ap.zext(wide_bits);
+
+                    auto fits = is_signed
+                        ? wide.isSignedIntN(bits)
+                        : (wide.isNonNegative() && wide.isIntN(bits));
+                    if (!fits)
+                    {
+                        throw syntax_error(fmt::format("Case value {0} is out of range for type {1}",
+                            v->to_string(), types::to_string(st)));
+                    }
+
+                    value = llvm::ConstantInt::get(generator->context, wide.trunc(bits));
+                }
+
+                if (sw->findCaseValue(value) != sw->case_default())
+                {
+                    throw syntax_error(fmt::format("Duplicate case value {0}", v->to_string()));
+                }
+
+                sw->addCase(value, block);
+            }
+
+            bodies.emplace_back(c.get(), block);
+        }
+
+        // Now the bodies, in source order. There's no fallthrough, so each
+        // one goes to the end when it's done (unless it already left).
+        for (auto& b : bodies)
+        {
+            parent_fn->getBasicBlockList().push_back(b.second);
+            generator->builder.SetInsertPoint(b.second);
+
+            auto on = dynamic_cast<On*>(b.first);
+            if (on != nullptr)
+            {
+                on->body->visit(this);
+            }
+            else
+            {
+                static_cast<Default*>(b.first)->body->visit(this);
+            }
+
+            if (generator->builder.GetInsertBlock()->getTerminator() == nullptr)
+            {
+                generator->builder.CreateBr(end_block);
+            }
+        }
+
+        parent_fn->getBasicBlockList().push_back(end_block);
+        generator->builder.SetInsertPoint(end_block);
+
+        return sw;
+    }
+
+    Value* CodeVisitor::visit(Enum* n)
+    {
+        // Enums don't generate any code, but their members are registered
+        // together, so they get neighboring IDs if they're new.
+        std::vector<std::string> members;
+        for (auto& s : n->values->symbols)
+        {
+            members.push_back(s->value);
+        }
+
+        util::SymbolTable::global().intern_enum(n->name->name.str(), members);
+
+        return nullptr;
+    }
+
+    Value* CodeVisitor::visit(TypeDeclaration* n)
     {
         // For a variable declaration (with no initialization), we only have to
         // place an entry in the current scope's symbol table and allocate stack
         // memory for the appropriate variable type.
 
-        std::string var_name = n->lhs->name;
+        std::string var_name = n->lhs->name.str();
         std::string type_name = n->rhs->canonical_name();
 
         if (!generator->type_mapper.is_type_defined(type_name))
@@ -781,7 +1134,7 @@ namespace rhea { namespace codegen {
                     *(generator->module),
                     ltype,
                     false,
-                    llvm::GlobalVariable::LinkageTypes::InternalLinkage,
+                    generator->global_linkage(),
                     llvm::Constant::getNullValue(ltype),
                     var_name                    
                 );
@@ -797,15 +1150,15 @@ namespace rhea { namespace codegen {
         return result;
     }
 
-    any CodeVisitor::visit(Variable* n)
+    Value* CodeVisitor::visit(Variable* n)
     {
         // For a variable definition (with initialization), we also have to store
         // the RHS expression's value into the appropriate memory.
 
-        std::string vname = n->lhs->name;
+        std::string vname = n->lhs->name.str();
 
-        Value* rhs = util::any_cast<Value*>(n->rhs->visit(this));
-        auto vtype = n->rhs->expression_type();
+        Value* rhs = n->rhs->visit(this);
+        auto& vtype = generator->type_of(n->rhs.get());
         auto ltype = generator->llvm_for_type(vtype);
 
         if (!generator->scope_manager.is_local(vname))
@@ -836,19 +1189,7 @@ namespace rhea { namespace codegen {
             else
             {
                 // This is a top-level variable definition, so treat it as a global.
-
-                // LLVM likes to take ownership of...well, everything. So we can't
-                // use a unique_ptr here, apparently.
-                auto gvar = new llvm::GlobalVariable(
-                    *(generator->module),
-                    ltype,
-                    false,
-                    llvm::GlobalVariable::LinkageTypes::InternalLinkage,
-                    llvm::Constant::getNullValue(ltype),
-                    vname                    
-                );
-
-                generator->builder.CreateStore(rhs, gvar);
+                internal::create_global(vname, ltype, rhs, false, generator);
 
                 // Don't really know what to return here, so hand off to the outer block.
             }
@@ -859,18 +1200,19 @@ namespace rhea { namespace codegen {
             throw syntax_error(fmt::format("Redefinition of variable {0}", vname));
         }
 
-        return {};
+        return nullptr;
     }
 
-    any CodeVisitor::visit(Constant* n)
+    Value* CodeVisitor::visit(Constant* n)
     {
-        // For now, we just use the same code for constants. Later, we might be able
-        // to optimize this. Remember that Rhea's var/const distinction is more like
-        // that of JavaScript. A constant doesn't have to be known at compile time.
-        std::string vname = n->lhs->name;
-        auto vtype = n->rhs->expression_type();
+        // This is mostly the same code as for variables. Remember that Rhea's
+        // var/const distinction is more like that of JavaScript. A constant
+        // doesn't have to be known at compile time, but when it is, it can
+        // go in read-only memory.
+        std::string vname = n->lhs->name.str();
+        Value* rhs = n->rhs->visit(this);
+        auto& vtype = generator->type_of(n->rhs.get());
         auto ltype = generator->llvm_for_type(vtype);
-        Value* rhs = util::any_cast<Value*>(n->rhs->visit(this));
 
         if (!generator->scope_manager.is_local(vname))
         {
@@ -893,20 +1235,8 @@ namespace rhea { namespace codegen {
             }
             else
             {
-                // This is a top-level variable definition, so treat it as a global.
-
-                // LLVM likes to take ownership of...well, everything. So we can't
-                // use a unique_ptr here, apparently.
-                auto gvar = new llvm::GlobalVariable(
-                    *(generator->module),
-                    ltype,
-                    false,
-                    llvm::GlobalVariable::LinkageTypes::InternalLinkage,
-                    llvm::Constant::getNullValue(ltype),
-                    vname                    
-                );
-
-                generator->builder.CreateStore(rhs, gvar);
+                // This is a top-level constant definition, so treat it as a global.
+                internal::create_global(vname, ltype, rhs, true, generator);
 
                 // Don't really know what to return here, so hand off to the outer block.
             }
@@ -917,6 +1247,6 @@ namespace rhea { namespace codegen {
             throw syntax_error(fmt::format("Redefinition of variable {0}", vname));
         }
 
-        return {};
+        return nullptr;
     }
 }}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "codegen/cost.hpp"
+
+namespace rhea { namespace codegen {
+    using namespace rhea::ast;
+
+    namespace {
+        // Add costs without wrapping around, so unbounded stays unbounded.
+        unsigned add_cost(unsigned a, unsigned b)
+        {
+            return (a > unbounded_cost - b) ? unbounded_cost : a + b;
+        }
+
+        unsigned cost_of(Expression* e, CostVisitor* v)
+        {
+            return e->visit(v).value;
+        }
+    }
+
+    // Literals are constants, so they're free.
+    Cost CostVisitor::visit(Boolean* n) { return { 0 }; }
+    Cost CostVisitor::visit(Integer* n) { return { 0 }; }
+    Cost CostVisitor::visit(Byte* n) { return { 0 }; }
+    Cost CostVisitor::visit(Long* n) { return { 0 }; }
+    Cost CostVisitor::visit(UnsignedInteger* n) { return { 0 }; }
+    Cost CostVisitor::visit(UnsignedByte* n) { return { 0 }; }
+    Cost CostVisitor::visit(UnsignedLong* n) { return { 0 }; }
+    Cost CostVisitor::visit(Float* n) { return { 0 }; }
+    Cost CostVisitor::visit(Double* n) { return { 0 }; }
+    Cost CostVisitor::visit(Symbol* n) { return { 0 }; }
+    Cost CostVisitor::visit(Nothing* n) { return { 0 }; }
+
+    // Identifiers are a load from a variable that's already allocated, which
+    // is always safe.
+    Cost CostVisitor::visit(Identifier* n) { return { 1 }; }
+
+    Cost CostVisitor::visit(BinaryOp* n)
+    {
+        switch (n->op)
+        {
+            // Division by zero traps, so these can't be speculated, and
+            // exponentiation will end up as a library call.
+            case BinaryOperators::Divide:
+            case BinaryOperators::Modulus:
+            case BinaryOperators::Exponent:
+                return {};
+
+            // Short-circuiting needs its own branch.
+            case BinaryOperators::BooleanAnd:
+            case BinaryOperators::BooleanOr:
+                return { add_cost(2, add_cost(cost_of(n->left.get(), this), cost_of(n->right.get(), this))) };
+
+            default:
+                return { add_cost(1, add_cost(cost_of(n->left.get(), this), cost_of(n->right.get(), this))) };
+        }
+    }
+
+    Cost CostVisitor::visit(UnaryOp* n)
+    {
+        switch (n->op)
+        {
+            case UnaryOperators::Plus:
+            case UnaryOperators::Minus:
+            case UnaryOperators::BooleanNot:
+            case UnaryOperators::BitNot:
+            case UnaryOperators::Coerce:
+                return { add_cost(1, cost_of(n->operand.get(), this)) };
+
+            // Dereferencing might fault, and we don't generate code for
+            // references or pointers yet.
+            default:
+                return {};
+        }
+    }
+
+    Cost CostVisitor::visit(TernaryOp* n)
+    {
+        auto cost = add_cost(cost_of(n->condition.get(), this),
+            add_cost(cost_of(n->true_branch.get(), this), cost_of(n->false_branch.get(), this)));
+        return { add_cost(1, cost) };
+    }
+
+    // Numeric casts are a single instruction (or none at all).
+    Cost CostVisitor::visit(Cast* n) { return { add_cost(1, cost_of(n->left.get(), this)) }; }
+
+    unsigned evaluation_cost(Expression* e)
+    {
+        CostVisitor v;
+        return cost_of(e, &v);
+    }
+
+    bool should_use_select(TernaryOp* n)
+    {
+        auto t = evaluation_cost(n->true_branch.get());
+        auto f = evaluation_cost(n->false_branch.get());
+
+        return add_cost(t, f) <= select_cost_limit;
+    }
+}}
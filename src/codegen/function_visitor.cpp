@@ -6,121 +6,96 @@ namespace rhea { namespace codegen {
 
     // Most of these just call into the child nodes for now, searching for returns.
 
-    any FunctionVisitor::visit(If* n)
+    void FunctionVisitor::visit(If* n)
     {
         n->then_case->visit(this);
         n->else_case->visit(this);
-
-        return {};
     }
 
-    any FunctionVisitor::visit(While* n)
+    void FunctionVisitor::visit(While* n)
     {
         n->body->visit(this);
-
-        return {};
     }
 
-    any FunctionVisitor::visit(For* n)
+    void FunctionVisitor::visit(For* n)
     {
         n->body->visit(this);
-
-        return {};
     }
 
-    any FunctionVisitor::visit(With* n)
+    void FunctionVisitor::visit(With* n)
     {
         n->body->visit(this);
-
-        return {};
     }
 
-    any FunctionVisitor::visit(Match* n)
+    void FunctionVisitor::visit(Match* n)
     {
         std::for_each(n->cases.begin(), n->cases.end(),
             [&] (auto& c) { c->visit(this); }
         );
-
-        return {};
     }
 
-    any FunctionVisitor::visit(On* n)
+    void FunctionVisitor::visit(On* n)
     {
         n->body->visit(this);
-
-        return {};
     }
 
-    any FunctionVisitor::visit(When* n)
+    void FunctionVisitor::visit(When* n)
     {
         n->body->visit(this);
-
-        return {};
     }
 
-    any FunctionVisitor::visit(TypeCase* n)
+    void FunctionVisitor::visit(TypeCase* n)
     {
         n->body->visit(this);
-
-        return {};
     }
 
-    any FunctionVisitor::visit(Default* n)
+    void FunctionVisitor::visit(Default* n)
     {
         n->body->visit(this);
-
-        return {};
     }
 
-    any FunctionVisitor::visit(Def* n)
+    void FunctionVisitor::visit(Def* n)
     {
         n->body->visit(this);
-
-        return {};
     }
 
-    any FunctionVisitor::visit(GenericDef* n)
+    void FunctionVisitor::visit(GenericDef* n)
     {
         n->body->visit(this);
-
-        return {};
     }
 
-    any FunctionVisitor::visit(Return* n)
+    void FunctionVisitor::visit(Return* n)
     {
-        potential_return_types.push_back(n->value->expression_type());
-
-        return {};
+        if (generator != nullptr)
+        {
+            potential_return_types.push_back(generator->type_of(n->value.get()));
+        }
+        else
+        {
+            potential_return_types.push_back(n->value->expression_type());
+        }
     }
 
-    any FunctionVisitor::visit(Block* n)
+    void FunctionVisitor::visit(Block* n)
     {
         std::for_each(n->children.begin(), n->children.end(),
             [&] (auto& c) { c->visit(this); }
         );
-
-        return {};
     }
 
-    any FunctionVisitor::visit(Try* n)
+    void FunctionVisitor::visit(Try* n)
     {
         n->body->visit(this);
-
-        return {};
     }
 
-    any FunctionVisitor::visit(Catch* n)
+    void FunctionVisitor::visit(Catch* n)
     {
         n->body->visit(this);
-
-        return {};
     }
 
-    any FunctionVisitor::visit(Finally* n)
+    void FunctionVisitor::visit(Finally* n)
     {
         n->body->visit(this);
-
-        return {};
     }
 
 }}
\ No newline at end of file
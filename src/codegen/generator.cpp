@@ -1,22 +1,103 @@
 #include "codegen/generator.hpp"
 
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include <llvm/IR/PassInstrumentation.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Transforms/IPO/AlwaysInliner.h>
+
 namespace rhea { namespace codegen {
-    CodeGenerator::CodeGenerator() : visitor(this), context(), builder(context), 
-        module(std::make_unique<llvm::Module>("main", context)),
-        FPM({}), FAM({})
-    {
-        initialize_passes();
+    namespace {
+        llvm::PassBuilder::OptimizationLevel llvm_level(OptimizationLevel level)
+        {
+            switch (level)
+            {
+                case OptimizationLevel::O1: return llvm::PassBuilder::OptimizationLevel::O1;
+                case OptimizationLevel::O2: return llvm::PassBuilder::OptimizationLevel::O2;
+                case OptimizationLevel::O3: return llvm::PassBuilder::OptimizationLevel::O3;
+                case OptimizationLevel::Os: return llvm::PassBuilder::OptimizationLevel::Os;
+                case OptimizationLevel::Oz: return llvm::PassBuilder::OptimizationLevel::Oz;
+                default:                    return llvm::PassBuilder::OptimizationLevel::O0;
+            }
+        }
+
+        // Everything needed for one run of the new pass manager. The analysis
+        // managers are made fresh each time, so no stale results are left
+        // over from the last time the same code was optimized.
+        struct PassContext
+        {
+            PassContext(llvm::TargetMachine* tm, const OptimizationOptions& options)
+                : builder(tm, llvm::PipelineTuningOptions(), llvm::None, &callbacks)
+            {
+                auto& disabled = options.disabled_passes;
+                if (!disabled.empty())
+                {
+                    callbacks.registerBeforePassCallback(
+                        [&disabled] (llvm::StringRef name, llvm::Any) {
+                            return disabled.count(name.str()) == 0;
+                        }
+                    );
+                }
+
+                builder.registerModuleAnalyses(MAM);
+                builder.registerCGSCCAnalyses(CGAM);
+                builder.registerFunctionAnalyses(FAM);
+                builder.registerLoopAnalyses(LAM);
+                builder.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+            }
+
+            // Add a pass pipeline given as text.
+            template <typename PassManager>
+            void parse(PassManager& pm, const std::string& text)
+            {
+                if (auto err = builder.parsePassPipeline(pm, text))
+                {
+                    throw std::invalid_argument(
+                        fmt::format("Bad pass pipeline '{0}': {1}", text, llvm::toString(std::move(err)))
+                    );
+                }
+            }
+
+            // These have to be declared in this order, since the builder
+            // refers to the callbacks, and the managers to each other.
+            llvm::PassInstrumentationCallbacks callbacks;
+            llvm::PassBuilder builder;
+
+            llvm::LoopAnalysisManager LAM;
+            llvm::FunctionAnalysisManager FAM;
+            llvm::CGSCCAnalysisManager CGAM;
+            llvm::ModuleAnalysisManager MAM;
+        };
     }
 
+    CodeGenerator::CodeGenerator() : visitor(this), context(), builder(context), 
+        module(std::make_unique<llvm::Module>("main", context))
+    {}
+
     CodeGenerator::CodeGenerator(std::string module) : visitor(this), context(), builder(context),
-        module(std::make_unique<llvm::Module>(module, context)),
-        FPM({}), FAM({})
+        module(std::make_unique<llvm::Module>(module, context))
+    {}
+
+    llvm::Value* CodeGenerator::generate(ast::ASTNode* tree)
     {
-        initialize_passes();
+        has_inferred_types = false;
+
+        initialize_module();
+
+        auto result = tree->visit(&visitor);
+
+        finalize_module();
+
+        return result;
     }
 
-    util::any CodeGenerator::generate(ast::ASTNode* tree)
+    llvm::Value* CodeGenerator::generate(ast::ASTNode* tree, ast::NodeMap<types::TypeId> types)
     {
+        node_types = std::move(types);
+        has_inferred_types = true;
+
         initialize_module();
 
         auto result = tree->visit(&visitor);
@@ -26,42 +107,172 @@ namespace rhea { namespace codegen {
         return result;
     }
 
-    void CodeGenerator::initialize_passes()
+    const types::TypeInfo& CodeGenerator::type_of(ast::ASTNode* node)
     {
-        llvm::PassBuilder PB;
-        PB.registerFunctionAnalyses(FAM);
+        auto id = node_types.find(node);
+        if (id != nullptr && *id != 0)
+        {
+            return types::type_for_id(*id);
+        }
 
-        FPM = PB.buildFunctionSimplificationPipeline(
-            llvm::PassBuilder::OptimizationLevel::O1,
-            llvm::PassBuilder::ThinLTOPhase::None
-        );
+        // Inference sees every node we generate code for, so if one is
+        // missing, the types must be for some other tree. One it couldn't
+        // work out is just as much of a problem.
+        if (has_inferred_types)
+        {
+            if (id == nullptr)
+            {
+                throw std::invalid_argument("No inferred type for node " + node->to_string());
+            }
+
+            throw std::invalid_argument("Unknown inferred type for node " + node->to_string());
+        }
+
+        // Otherwise, ask the node. An unknown type (ID 0) isn't remembered,
+        // so we'll ask again next time, when it may know more. Only
+        // expressions can say what type they are.
+        auto expression = dynamic_cast<ast::Expression*>(node);
+        if (expression == nullptr)
+        {
+            return types::type_for_id(0);
+        }
+
+        auto type_id = types::intern_type(expression->expression_type());
+        if (type_id != 0)
+        {
+            node_types[node] = type_id;
+        }
+
+        return types::type_for_id(type_id);
     }
 
-    void CodeGenerator::initialize_module()
+    void CodeGenerator::set_type_of(ast::ASTNode* node, const types::TypeInfo& type)
+    {
+        node_types[node] = types::intern_type(type);
+    }
+
+    TargetSpec CodeGenerator::target_spec() const
+    {
+        auto spec = resolve_target(target);
+
+        switch (optimization.level)
+        {
+            case OptimizationLevel::O0:
+                spec.opt_level = llvm::CodeGenOpt::None;
+                break;
+            case OptimizationLevel::O1:
+                spec.opt_level = llvm::CodeGenOpt::Less;
+                break;
+            case OptimizationLevel::O3:
+                spec.opt_level = llvm::CodeGenOpt::Aggressive;
+                break;
+            default:
+                spec.opt_level = llvm::CodeGenOpt::Default;
+                break;
+        }
+
+        return spec;
+    }
+
+    void CodeGenerator::set_target_attributes(llvm::Function* fn)
     {
-        llvm::InitializeNativeTarget();
-        // llvm::InitializeAllTargets();
-        // llvm::InitializeAllTargetMCs();
-        llvm::InitializeNativeTargetAsmParser();
-        llvm::InitializeNativeTargetAsmPrinter();
+        auto tm = ensure_target_machine();
 
-        auto target_triple = llvm::sys::getDefaultTargetTriple();
-        std::string error;
-        auto target = llvm::TargetRegistry::lookupTarget(target_triple, error);
-        if (!target)
+        if (!fn->hasFnAttribute("target-cpu"))
         {
-            llvm::errs() << error;
-            throw std::invalid_argument(error);
+            fn->addFnAttr("target-cpu", tm->getTargetCPU());
         }
 
-        auto cpu = "generic";
-        auto features = "";
-        llvm::TargetOptions opts;
-        auto reloc_model = llvm::Optional<llvm::Reloc::Model>();
-        target_machine = target->createTargetMachine(target_triple, cpu, features, opts, reloc_model);
+        if (!fn->hasFnAttribute("target-features") && !tm->getTargetFeatureString().empty())
+        {
+            fn->addFnAttr("target-features", tm->getTargetFeatureString());
+        }
+
+    }
+
+    llvm::TargetMachine* CodeGenerator::ensure_target_machine()
+    {
+        if (target_machine == nullptr)
+        {
+            target_machine = target_machines->get(target_spec());
+        }
+
+        return target_machine;
+    }
+
+    template <>
+    llvm::Module* CodeGenerator::optimize(llvm::Module* code)
+    {
+        for (auto& fn : *code)
+        {
+            if (!fn.isDeclaration())
+            {
+                set_target_attributes(&fn);
+            }
+        }
+
+        PassContext pc { target_machine, optimization };
+        llvm::ModulePassManager MPM;
+
+        if (optimization.level == OptimizationLevel::O0)
+        {
+            // The O0 pipeline doesn't do much, but `alwaysinline` still
+            // has to be honored.
+            MPM.addPass(llvm::AlwaysInlinerPass());
+        }
+        else
+        {
+            MPM = pc.builder.buildPerModuleDefaultPipeline(llvm_level(optimization.level));
+        }
+
+        for (auto& p : optimization.extra_passes)
+        {
+            pc.parse(MPM, p);
+        }
+
+        MPM.run(*code, pc.MAM);
+
+        return code;
+    }
+
+    template <>
+    llvm::Function* CodeGenerator::optimize(llvm::Function* code)
+    {
+        if (code->isDeclaration())
+        {
+            return code;
+        }
+
+        set_target_attributes(code);
+
+        PassContext pc { target_machine, optimization };
+        llvm::FunctionPassManager FPM;
+
+        if (optimization.level != OptimizationLevel::O0)
+        {
+            FPM = pc.builder.buildFunctionSimplificationPipeline(
+                llvm_level(optimization.level),
+                llvm::PassBuilder::ThinLTOPhase::None
+            );
+        }
+
+        for (auto& p : optimization.extra_passes)
+        {
+            pc.parse(FPM, p);
+        }
+
+        FPM.run(*code, pc.FAM);
+
+        return code;
+    }
+
+    void CodeGenerator::initialize_module()
+    {
+        // Target machines are cached, so this is cheap after the first time.
+        target_machine = target_machines->get(target_spec());
 
         module->setDataLayout(target_machine->createDataLayout());
-        module->setTargetTriple(target_triple);
+        module->setTargetTriple(target_machine->getTargetTriple().str());
 
         // Set up a top-level function
         auto ft = llvm::FunctionType::get(
@@ -90,6 +301,49 @@ namespace rhea { namespace codegen {
             builder.CreateRetVoid();
             llvm::verifyFunction(*fn);
         }
+
+        for (auto& f : *module)
+        {
+            if (!f.isDeclaration())
+            {
+                set_target_attributes(&f);
+            }
+        }
+    }
+
+    std::unique_ptr<llvm::Module> CodeGenerator::start_module(std::string name)
+    {
+        auto old = std::move(module);
+        module = std::make_unique<llvm::Module>(name, context);
+
+        return old;
+    }
+
+    llvm::GlobalValue::LinkageTypes CodeGenerator::global_linkage() const
+    {
+        return export_globals
+            ? llvm::GlobalValue::ExternalLinkage
+            : llvm::GlobalValue::InternalLinkage;
+    }
+
+    llvm::GlobalVariable* CodeGenerator::find_global(const std::string& name, const types::TypeInfo& type)
+    {
+        auto gvar = module->getGlobalVariable(name, true);
+
+        if (gvar == nullptr)
+        {
+            // No initializer makes this a declaration.
+            gvar = new llvm::GlobalVariable(
+                *module,
+                llvm_for_type(type),
+                false,
+                llvm::GlobalValue::ExternalLinkage,
+                nullptr,
+                name
+            );
+        }
+
+        return gvar;
     }
 
     void CodeGenerator::create_scope(std::string name)
@@ -104,7 +358,7 @@ namespace rhea { namespace codegen {
         allocation_manager.pop();
     }
 
-    llvm::Type* CodeGenerator::llvm_for_type(types::TypeInfo ti)
+    llvm::Type* CodeGenerator::llvm_for_type(const types::TypeInfo& ti)
     {
         return util::visit(TypeBuilder{this}, ti.type());
     }
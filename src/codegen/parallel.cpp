@@ -0,0 +1,134 @@
+#include "codegen/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace rhea { namespace codegen {
+    namespace {
+        unsigned thread_count(unsigned requested, std::size_t units)
+        {
+            std::size_t threads = requested;
+            if (threads == 0)
+            {
+                threads = std::thread::hardware_concurrency();
+            }
+
+            // There's no point in having more threads than units.
+            return static_cast<unsigned>(std::max<std::size_t>(1, std::min(threads, units)));
+        }
+
+        CompiledUnit compile_unit(const CompilationUnit& unit, const ParallelOptions& options,
+            TargetMachineCache& machines)
+        {
+            CodeGenerator generator { unit.name };
+
+            generator.target_machines = &machines;
+            generator.target = options.target;
+            generator.optimization = options.optimization;
+            generator.export_globals = options.export_globals;
+
+            // Dense symbol IDs depend on the order symbols are first seen,
+            // which depends on how the threads are scheduled.
+            generator.hashed_symbols = true;
+
+            if (unit.types.empty())
+            {
+                generator.generate(unit.tree);
+            }
+            else
+            {
+                generator.generate(unit.tree, unit.types);
+            }
+            generator.optimize(generator.module.get());
+
+            return { unit.name, emit_object(generator.module.get(), generator.target_machine) };
+        }
+    }
+
+    std::vector<CompiledUnit> compile_parallel(const std::vector<CompilationUnit>& units,
+        const ParallelOptions& options)
+    {
+        std::vector<CompiledUnit> results (units.size());
+        std::vector<std::exception_ptr> errors (units.size());
+        std::atomic<std::size_t> next_unit { 0 };
+
+        // Units are handed out one at a time, so a worker that gets a small
+        // one just takes another, and a few big units don't hold up the rest.
+        auto worker = [&] {
+            // Creating a target machine is expensive, so a worker keeps its
+            // own for all the units it compiles.
+            TargetMachineCache machines;
+
+            for (auto i = next_unit++; i < units.size(); i = next_unit++)
+            {
+                try
+                {
+                    results[i] = compile_unit(units[i], options, machines);
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+            }
+        };
+
+        // The calling thread is one of the workers.
+        auto threads = thread_count(options.threads, units.size());
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t)
+        {
+            try
+            {
+                pool.emplace_back(worker);
+            }
+            catch (const std::system_error&)
+            {
+                // We'll just have to make do with the threads we've got.
+                break;
+            }
+        }
+
+        worker();
+
+        for (auto& t : pool)
+        {
+            t.join();
+        }
+
+        for (auto& e : errors)
+        {
+            if (e)
+            {
+                std::rethrow_exception(e);
+            }
+        }
+
+        return results;
+    }
+
+    std::string emit_object(llvm::Module* module, llvm::TargetMachine* tm)
+    {
+        llvm::SmallString<0> output;
+        llvm::raw_svector_ostream ostr(output);
+
+        llvm::legacy::PassManager pm;
+
+        if (tm->addPassesToEmitFile(pm, ostr, nullptr, llvm::CGFT_ObjectFile))
+        {
+            throw std::invalid_argument("Unable to emit object files for " + tm->getTargetTriple().str());
+        }
+
+        pm.run(*module);
+
+        return output.str().str();
+    }
+}}
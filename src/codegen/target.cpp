@@ -0,0 +1,146 @@
+#include "codegen/target.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/Triple.h>
+
+#include <llvm/Support/Host.h>
+#include <llvm/Support/TargetRegistry.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetOptions.h>
+
+namespace rhea { namespace codegen {
+    void initialize_native_target()
+    {
+        static std::once_flag initialized;
+
+        std::call_once(initialized, [] {
+            llvm::InitializeNativeTarget();
+            llvm::InitializeNativeTargetAsmParser();
+            llvm::InitializeNativeTargetAsmPrinter();
+        });
+    }
+
+    std::string host_triple()
+    {
+        return llvm::sys::getDefaultTargetTriple();
+    }
+
+    std::string host_cpu_features()
+    {
+        llvm::StringMap<bool> host_features;
+        if (!llvm::sys::getHostCPUFeatures(host_features))
+        {
+            return "";
+        }
+
+        std::vector<std::string> flags;
+        for (auto& f : host_features)
+        {
+            flags.push_back((f.getValue() ? "+" : "-") + f.getKey().str());
+        }
+
+        // Sort by name, ignoring the sign.
+        std::sort(flags.begin(), flags.end(), [] (const std::string& a, const std::string& b) {
+            return a.compare(1, std::string::npos, b, 1, std::string::npos) < 0;
+        });
+
+        std::string result;
+        for (auto& f : flags)
+        {
+            if (!result.empty()) result += ',';
+            result += f;
+        }
+
+        return result;
+    }
+
+    TargetSpec resolve_target(const TargetSelection& selection)
+    {
+        TargetSpec spec;
+        spec.triple = selection.triple.empty() ? host_triple() : selection.triple;
+
+        if (selection.cpu == "native")
+        {
+            spec.cpu = llvm::sys::getHostCPUName().str();
+            spec.features = host_cpu_features();
+        }
+        else if (!selection.cpu.empty())
+        {
+            spec.cpu = selection.cpu;
+        }
+
+        if (!selection.features.empty())
+        {
+            if (!spec.features.empty()) spec.features += ',';
+            spec.features += selection.features;
+        }
+
+        return spec;
+    }
+
+    TargetMachineCache& TargetMachineCache::global()
+    {
+        static TargetMachineCache cache;
+        return cache;
+    }
+
+    llvm::TargetMachine* TargetMachineCache::get(const TargetSpec& spec)
+    {
+        initialize_native_target();
+
+        std::lock_guard<std::mutex> lock { m_mutex };
+
+        auto it = m_machines.find(spec);
+        if (it != m_machines.end())
+        {
+            return it->second.get();
+        }
+
+        // Only the native target is initialized (and linked in), so any
+        // other architecture would fail below with a less helpful message.
+        llvm::Triple triple { spec.triple };
+        llvm::Triple host { host_triple() };
+        if (triple.getArch() != host.getArch())
+        {
+            throw std::invalid_argument("Can't generate code for " + spec.triple +
+                ": only the host architecture (" + host.getArchName().str() + ") is supported");
+        }
+
+        std::string error;
+        auto target = llvm::TargetRegistry::lookupTarget(spec.triple, error);
+        if (!target)
+        {
+            llvm::errs() << error;
+            throw std::invalid_argument(error);
+        }
+
+        llvm::TargetOptions opts;
+        std::unique_ptr<llvm::TargetMachine> machine {
+            target->createTargetMachine(
+                spec.triple, spec.cpu, spec.features, opts,
+                spec.reloc_model, llvm::None, spec.opt_level
+            )
+        };
+
+        if (!machine)
+        {
+            throw std::invalid_argument("Unable to create target machine for " + spec.triple);
+        }
+
+        auto result = machine.get();
+        m_machines.emplace(spec, std::move(machine));
+
+        return result;
+    }
+
+    std::size_t TargetMachineCache::size() const
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        return m_machines.size();
+    }
+}}
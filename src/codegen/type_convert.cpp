@@ -1,6 +1,8 @@
 #include "codegen/type_convert.hpp"
 #include "codegen/generator.hpp"
 
+#include <llvm/IR/Constants.h>
+
 namespace rhea { namespace codegen {
     using llvm::Value;
     using llvm::Type;
@@ -8,7 +10,7 @@ namespace rhea { namespace codegen {
     using types::SimpleType;
     using types::BasicType;
 
-    Value* convert_type(CodeGenerator* gen, Value* value, TypeInfo from, TypeInfo to, bool explicit_ = false)
+    Value* convert_type(CodeGenerator* gen, Value* value, const TypeInfo& from, const TypeInfo& to, bool explicit_)
     {
         // Test to see if an implicit conversion is possible. If not, throw an error.
         if (!explicit_ && !internal::can_implicitly_convert(from, to))
@@ -26,197 +28,83 @@ namespace rhea { namespace codegen {
     }
 
     namespace internal {
-        bool can_implicitly_convert(TypeInfo from, TypeInfo to)
+        bool can_implicitly_convert(const TypeInfo& from, const TypeInfo& to)
         {
             auto from_simple = util::get_if<SimpleType>(&(from.type()));
             auto to_simple = util::get_if<SimpleType>(&(to.type()));
 
-            // Implicit conversion is a no-go by default.
-            auto cvt = false;
-
-            // Most implicit conversions are between simple types.
+            // Most implicit conversions are between simple types, and the
+            // conversion table knows all about those.
             if (from_simple != nullptr && to_simple != nullptr)
             {
-                // We can always convert from a type to itself, so get that out of the way.
-                if (from_simple->type == to_simple->type)
-                {
-                    cvt = true;
-                }
-                else
-                {
-                    // Otherwise, the only implicit conversions allowed are:
-                    // (u)byte -> (u)integer or (u)long;
-                    // float -> double
-                    // (unsigned <-> signed is difficult because of overflow)
-                    switch (from_simple->type)
-                    {
-                        case BasicType::Byte:
-                            cvt = (to_simple->type == BasicType::Integer || to_simple->type == BasicType::Long) ;
-                            break;
-                        case BasicType::Integer:
-                            cvt = (to_simple->type == BasicType::Long);
-                            break;
-                        case BasicType::Float:
-                            cvt = (to_simple->type == BasicType::Double);
-                            break;
-                        default:
-                            break;
-                    }
-                }
+                return types::is_implicitly_convertible(from_simple->type, to_simple->type);
             }
 
             // TODO: Handle references. These should be transparent to user code.
 
-            return cvt;
+            return false;
         }
 
         template <>
         Value* convert(CodeGenerator* gen, Value* value, SimpleType from, SimpleType to)
         {
-            using llvm::Type;
+            using types::CastOp;
+            using types::Conversion;
+
+            auto rule = types::conversion_rule(from.type, to.type);
 
-            // We'll get the trivial cased out of the way first.
-            if (from.type == to.type)
+            if (rule.kind == Conversion::None)
+            {
+                throw unimplemented_type(fmt::format("Unable to convert from {0} to {1}",
+                    types::to_string(from), types::to_string(to)
+                ));
+            }
+
+            // Identities, coercions (whose real conversion was done already),
+            // and signed <-> unsigned of the same size don't need any code.
+            if (rule.op == CastOp::None)
             {
                 return value;
             }
 
-            // If we don't do anything, then we'll just return the original value,
-            // but we'll most likely throw an exception if bad things happen.
-            Value* ret = value;
+            auto& builder = gen->builder;
 
-            // We swtich on the *destination* type first, because that makes for clearer code.
-            // Any inner switches are on the source type. Messy, but workable. Note that we already
-            // accounted for the case of equivalent types above, so they're not included here.
-            switch (to.type)
+            // Conversions to boolean are comparisons, not casts.
+            if (rule.op == CastOp::IntToBool)
             {
-                case BasicType::Integer:
-                {
-                    switch (from.type)
-                    {
-                        case BasicType::UnsignedInteger:
-                            // No codegen needed
-                            break;
-
-                        case BasicType::Long:
-                        case BasicType::UnsignedLong:
-                            ret = gen->builder.CreateTrunc(value, Type::getInt32Ty(gen->context), "integercvt");
-                            break;
-                        
-                        case BasicType::Byte:
-                            ret = gen->builder.CreateSExt(value, Type::getInt32Ty(gen->context), "integercvt");
-                            break;
-
-                        case BasicType::UnsignedByte:
-                        case BasicType::Boolean:
-                            ret = gen->builder.CreateZExt(value, Type::getInt32Ty(gen->context), "integercvt");
-                            break;
-
-                        case BasicType::Float:
-                            ret = gen->builder.CreateFPToSI(value, Type::getInt32Ty(gen->context), "integercvt");
-                            break;
-
-                        case BasicType::Double:
-                            ret = gen->builder.CreateFPToSI(value, Type::getInt32Ty(gen->context), "integercvt");
-                            break;
-                            
-                        default:
-                            throw unimplemented_type("Unable to convert from type " + types::to_string(to));
-                    }
-                    break;
-                }
-
-                case BasicType::Byte:
-                {
-                    break;
-                }
-
-                case BasicType::Long:
-                {
-                    break;
-                }
-
-                case BasicType::UnsignedInteger:
-                {
-                    break;
-                }
-
-                case BasicType::UnsignedByte:
-                {
-                    break;
-                }
-
-                case BasicType::UnsignedLong:
-                {
-                    break;
-                }
-                
-                case BasicType::Float:
-                {
-                    switch (from.type)
-                    {
-                        case BasicType::Byte:
-                        case BasicType::Integer:
-                        case BasicType::Long:
-                            ret = gen->builder.CreateSIToFP(value, Type::getFloatTy(gen->context), "floatcvt");
-                            break;
-
-                        case BasicType::Boolean:
-                        case BasicType::UnsignedByte:
-                        case BasicType::UnsignedInteger:
-                        case BasicType::UnsignedLong:
-                            ret = gen->builder.CreateUIToFP(value, Type::getFloatTy(gen->context), "floatcvt");
-                            break;
-
-                        case BasicType::Double:
-                            ret = gen->builder.CreateFPTrunc(value, Type::getFloatTy(gen->context), "floatcvt");
-                            break;
-                            
-                        default:
-                            throw unimplemented_type("Unable to convert from " + types::to_string(to));
-                    }
-                    break;
-                }
-
-                case BasicType::Double:
-                {
-                    switch (from.type)
-                    {
-                        case BasicType::Byte:
-                        case BasicType::Integer:
-                        case BasicType::Long:
-                            ret = gen->builder.CreateSIToFP(value, Type::getDoubleTy(gen->context), "doublecvt");
-                            break;
-
-                        case BasicType::Boolean:
-                        case BasicType::UnsignedByte:
-                        case BasicType::UnsignedInteger:
-                        case BasicType::UnsignedLong:
-                            ret = gen->builder.CreateUIToFP(value, Type::getDoubleTy(gen->context), "doublecvt");
-                            break;
-
-                        case BasicType::Float:
-                            ret = gen->builder.CreateFPExt(value, Type::getDoubleTy(gen->context), "doublecvt");
-                            break;
-
-                        default:
-                            throw unimplemented_type("Unable to convert from " + types::to_string(to));
-                    }
-                    break;
-                }
-
-                case BasicType::Boolean:
-                {
-                    break;
-                }
-
-                default:
-                    break;
+                return builder.CreateICmpNE(value,
+                    llvm::Constant::getNullValue(value->getType()), "boolcvt");
+            }
+            else if (rule.op == CastOp::FPToBool)
+            {
+                return builder.CreateFCmpUNE(value,
+                    llvm::Constant::getNullValue(value->getType()), "boolcvt");
             }
 
             // TODO: Strings, and maybe some kind of explicitly unsafe pointer conversion?
 
-            return ret;
+            return builder.CreateCast(llvm_cast_op(rule.op), value, gen->llvm_for_type(to), "cvt");
+        }
+
+        llvm::Instruction::CastOps llvm_cast_op(types::CastOp op)
+        {
+            using types::CastOp;
+            using llvm::Instruction;
+
+            switch (op)
+            {
+                case CastOp::Trunc:     return Instruction::Trunc;
+                case CastOp::ZExt:      return Instruction::ZExt;
+                case CastOp::SExt:      return Instruction::SExt;
+                case CastOp::FPTrunc:   return Instruction::FPTrunc;
+                case CastOp::FPExt:     return Instruction::FPExt;
+                case CastOp::FPToUI:    return Instruction::FPToUI;
+                case CastOp::FPToSI:    return Instruction::FPToSI;
+                case CastOp::UIToFP:    return Instruction::UIToFP;
+                case CastOp::SIToFP:    return Instruction::SIToFP;
+                default:
+                    throw unimplemented_type("Conversion isn't a simple cast");
+            }
         }
     }
-}}
\ No newline at end of file
+}}
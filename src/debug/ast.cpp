@@ -4,14 +4,39 @@
 #include "grammar/expression.hpp"
 #include "debug/parse_tree.hpp"
 #include "debug/build_ast.hpp"
+#include "source/source_manager.hpp"
 
-int main()
+int main(int argc, char* argv[])
 {
+    if (argc > 1)
+    {
+        int status = 0;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            auto file = rhea::debug::parse_file(argv[i]);
+
+            if (file)
+            {
+                auto ast = file->ast();
+                rhea::debug::dump_ast(std::cout, ast);
+                std::cout << '\n';
+            }
+            else
+            {
+                status = 1;
+            }
+        }
+
+        return status;
+    }
+
     std::string input;
 
     while (std::getline(std::cin, input))
     {
         auto in = rhea::debug::input_from_string(input);
+        rhea::source::ScopedBuffer buffer { *in };
         auto tree = rhea::debug::parse<rhea::ast::parser_node>(*in);
         
         if (tree)
@@ -0,0 +1,115 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+
+#include <tao/pegtl.hpp>
+#include <tao/pegtl/contrib/parse_tree.hpp>
+
+#include <fmt/format.h>
+
+#include "ast.hpp"
+#include "grammar.hpp"
+
+/*
+ * Benchmark for the AST builders. This compares the regular two-phase
+ * builder (PEGTL parse tree, then AST) against the direct builder on a
+ * large, generated block of expression-heavy statements.
+ *
+ * Usage: rhea_debug_bench_ast [statements] [runs]
+ */
+namespace {
+    namespace pt = tao::pegtl::parse_tree;
+    namespace gr = rhea::grammar;
+    namespace ast = rhea::ast;
+
+    using clock_type = std::chrono::steady_clock;
+
+    // Make a big statement block, with enough variety to hit most of the
+    // expression grammar.
+    std::string generate_source(int count)
+    {
+        std::string source { "{\n" };
+
+        for (int i = 0; i < count; ++i)
+        {
+            switch (i % 4)
+            {
+                case 0:
+                    source += fmt::format("var x{0} = (a{0} + {0}) * b.c[{0}] - f(x, {0}_l) ** 2;\n", i);
+                    break;
+                case 1:
+                    source += fmt::format("x{0} += if y > {0} then z as integer else -w{0};\n", i);
+                    break;
+                case 2:
+                    source += fmt::format("const k{0} = [1, 2, {0}] & 0x{0:x} or not done{0};\n", i);
+                    break;
+                case 3:
+                    source += fmt::format("if a{0} << 2 >= b {{ g(n: @sym, m: 'str{0}'); }} else {{ h(); }}\n", i);
+                    break;
+            }
+        }
+
+        source += "}\n";
+        return source;
+    }
+
+    std::unique_ptr<ast::Statement> build_two_phase(const std::string& source)
+    {
+        tao::pegtl::string_input<> in(source, "bench");
+        auto tree = pt::parse<gr::stmt_or_block, ast::parser_node, ast::tree_selector>(in);
+        return ast::internal::create_statement_node(tree->children.front().get());
+    }
+
+    std::unique_ptr<ast::Statement> build_direct(const std::string& source)
+    {
+        tao::pegtl::string_input<> in(source, "bench");
+        return ast::build_statement_direct(in);
+    }
+
+    // Best time over a number of runs, in milliseconds.
+    template <typename F>
+    double time_best(F&& f, int runs)
+    {
+        double best = 0.0;
+
+        for (int i = 0; i < runs; ++i)
+        {
+            auto start = clock_type::now();
+            auto result = f();
+            std::chrono::duration<double, std::milli> elapsed = clock_type::now() - start;
+
+            if (i == 0 || elapsed.count() < best)
+            {
+                best = elapsed.count();
+            }
+        }
+
+        return best;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int count = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int runs = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    auto source = generate_source(count);
+
+    // Make sure both builders agree before timing anything.
+    if (build_two_phase(source)->to_string() != build_direct(source)->to_string())
+    {
+        std::cerr << "Builders produced different ASTs\n";
+        return 1;
+    }
+
+    auto two_phase = time_best([&] { return build_two_phase(source); }, runs);
+    auto direct = time_best([&] { return build_direct(source); }, runs);
+
+    std::cout << fmt::format("{0} statements, {1} bytes, best of {2} runs\n",
+        count, source.size(), runs);
+    std::cout << fmt::format("two-phase: {0:10.2f} ms\n", two_phase);
+    std::cout << fmt::format("direct:    {0:10.2f} ms ({1:.2f}x)\n", direct, two_phase / direct);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <string>
+
+#include "grammar/expression.hpp"
+#include "debug/parse_tree.hpp"
+#include "debug/build_ast.hpp"
+#include "source/source_manager.hpp"
+#include "codegen/generator.hpp"
+#include "fold/constant_fold.hpp"
+#include "inference/engine.hpp"
+#include "jit/engine.hpp"
+#include "jit/repl.hpp"
+#include "state/module_tree.hpp"
+
+/*
+ * Run Rhea code in-process with the JIT, without linking anything. Files
+ * named on the command line are run as whole programs; otherwise, this is
+ * a REPL, and each line is compiled and run as it's entered.
+ */
+int main(int argc, char* argv[])
+{
+    if (argc > 1)
+    {
+        int status = 0;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            auto file = rhea::debug::parse_file(argv[i]);
+
+            if (!file)
+            {
+                status = 1;
+                continue;
+            }
+
+            auto ast = file->ast();
+            auto program = dynamic_cast<rhea::ast::Program*>(ast);
+            auto node = (program != nullptr) ? program->children.front().get() : ast;
+
+            // Folding replaces nodes, so it has to come before inference.
+            rhea::fold::ConstantFolder folder;
+            folder.fold(node);
+
+            rhea::inference::TypeEngine types;
+            types.module_scopes["main"] = std::make_unique<rhea::state::ModuleScopeTree>("main");
+            types.visitor.module_scope = types.module_scopes["main"].get();
+            node->visit(&types.visitor);
+
+            rhea::codegen::CodeGenerator generator { "main" };
+            generator.generate(node, types.finalize());
+
+            rhea::jit::Engine engine;
+            engine.add(generator);
+            status = engine.run("main");
+        }
+
+        return status;
+    }
+
+    rhea::jit::Session session;
+    std::string input;
+
+    while (std::getline(std::cin, input))
+    {
+        auto in = rhea::debug::input_from_string(input);
+
+        // The session keeps every tree it's given, so their locations have
+        // to stay valid for as long as it runs.
+        rhea::source::SourceManager::global().add_input(*in);
+        auto tree = rhea::debug::parse<rhea::ast::parser_node>(*in);
+
+        if (!tree)
+        {
+            std::cout << "Parse error\n";
+            continue;
+        }
+
+        try
+        {
+            session.evaluate(rhea::debug::build_ast(tree.get()));
+        }
+        catch (std::exception& e)
+        {
+            std::cout << "Error: " << e.what() << '\n';
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,740 @@
+#include "fold/constant_fold.hpp"
+
+#include <cmath>
+#include <limits>
+
+#include "types/conversion.hpp"
+
+namespace rhea { namespace fold {
+    using namespace rhea::ast;
+    using types::BasicType;
+
+    namespace {
+        types::internal::numeric_info info(BasicType t)
+        {
+            return types::internal::numeric_info_for(t);
+        }
+
+        bool is_integral(BasicType t)
+        {
+            return types::is_integral_type(t);
+        }
+
+        bool is_floating(BasicType t)
+        {
+            return t == BasicType::Float || t == BasicType::Double;
+        }
+
+        // Wrap a value to the width of its type, the same as the hardware
+        // (and LLVM) would.
+        ConstantValue normalize(ConstantValue v)
+        {
+            if (v.type == BasicType::Float)
+            {
+                v.floating = static_cast<float>(v.floating);
+            }
+            else if (v.type == BasicType::Boolean)
+            {
+                v.integer = (v.integer & 1u);
+            }
+            else if (is_integral(v.type))
+            {
+                auto i = info(v.type);
+                if (i.bits < 64)
+                {
+                    auto mask = (std::uint64_t(1) << i.bits) - 1;
+                    v.integer &= mask;
+
+                    auto sign = std::uint64_t(1) << (i.bits - 1);
+                    if (i.is_signed && (v.integer & sign) != 0)
+                    {
+                        v.integer |= ~mask;
+                    }
+                }
+            }
+
+            return v;
+        }
+
+        ConstantValue make_integer(BasicType t, std::uint64_t value)
+        {
+            ConstantValue v;
+            v.type = t;
+            v.integer = value;
+            return normalize(v);
+        }
+
+        ConstantValue make_floating(BasicType t, double value)
+        {
+            ConstantValue v;
+            v.type = t;
+            v.floating = value;
+            return normalize(v);
+        }
+
+        ConstantValue make_boolean(bool value)
+        {
+            return make_integer(BasicType::Boolean, value ? 1u : 0u);
+        }
+
+        std::int64_t as_signed(const ConstantValue& v)
+        {
+            return static_cast<std::int64_t>(v.integer);
+        }
+
+        // The smallest value of a signed type, for spotting `min / -1`.
+        std::uint64_t signed_min(BasicType t)
+        {
+            return std::uint64_t(-1) << (info(t).bits - 1);
+        }
+
+        // Can a float be converted to an integer type without going out of
+        // range? LLVM gives poison if it can't, so we don't fold those.
+        bool fits_integer(double d, BasicType t)
+        {
+            if (std::isnan(d))
+            {
+                return false;
+            }
+
+            auto i = info(t);
+            auto truncated = std::trunc(d);
+
+            if (i.is_signed)
+            {
+                auto limit = std::ldexp(1.0, i.bits - 1);
+                return truncated >= -limit && truncated < limit;
+            }
+            else
+            {
+                auto limit = std::ldexp(1.0, i.bits);
+                return truncated > -1.0 && truncated < limit;
+            }
+        }
+
+        util::optional<ConstantValue> fold_integral(BinaryOperators op, const ConstantValue& l, const ConstantValue& r)
+        {
+            auto t = l.type;
+            auto is_signed = info(t).is_signed;
+            auto bits = info(t).bits;
+
+            switch (op)
+            {
+                case BinaryOperators::Add:
+                    return make_integer(t, l.integer + r.integer);
+                case BinaryOperators::Subtract:
+                    return make_integer(t, l.integer - r.integer);
+                case BinaryOperators::Multiply:
+                    return make_integer(t, l.integer * r.integer);
+
+                case BinaryOperators::Divide:
+                case BinaryOperators::Modulus:
+                    // Division by zero and overflowing signed division are
+                    // undefined, so leave them for runtime.
+                    if (r.integer == 0 ||
+                        (is_signed && l.integer == signed_min(t) && as_signed(r) == -1))
+                    {
+                        return {};
+                    }
+
+                    if (is_signed)
+                    {
+                        return make_integer(t, static_cast<std::uint64_t>(op == BinaryOperators::Divide
+                            ? as_signed(l) / as_signed(r)
+                            : as_signed(l) % as_signed(r)));
+                    }
+                    else
+                    {
+                        return make_integer(t, op == BinaryOperators::Divide
+                            ? l.integer / r.integer
+                            : l.integer % r.integer);
+                    }
+
+                case BinaryOperators::LeftShift:
+                case BinaryOperators::RightShift:
+                {
+                    // Shifting by the width or more is undefined, too.
+                    if ((info(r.type).is_signed && as_signed(r) < 0) || r.integer >= bits)
+                    {
+                        return {};
+                    }
+
+                    if (op == BinaryOperators::LeftShift)
+                    {
+                        return make_integer(t, l.integer << r.integer);
+                    }
+
+                    // Signed values are stored sign-extended, so shifting
+                    // the whole 64 bits gives the right answer either way.
+                    return make_integer(t, is_signed
+                        ? static_cast<std::uint64_t>(as_signed(l) >> r.integer)
+                        : l.integer >> r.integer);
+                }
+
+                case BinaryOperators::BitAnd:
+                    return make_integer(t, l.integer & r.integer);
+                case BinaryOperators::BitOr:
+                    return make_integer(t, l.integer | r.integer);
+                case BinaryOperators::BitXor:
+                    return make_integer(t, l.integer ^ r.integer);
+
+                case BinaryOperators::Equals:
+                    return make_boolean(l.integer == r.integer);
+                case BinaryOperators::NotEqual:
+                    return make_boolean(l.integer != r.integer);
+                case BinaryOperators::LessThan:
+                    return make_boolean(is_signed ? as_signed(l) < as_signed(r) : l.integer < r.integer);
+                case BinaryOperators::LessThanOrEqual:
+                    return make_boolean(is_signed ? as_signed(l) <= as_signed(r) : l.integer <= r.integer);
+                case BinaryOperators::GreaterThan:
+                    return make_boolean(is_signed ? as_signed(l) > as_signed(r) : l.integer > r.integer);
+                case BinaryOperators::GreaterThanOrEqual:
+                    return make_boolean(is_signed ? as_signed(l) >= as_signed(r) : l.integer >= r.integer);
+
+                default:
+                    return {};
+            }
+        }
+
+        util::optional<ConstantValue> fold_floating(BinaryOperators op, const ConstantValue& l, const ConstantValue& r)
+        {
+            auto t = l.type;
+            auto a = l.floating;
+            auto b = r.floating;
+
+            // Comparisons are all ordered, like the ones codegen uses: any
+            // comparison involving NaN is false.
+            auto ordered = !std::isnan(a) && !std::isnan(b);
+
+            switch (op)
+            {
+                // Doing these in double and rounding gives the correctly
+                // rounded float result, so one path works for both types.
+                case BinaryOperators::Add:
+                    return make_floating(t, a + b);
+                case BinaryOperators::Subtract:
+                    return make_floating(t, a - b);
+                case BinaryOperators::Multiply:
+                    return make_floating(t, a * b);
+                case BinaryOperators::Divide:
+                    return make_floating(t, a / b);
+                case BinaryOperators::Modulus:
+                    return make_floating(t, std::fmod(a, b));
+
+                case BinaryOperators::Equals:
+                    return make_boolean(ordered && a == b);
+                case BinaryOperators::NotEqual:
+                    return make_boolean(ordered && a != b);
+                case BinaryOperators::LessThan:
+                    return make_boolean(ordered && a < b);
+                case BinaryOperators::LessThanOrEqual:
+                    return make_boolean(ordered && a <= b);
+                case BinaryOperators::GreaterThan:
+                    return make_boolean(ordered && a > b);
+                case BinaryOperators::GreaterThanOrEqual:
+                    return make_boolean(ordered && a >= b);
+
+                default:
+                    return {};
+            }
+        }
+
+        // The signed type with the same width as an unsigned one, for
+        // unary minus.
+        BasicType signed_counterpart(BasicType t)
+        {
+            switch (t)
+            {
+                case BasicType::UnsignedByte:       return BasicType::Byte;
+                case BasicType::UnsignedInteger:    return BasicType::Integer;
+                case BasicType::UnsignedLong:       return BasicType::Long;
+                default:                            return t;
+            }
+        }
+    }
+
+    util::optional<ConstantValue> constant_value(Expression* e)
+    {
+        if (auto b = dynamic_cast<Boolean*>(e)) return make_boolean(b->value);
+
+        if (auto i = dynamic_cast<Integer*>(e)) return make_integer(i->type, static_cast<std::uint64_t>(i->value));
+        if (auto i = dynamic_cast<Byte*>(e)) return make_integer(i->type, static_cast<std::uint64_t>(i->value));
+        if (auto i = dynamic_cast<Long*>(e)) return make_integer(i->type, static_cast<std::uint64_t>(i->value));
+        if (auto i = dynamic_cast<UnsignedInteger*>(e)) return make_integer(i->type, i->value);
+        if (auto i = dynamic_cast<UnsignedByte*>(e)) return make_integer(i->type, i->value);
+        if (auto i = dynamic_cast<UnsignedLong*>(e)) return make_integer(i->type, i->value);
+
+        if (auto f = dynamic_cast<Float*>(e)) return make_floating(f->type, f->value);
+        if (auto f = dynamic_cast<Double*>(e)) return make_floating(f->type, f->value);
+
+        return {};
+    }
+
+    expression_ptr make_literal(const ConstantValue& v)
+    {
+        switch (v.type)
+        {
+            case BasicType::Boolean:
+                return make_expression<Boolean>(v.integer != 0);
+            case BasicType::Integer:
+                return make_expression<Integer>(static_cast<std::int32_t>(as_signed(v)));
+            case BasicType::Byte:
+                return make_expression<Byte>(static_cast<std::int8_t>(as_signed(v)));
+            case BasicType::Long:
+                return make_expression<Long>(as_signed(v));
+            case BasicType::UnsignedInteger:
+                return make_expression<UnsignedInteger>(static_cast<std::uint32_t>(v.integer));
+            case BasicType::UnsignedByte:
+                return make_expression<UnsignedByte>(static_cast<std::uint8_t>(v.integer));
+            case BasicType::UnsignedLong:
+                return make_expression<UnsignedLong>(v.integer);
+            case BasicType::Float:
+                return make_expression<Float>(static_cast<float>(v.floating));
+            case BasicType::Double:
+                return make_expression<Double>(v.floating);
+            default:
+                return nullptr;
+        }
+    }
+
+    util::optional<ConstantValue> convert_constant(const ConstantValue& v, BasicType to)
+    {
+        auto rule = types::conversion_rule(v.type, to);
+        if (rule.kind == types::Conversion::None)
+        {
+            return {};
+        }
+
+        auto from_signed = info(v.type).is_signed;
+
+        switch (rule.op)
+        {
+            // Integers are already extended the right way for their type,
+            // so all of these are just a matter of wrapping to the new one.
+            case types::CastOp::None:
+            case types::CastOp::Trunc:
+            case types::CastOp::ZExt:
+            case types::CastOp::SExt:
+                if (is_floating(to))
+                {
+                    return make_floating(to, v.floating);
+                }
+                return make_integer(to, v.integer);
+
+            case types::CastOp::FPTrunc:
+            case types::CastOp::FPExt:
+                return make_floating(to, v.floating);
+
+            case types::CastOp::FPToSI:
+            case types::CastOp::FPToUI:
+                if (!fits_integer(v.floating, to))
+                {
+                    return {};
+                }
+                return info(to).is_signed
+                    ? make_integer(to, static_cast<std::uint64_t>(static_cast<std::int64_t>(v.floating)))
+                    : make_integer(to, static_cast<std::uint64_t>(v.floating));
+
+            case types::CastOp::SIToFP:
+            case types::CastOp::UIToFP:
+                // Go straight to the target type, so we only round once.
+                if (to == BasicType::Float)
+                {
+                    return make_floating(to, from_signed
+                        ? static_cast<float>(as_signed(v))
+                        : static_cast<float>(v.integer));
+                }
+                return make_floating(to, from_signed
+                    ? static_cast<double>(as_signed(v))
+                    : static_cast<double>(v.integer));
+
+            case types::CastOp::IntToBool:
+                return make_boolean(v.integer != 0);
+
+            case types::CastOp::FPToBool:
+                // `fcmp une`, so NaN is true.
+                return make_boolean(!(v.floating == 0.0));
+
+            default:
+                return {};
+        }
+    }
+
+    ConstantFolder::ConstantFolder() {}
+
+    void ConstantFolder::fold(ASTNode* tree)
+    {
+        // Whatever comes back is a replacement for the root, which we
+        // can't use.
+        tree->visit(this);
+    }
+
+    void ConstantFolder::fold(expression_ptr& e)
+    {
+        if (e == nullptr)
+        {
+            return;
+        }
+
+        auto replacement = e->visit(this);
+        if (replacement != nullptr)
+        {
+            e = std::move(replacement);
+        }
+    }
+
+    expression_ptr ConstantFolder::replace(Expression* old, const ConstantValue& v)
+    {
+        auto result = make_literal(v);
+        if (result != nullptr)
+        {
+            result->position = old->position;
+            ++m_folded;
+        }
+
+        return result;
+    }
+
+    expression_ptr ConstantFolder::visit(Identifier* n)
+    {
+        auto value = m_constants.find(n->name);
+        if (value != nullptr && *value)
+        {
+            return replace(n, **value);
+        }
+
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(BinaryOp* n)
+    {
+        fold(n->left);
+        fold(n->right);
+
+        auto l = constant_value(n->left.get());
+
+        // `false and x` and `true or x` never look at `x`, so it doesn't
+        // matter whether we know what it is.
+        if (l && l->type == BasicType::Boolean)
+        {
+            if ((n->op == BinaryOperators::BooleanAnd && l->integer == 0) ||
+                (n->op == BinaryOperators::BooleanOr && l->integer != 0))
+            {
+                return replace(n, *l);
+            }
+        }
+
+        auto r = constant_value(n->right.get());
+        if (!l || !r)
+        {
+            return nullptr;
+        }
+
+        if (n->op == BinaryOperators::BooleanAnd || n->op == BinaryOperators::BooleanOr)
+        {
+            if (r->type != BasicType::Boolean)
+            {
+                return nullptr;
+            }
+
+            // The LHS didn't short-circuit, so the RHS is the answer.
+            return replace(n, *r);
+        }
+
+        // The RHS is converted to the type of the LHS, as in codegen. If
+        // that isn't allowed, it's an error for someone else to report.
+        if (r->type != l->type)
+        {
+            if (!types::is_implicitly_convertible(r->type, l->type))
+            {
+                return nullptr;
+            }
+
+            r = convert_constant(*r, l->type);
+            if (!r)
+            {
+                return nullptr;
+            }
+        }
+
+        util::optional<ConstantValue> result;
+        if (is_integral(l->type))
+        {
+            result = fold_integral(n->op, *l, *r);
+        }
+        else if (is_floating(l->type))
+        {
+            result = fold_floating(n->op, *l, *r);
+        }
+
+        return result ? replace(n, *result) : nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(UnaryOp* n)
+    {
+        fold(n->operand);
+
+        // Coercion isn't an operation on its own; it changes how the parent
+        // converts its operand. So it has to stay.
+        auto v = constant_value(n->operand.get());
+        if (!v)
+        {
+            return nullptr;
+        }
+
+        switch (n->op)
+        {
+            case UnaryOperators::Plus:
+                if (types::is_numeric_type(v->type))
+                {
+                    return replace(n, *v);
+                }
+                break;
+
+            case UnaryOperators::Minus:
+                // Codegen subtracts from zero, so we do too. For floats,
+                // that means -(0.0) is 0.0, not -0.0.
+                if (is_integral(v->type))
+                {
+                    return replace(n, make_integer(signed_counterpart(v->type), 0u - v->integer));
+                }
+                else if (is_floating(v->type))
+                {
+                    return replace(n, make_floating(v->type, 0.0 - v->floating));
+                }
+                break;
+
+            case UnaryOperators::BooleanNot:
+                if (v->type == BasicType::Boolean)
+                {
+                    return replace(n, make_boolean(v->integer == 0));
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(TernaryOp* n)
+    {
+        fold(n->condition);
+        fold(n->true_branch);
+        fold(n->false_branch);
+
+        auto c = constant_value(n->condition.get());
+        if (!c || c->type != BasicType::Boolean)
+        {
+            return nullptr;
+        }
+
+        if (c->integer != 0)
+        {
+            // The true branch decides the type, so it can stand in for the
+            // whole ternary as it is.
+            ++m_folded;
+            return std::move(n->true_branch);
+        }
+
+        // The false branch is converted to the true branch's type, which we
+        // can only do here if both are literals.
+        auto t = constant_value(n->true_branch.get());
+        auto f = constant_value(n->false_branch.get());
+        if (!t || !f)
+        {
+            return nullptr;
+        }
+
+        if (f->type != t->type)
+        {
+            if (!types::is_implicitly_convertible(f->type, t->type))
+            {
+                return nullptr;
+            }
+
+            f = convert_constant(*f, t->type);
+        }
+
+        return f ? replace(n, *f) : nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(Cast* n)
+    {
+        fold(n->left);
+
+        auto v = constant_value(n->left.get());
+        if (!v || n->right->generic_part != nullptr || n->right->array_part != nullptr)
+        {
+            return nullptr;
+        }
+
+        auto target = m_types.get_type_for(n->right->canonical_name());
+        auto st = util::get_if<types::SimpleType>(&(target.type()));
+        if (st == nullptr)
+        {
+            return nullptr;
+        }
+
+        auto result = convert_constant(*v, st->type);
+        return result ? replace(n, *result) : nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(Program* n)
+    {
+        for (auto& s : n->children)
+        {
+            s->visit(this);
+        }
+
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(Module* n)
+    {
+        for (auto& s : n->children)
+        {
+            s->visit(this);
+        }
+
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(Block* n)
+    {
+        m_constants.push();
+
+        for (auto& s : n->children)
+        {
+            s->visit(this);
+        }
+
+        m_constants.pop();
+
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(BareExpression* n)
+    {
+        fold(n->expression);
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(Assign* n)
+    {
+        fold(n->rhs);
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(CompoundAssign* n)
+    {
+        fold(n->rhs);
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(TypeDeclaration* n)
+    {
+        m_constants.insert(n->lhs->name, {});
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(Variable* n)
+    {
+        fold(n->rhs);
+        m_constants.insert(n->lhs->name, {});
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(Constant* n)
+    {
+        // The declaration itself stays, since the constant can still be
+        // used as a variable (e.g., by another module).
+        fold(n->rhs);
+        m_constants.insert(n->lhs->name, constant_value(n->rhs.get()));
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(If* n)
+    {
+        fold(n->condition);
+
+        if (n->then_case != nullptr) n->then_case->visit(this);
+        if (n->else_case != nullptr) n->else_case->visit(this);
+
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(While* n)
+    {
+        fold(n->condition);
+        n->body->visit(this);
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(For* n)
+    {
+        fold(n->range);
+
+        m_constants.push();
+        m_constants.insert(n->index, {});
+        n->body->visit(this);
+        m_constants.pop();
+
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(Match* n)
+    {
+        fold(n->expression);
+
+        for (auto& c : n->cases)
+        {
+            c->visit(this);
+        }
+
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(On* n)
+    {
+        for (auto& v : n->case_values)
+        {
+            fold(v);
+        }
+
+        n->body->visit(this);
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(Default* n)
+    {
+        n->body->visit(this);
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(Def* n)
+    {
+        // Arguments hide any constants with the same names.
+        m_constants.push();
+
+        if (n->arguments_list != nullptr)
+        {
+            for (auto& a : n->arguments_list->arguments)
+            {
+                m_constants.insert(a->name, {});
+            }
+        }
+
+        n->body->visit(this);
+        m_constants.pop();
+
+        return nullptr;
+    }
+
+    expression_ptr ConstantFolder::visit(Return* n)
+    {
+        fold(n->value);
+        return nullptr;
+    }
+}}
@@ -1,7 +1,188 @@
 #include "inference/engine.hpp"
 
+#include <algorithm>
+
 namespace rhea { namespace inference {
     using namespace rhea::types;
 
     TypeEngine::TypeEngine() : visitor(this) {}
+
+    void TypeEngine::set_inferred_type(ast::ASTNode* node, InferredType type)
+    {
+        invalidate(node);
+
+        type.engine = this;
+        type.node = node;
+
+        inferred_types[node] = std::move(type);
+    }
+
+    TypeInfo TypeEngine::get_inferred_type(ast::ASTNode* node)
+    {
+        auto& type = inferred_types[node];
+
+        // Nodes we haven't seen yet get the default (unknown) inference,
+        // but they still need to know where they live.
+        if (type.engine == nullptr)
+        {
+            type.engine = this;
+            type.node = node;
+        }
+
+        return type();
+    }
+
+    void TypeEngine::invalidate(ast::ASTNode* node)
+    {
+        auto type = inferred_types.find(node);
+        if (type == nullptr || !type->cached)
+        {
+            // Nothing can depend on a type that was never computed.
+            return;
+        }
+
+        auto dependents = std::move(type->dependents);
+        type->dependents.clear();
+        type->reset();
+        ++cache_stats.invalidations;
+
+        for (auto d : dependents)
+        {
+            invalidate(d);
+        }
+    }
+
+    TypeInfo TypeEngine::get_named_type(util::InternedString name)
+    {
+        if (!m_evaluating.empty())
+        {
+            // Whoever asked for this type now depends on its definition.
+            auto& users = m_named_type_users[name];
+            auto user = m_evaluating.back();
+            if (std::find(users.begin(), users.end(), user) == users.end())
+            {
+                users.push_back(user);
+            }
+        }
+
+        return mapper.get_type_for(name);
+    }
+
+    bool TypeEngine::add_type_definition(util::InternedString name, TypeInfo type)
+    {
+        if (!mapper.add_type_definition(name, type))
+        {
+            return false;
+        }
+
+        invalidate_named_type(name);
+        return true;
+    }
+
+    util::optional<TypeInfo> TypeEngine::remove_type_definition(util::InternedString name)
+    {
+        auto old_type = mapper.remove_type_definition(name);
+        if (old_type)
+        {
+            invalidate_named_type(name);
+        }
+
+        return old_type;
+    }
+
+    void TypeEngine::invalidate_named_type(util::InternedString name)
+    {
+        auto it = m_named_type_users.find(name);
+        if (it == m_named_type_users.end())
+        {
+            return;
+        }
+
+        // Users look the name up again when they're recomputed, which puts
+        // them back on the list.
+        auto users = std::move(it->second);
+        m_named_type_users.erase(it);
+
+        for (auto u : users)
+        {
+            invalidate(u);
+        }
+    }
+
+    ast::NodeMap<TypeId> TypeEngine::finalize(ast::NodeId first)
+    {
+        // Computing one type can add entries for others, which can't be
+        // done while iterating over the map, so collect the nodes first.
+        std::vector<ast::ASTNode*> nodes;
+        inferred_types.for_each([&](InferredType& t) {
+            if (t.node != nullptr)
+            {
+                nodes.push_back(t.node);
+            }
+        }, first);
+
+        ast::NodeMap<TypeId> result;
+        for (auto n : nodes)
+        {
+            result[n] = intern_type(get_inferred_type(n));
+        }
+
+        return result;
+    }
+
+    TypeInfo InferredType::operator()()
+    {
+        if (engine != nullptr && !engine->m_evaluating.empty())
+        {
+            // Whoever asked for this type now depends on it.
+            auto user = engine->m_evaluating.back();
+            if (user != node &&
+                std::find(dependents.begin(), dependents.end(), user) == dependents.end())
+            {
+                dependents.push_back(user);
+            }
+        }
+
+        if (cached)
+        {
+            if (engine != nullptr) ++engine->cache_stats.hits;
+            return value;
+        }
+
+        if (engine != nullptr) ++engine->cache_stats.misses;
+
+        if (evaluating)
+        {
+            return UnknownType();
+        }
+
+        // Keep track of what we're evaluating, even if the function throws.
+        struct evaluation_guard
+        {
+            evaluation_guard(InferredType* t) : type(t)
+            {
+                type->evaluating = true;
+                if (type->engine != nullptr) type->engine->m_evaluating.push_back(type->node);
+            }
+
+            ~evaluation_guard()
+            {
+                type->evaluating = false;
+                if (type->engine != nullptr) type->engine->m_evaluating.pop_back();
+            }
+
+            InferredType* type;
+        };
+
+        TypeInfo result;
+        {
+            evaluation_guard guard { this };
+            result = function(engine, node);
+        }
+
+        value = result;
+        cached = true;
+
+        return result;
+    }
 }}
\ No newline at end of file
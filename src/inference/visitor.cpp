@@ -4,7 +4,6 @@
 namespace rhea { namespace inference {
     using namespace rhea::ast;
     using namespace rhea::types;
-    using util::any;
 
     using type_vector = std::vector<TypeInfo>;
 
@@ -17,95 +16,107 @@ namespace rhea { namespace inference {
      * thus we can use static_cast instead of the much slower dynamic_cast.
      */
 
-    any InferenceVisitor::visit(Boolean* n)
+    void InferenceVisitor::visit(Boolean* n)
     {
-        engine->inferred_types[n] =
-            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::Boolean, false); } };
-        return {};
+        engine->set_inferred_type(n,
+            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::Boolean, false); } });
     }
 
-    any InferenceVisitor::visit(Integer* n)
+    void InferenceVisitor::visit(Integer* n)
     {
-        engine->inferred_types[n] =
-            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::Integer, true, true); } };
-        return {};
+        engine->set_inferred_type(n,
+            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::Integer, true, true); } });
     }
 
-    any InferenceVisitor::visit(Byte* n)
+    void InferenceVisitor::visit(Byte* n)
     {
-        engine->inferred_types[n] =
-            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::Byte, true, true); } };
-        return {};
+        engine->set_inferred_type(n,
+            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::Byte, true, true); } });
     }
 
-    any InferenceVisitor::visit(Long* n)
+    void InferenceVisitor::visit(Long* n)
     {
-        engine->inferred_types[n] =
-            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::Long, true, true); } };
-        return {};
+        engine->set_inferred_type(n,
+            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::Long, true, true); } });
     }
 
-    any InferenceVisitor::visit(UnsignedInteger* n)
+    void InferenceVisitor::visit(UnsignedInteger* n)
     {
-        engine->inferred_types[n] =
-            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::UnsignedInteger, true, true); } };
-        return {};
+        engine->set_inferred_type(n,
+            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::UnsignedInteger, true, true); } });
     }
 
-    any InferenceVisitor::visit(UnsignedByte* n)
+    void InferenceVisitor::visit(UnsignedByte* n)
     {
-        engine->inferred_types[n] =
-            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::UnsignedByte, true, true); } };
-        return {};
+        engine->set_inferred_type(n,
+            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::UnsignedByte, true, true); } });
     }
 
-    any InferenceVisitor::visit(UnsignedLong* n)
+    void InferenceVisitor::visit(UnsignedLong* n)
     {
-        engine->inferred_types[n] =
-            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::UnsignedLong, true, true); } };
-        return {};
+        engine->set_inferred_type(n,
+            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::UnsignedLong, true, true); } });
     }
 
-    any InferenceVisitor::visit(Float* n)
+    void InferenceVisitor::visit(Float* n)
     {
-        engine->inferred_types[n] =
-            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::Float, true, false); } };
-        return {};
+        engine->set_inferred_type(n,
+            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::Float, true, false); } });
     }
 
-    any InferenceVisitor::visit(Double* n)
+    void InferenceVisitor::visit(Double* n)
     {
-        engine->inferred_types[n] =
-            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::Double, true, false); } };
-        return {};
+        engine->set_inferred_type(n,
+            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::Double, true, false); } });
     }
 
-    any InferenceVisitor::visit(Symbol* n)
+    void InferenceVisitor::visit(Symbol* n)
     {
-        engine->inferred_types[n] =
-            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::Symbol, false); } };
-        return {};
+        engine->set_inferred_type(n,
+            InferredType { [](TypeEngine* e, ASTNode* node) { return SimpleType(BasicType::Symbol, false); } });
     }
 
-    any InferenceVisitor::visit(Nothing* n)
+    void InferenceVisitor::visit(Nothing* n)
     {
-        engine->inferred_types[n] =
-            InferredType { [](TypeEngine* e, ASTNode* node) { return NothingType(); } };
-        return {};
+        engine->set_inferred_type(n,
+            InferredType { [](TypeEngine* e, ASTNode* node) { return NothingType(); } });
     }
 
-    any InferenceVisitor::visit(BinaryOp* n)
+    void InferenceVisitor::visit(Identifier* n)
+    {
+        // Names are resolved now, while the scope tree is in the right
+        // place, but the declaration's type is only asked for later.
+        auto declaration = module_scope->find_symbol(n->name);
+
+        engine->set_inferred_type(n,
+            InferredType {
+                [declaration](TypeEngine* e, ASTNode* node)
+                {
+                    if (declaration != nullptr && e->inferred_types.count(declaration) != 0)
+                    {
+                        return e->get_inferred_type(declaration);
+                    }
+                    else
+                    {
+                        return TypeInfo {UnknownType()};
+                    }
+                },
+                engine, n
+            });
+    }
+
+    void InferenceVisitor::visit(BinaryOp* n)
     {
         n->left->visit(this);
         n->right->visit(this);
         
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
                     auto derived = static_cast<BinaryOp*>(node);
-                    auto lhs = e->inferred_types[derived->left.get()]();
-                    auto rhs = e->inferred_types[derived->right.get()]();
+                    auto lhs = e->get_inferred_type(derived->left.get());
+                    auto rhs = e->get_inferred_type(derived->right.get());
 
                     if (is_boolean_op(derived->op))
                     {
@@ -121,15 +132,14 @@ namespace rhea { namespace inference {
                     }
                 },
                 engine, n
-            };
-        return {};
+            });
     }
 
-    any InferenceVisitor::visit(UnaryOp* n)
+    void InferenceVisitor::visit(UnaryOp* n)
     {
         n->operand->visit(this);
 
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
@@ -146,27 +156,26 @@ namespace rhea { namespace inference {
                             return TypeInfo {UnknownType()};
                         default:
                             // All others keep the type of their operand.
-                            return e->inferred_types[derived->operand.get()]();
+                            return e->get_inferred_type(derived->operand.get());
                     }
                 },
                 engine, n
-            };
-        return {};
+            });
     }
 
-    any InferenceVisitor::visit(TernaryOp* n)
+    void InferenceVisitor::visit(TernaryOp* n)
     {
         n->condition->visit(this);
         n->true_branch->visit(this);
         n->false_branch->visit(this);
         
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
                     auto derived = static_cast<TernaryOp*>(node);
-                    auto tb = e->inferred_types[derived->true_branch.get()]();
-                    auto fb = e->inferred_types[derived->false_branch.get()]();
+                    auto tb = e->get_inferred_type(derived->true_branch.get());
+                    auto fb = e->get_inferred_type(derived->false_branch.get());
 
                     if (tb == fb)
                     {
@@ -178,123 +187,113 @@ namespace rhea { namespace inference {
                     }
                 },
                 engine, n
-            };
-        return {};
+            });
     }
 
-    any InferenceVisitor::visit(Typename* n)
+    void InferenceVisitor::visit(Typename* n)
     {
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
                     auto derived = static_cast<Typename*>(node);
 
-                    return e->mapper.get_type_for(derived->canonical_name());
+                    return e->get_named_type(derived->canonical_name());
                 },
                 engine, n
-            };
-        return {};
+            });
     }
 
-    any InferenceVisitor::visit(Variant* n)
+    void InferenceVisitor::visit(Variant* n)
     {
         for (auto&& ch : n->children)
         {
             ch->visit(this);
         }
         
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
                     auto derived = static_cast<Variant*>(node);
 
-                    return e->mapper.get_type_for(derived->canonical_name());
+                    return e->get_named_type(derived->canonical_name());
                 },
                 engine, n
-            };
-        return {};
+            });
     }
 
-    any InferenceVisitor::visit(Optional* n)
+    void InferenceVisitor::visit(Optional* n)
     {
         n->type->visit(this);
 
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
                     auto derived = static_cast<Optional*>(node);
 
-                    return e->mapper.get_type_for(derived->canonical_name());
+                    return e->get_named_type(derived->canonical_name());
                 },
                 engine, n
-            };
-        return {};
+            });
     }
 
-    any InferenceVisitor::visit(Cast* n)
+    void InferenceVisitor::visit(Cast* n)
     {
         n->left->visit(this);
         n->right->visit(this);
 
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
                     auto derived = static_cast<Cast*>(node);
 
-                    return e->mapper.get_type_for(derived->right->canonical_name());
+                    return e->get_named_type(derived->right->canonical_name());
                 },
                 engine, n
-            };
-        return {};
+            });
     }
 
-    any InferenceVisitor::visit(TypeCheck* n)
+    void InferenceVisitor::visit(TypeCheck* n)
     {
         n->left->visit(this);
         n->right->visit(this);
 
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
                     return SimpleType(BasicType::Boolean);
                 },
                 engine, n
-            };
-
-        return {};
+            });
     }
 
-    any InferenceVisitor::visit(Alias* n)
+    void InferenceVisitor::visit(Alias* n)
     {
         // Aliases only affect the symbol table, and they are not hoisted; an alias
         // only applies to code in the current scope (and its children) following
         // the point of declaration.
         module_scope->add_symbol(n->alias->canonical_name(), n);
 
-        engine->mapper.add_type_definition(
+        engine->add_type_definition(
             n->alias->canonical_name(),
-            engine->mapper.get_type_for(n->original->canonical_name())
+            engine->get_named_type(n->original->canonical_name())
         );
         
-        return {};
     }
 
-    any InferenceVisitor::visit(Enum* n)
+    void InferenceVisitor::visit(Enum* n)
     {
         n->name->visit(this);
         n->values->visit(this);
         
         // TODO: Anything else? Add to mapper or something?
-
-        return {};
     }
 
-    any InferenceVisitor::visit(SymbolList* n)
+    void InferenceVisitor::visit(SymbolList* n)
     {
         for (auto&& ch : n->symbols)
         {
@@ -302,29 +301,23 @@ namespace rhea { namespace inference {
         }
 
         // TODO: Anything else?
-
-        return {};
     }
 
     // Most statements don't have types themselves, but they'll still need to descend
     // into their child nodes for the expressions.
-    any InferenceVisitor::visit(If* n)
+    void InferenceVisitor::visit(If* n)
     {
         n->condition->visit(this);
         n->then_case->visit(this);
         n->else_case->visit(this);
-
-        return {};
     }
 
-    any InferenceVisitor::visit(BareExpression* n)
+    void InferenceVisitor::visit(BareExpression* n)
     {
         n->expression->visit(this);
-
-        return {};
     }
 
-    any InferenceVisitor::visit(Block* n)
+    void InferenceVisitor::visit(Block* n)
     {
         // Blocks always create a new scope
         module_scope->begin_scope("$block");
@@ -335,18 +328,15 @@ namespace rhea { namespace inference {
         }
 
         module_scope->end_scope();
-
-        return {};
     }
 
-    any InferenceVisitor::visit(While* n)
+    void InferenceVisitor::visit(While* n)
     {
         n->condition->visit(this);
         n->body->visit(this);
-        return {};
     }
 
-    any InferenceVisitor::visit(For* n)
+    void InferenceVisitor::visit(For* n)
     {
         // For loops introduce a loop variable, so we have to account for that.
         // As it's stored as a string rather than a node pointer, we'll use this
@@ -359,23 +349,21 @@ namespace rhea { namespace inference {
         n->range->visit(this);
         n->body->visit(this);
 
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
                     auto derived = static_cast<For*>(node);
 
-                    return e->inferred_types[derived->range.get()]();
+                    return e->get_inferred_type(derived->range.get());
                 },
                 engine, n
-            };
+            });
 
         module_scope->end_scope();
-
-        return {};
     }
 
-    any InferenceVisitor::visit(With* n)
+    void InferenceVisitor::visit(With* n)
     {
         n->body->visit(this);
 
@@ -383,23 +371,19 @@ namespace rhea { namespace inference {
         {
             ch->visit(this);
         }
-
-        return {};
     }
 
-    any InferenceVisitor::visit(Break* n)
+    void InferenceVisitor::visit(Break* n)
     {
         // Breaks need no type inference
-        return {};
     }
 
-    any InferenceVisitor::visit(Continue* n)
+    void InferenceVisitor::visit(Continue* n)
     {
         // Continues need no type inference
-        return {};
     }
 
-    any InferenceVisitor::visit(Match* n)
+    void InferenceVisitor::visit(Match* n)
     {
         n->expression->visit(this);
 
@@ -407,38 +391,36 @@ namespace rhea { namespace inference {
         {
             ch->visit(this);
         }
-
-        return {};
     }
 
-    any InferenceVisitor::visit(On* n)
+    void InferenceVisitor::visit(On* n)
     {
-        n->case_expr->visit(this);
+        for (auto&& v : n->case_values)
+        {
+            v->visit(this);
+        }
+
         n->body->visit(this);
-        return {};
     }
 
-    any InferenceVisitor::visit(When* n)
+    void InferenceVisitor::visit(When* n)
     {
         n->predicate->visit(this);
         n->body->visit(this);
-        return {};
     }
 
-    any InferenceVisitor::visit(TypeCase* n)
+    void InferenceVisitor::visit(TypeCase* n)
     {
         n->type_name->visit(this);
         n->body->visit(this);
-        return {};
     }
 
-    any InferenceVisitor::visit(Default* n)
+    void InferenceVisitor::visit(Default* n)
     {
         // Defaults need no type inference
-        return {};
     }
 
-    any InferenceVisitor::visit(PredicateCall* n)
+    void InferenceVisitor::visit(PredicateCall* n)
     {
         n->target->visit(this);
 
@@ -447,47 +429,44 @@ namespace rhea { namespace inference {
             ch->visit(this);
         }
 
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
                     return SimpleType(BasicType::Boolean);
                 },
                 engine, n
-            };
-
-        return {};
+            });
     }
 
-    any InferenceVisitor::visit(TypeDeclaration* n)
+    void InferenceVisitor::visit(TypeDeclaration* n)
     {
         n->lhs->visit(this);
         n->rhs->visit(this);
 
         module_scope->add_symbol(n->lhs->canonical_name(), n);
 
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
                     auto derived = static_cast<TypeDeclaration*>(node);
 
-                    return e->mapper.get_type_for(derived->rhs->canonical_name());
+                    return e->get_named_type(derived->rhs->canonical_name());
                 },
                 engine, n
-            };
-
-        return {};
+            });
     }
 
-    any InferenceVisitor::visit(Variable* n)
+    void InferenceVisitor::visit(Variable* n)
     {
-        n->lhs->visit(this);
+        // The name isn't visible until after its value, but the identifier
+        // on the left refers to this declaration.
         n->rhs->visit(this);
-
         module_scope->add_symbol(n->lhs->canonical_name(), n);
+        n->lhs->visit(this);
 
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
@@ -495,7 +474,7 @@ namespace rhea { namespace inference {
 
                     if (e->inferred_types.count(derived->rhs.get()) != 0)
                     {
-                        return e->inferred_types[derived->rhs.get()]();
+                        return e->get_inferred_type(derived->rhs.get());
                     }
                     else
                     {
@@ -503,18 +482,18 @@ namespace rhea { namespace inference {
                     }
                 },
                 engine, n
-            };
-        return {};
+            });
     }
 
-    any InferenceVisitor::visit(Constant* n)
+    void InferenceVisitor::visit(Constant* n)
     {
-        n->lhs->visit(this);
+        // The name isn't visible until after its value, but the identifier
+        // on the left refers to this declaration.
         n->rhs->visit(this);
-
         module_scope->add_symbol(n->lhs->canonical_name(), n);
+        n->lhs->visit(this);
 
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
@@ -522,7 +501,7 @@ namespace rhea { namespace inference {
 
                     if (e->inferred_types.count(derived->rhs.get()) != 0)
                     {
-                        return e->inferred_types[derived->rhs.get()]();
+                        return e->get_inferred_type(derived->rhs.get());
                     }
                     else
                     {
@@ -530,12 +509,11 @@ namespace rhea { namespace inference {
                     }
                 },
                 engine, n
-            };
+            });
             
-        return {};
     }
 
-    any InferenceVisitor::visit(Def* n)
+    void InferenceVisitor::visit(Def* n)
     {
         // We need a way to handle overloaded functions in the same scope.
         // As a quick and dirty method, we alter their symbols using what
@@ -563,7 +541,7 @@ namespace rhea { namespace inference {
          * for the function right now, we have to call it unknown, then determine
          * it later on, once we've gone over the full program or module.
          */
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
@@ -573,59 +551,73 @@ namespace rhea { namespace inference {
 
                     if (derived->return_type != nullptr)
                     {
-                        ft.return_type = std::make_shared<TypeInfo>(
-                            e->inferred_types[derived->return_type.get()]()
+                        ft.return_type = intern_type(
+                            e->get_inferred_type(derived->return_type.get())
                         );
                     }
                     else
                     {
-                        ft.return_type = std::make_shared<TypeInfo>(NothingType());
+                        ft.return_type = intern_type(NothingType());
                     }
 
                     for (auto&& a : derived->arguments_list->arguments)
                     {
                         ft.argument_types.push_back(std::make_pair(
-                            a->name,
-                            std::make_shared<TypeInfo>(e->inferred_types[a.get()]())
+                            a->name.str(),
+                            intern_type(e->get_inferred_type(a.get()))
                         ));
                     }
 
                     return ft;
                 },
                 engine, n
-            };
+            });
 
         module_scope->end_scope();
-        return {};
     }
 
-    any InferenceVisitor::visit(Arguments* n)
+    void InferenceVisitor::visit(Call* n)
     {
         for (auto&& a : n->arguments)
         {
-            a->visit(this);
+            util::visit([this](auto& arg) { arg->visit(this); }, a);
         }
 
-        return {};
+        // We can't resolve overloads yet, so all we know is what the call's
+        // suffix tells us.
+        engine->set_inferred_type(n,
+            InferredType {
+                [](TypeEngine* e, ASTNode* node)
+                {
+                    return static_cast<Call*>(node)->expression_type();
+                },
+                engine, n
+            });
+    }
+
+    void InferenceVisitor::visit(Arguments* n)
+    {
+        for (auto&& a : n->arguments)
+        {
+            a->visit(this);
+        }
     }
 
-    any InferenceVisitor::visit(TypePair* n)
+    void InferenceVisitor::visit(TypePair* n)
     {
         // Use this node as the reference, and we add it to the local symbol table.
         module_scope->add_symbol(n->name, n);
 
-        engine->inferred_types[n] =
+        engine->set_inferred_type(n,
             InferredType {
                 [](TypeEngine* e, ASTNode* node)
                 {
                     auto derived = static_cast<TypePair*>(node);
 
-                    return e->mapper.get_type_for(derived->value->canonical_name());
+                    return e->get_named_type(derived->value->canonical_name());
                 },
                 engine, n
-            };
-
-        return {};
+            });
     }
 
 }}
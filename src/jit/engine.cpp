@@ -0,0 +1,132 @@
+#include "jit/engine.hpp"
+#include "codegen/generator.hpp"
+#include "codegen/target.hpp"
+
+#include <stdexcept>
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace rhea { namespace jit {
+    namespace {
+        // Turn an LLVM error into one of ours.
+        [[noreturn]] void fail(const std::string& what, llvm::Error err)
+        {
+            throw std::runtime_error(what + ": " + llvm::toString(std::move(err)));
+        }
+
+        template <typename T>
+        T unwrap(const std::string& what, llvm::Expected<T> value)
+        {
+            if (!value)
+            {
+                fail(what, value.takeError());
+            }
+
+            return std::move(*value);
+        }
+    }
+
+    Engine::Engine(EngineOptions options) : m_options(options)
+    {
+        codegen::initialize_native_target();
+
+        if (m_options.lazy)
+        {
+            m_jit = unwrap("Unable to create lazy JIT", llvm::orc::LLLazyJITBuilder().create());
+        }
+        else
+        {
+            m_jit = unwrap("Unable to create JIT", llvm::orc::LLJITBuilder().create());
+        }
+
+        if (m_options.link_host_process)
+        {
+            auto generator = unwrap("Unable to search host process",
+                llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+                    m_jit->getDataLayout().getGlobalPrefix()
+                )
+            );
+
+            m_jit->getMainJITDylib().addGenerator(std::move(generator));
+        }
+    }
+
+    void Engine::add_module(const llvm::Module& module)
+    {
+        // Copy the module into a context of its own.
+        llvm::SmallVector<char, 0> buffer;
+        {
+            llvm::raw_svector_ostream os { buffer };
+            llvm::WriteBitcodeToFile(module, os);
+        }
+
+        auto context = std::make_unique<llvm::LLVMContext>();
+        auto copy = unwrap("Unable to copy module " + module.getModuleIdentifier(),
+            llvm::parseBitcodeFile(
+                llvm::MemoryBufferRef(
+                    llvm::StringRef(buffer.data(), buffer.size()),
+                    module.getModuleIdentifier()
+                ),
+                *context
+            )
+        );
+
+        // The JIT decides where code goes, so it gets the final say on layout.
+        copy->setDataLayout(m_jit->getDataLayout());
+
+        llvm::orc::ThreadSafeModule tsm { std::move(copy), std::move(context) };
+
+        // An llvm::Error has to be checked before anything is assigned over
+        // it, so this can't start out as success() and be replaced.
+        llvm::Error err = m_options.lazy
+            ? static_cast<llvm::orc::LLLazyJIT&>(*m_jit).addLazyIRModule(std::move(tsm))
+            : m_jit->addIRModule(std::move(tsm));
+
+        if (err)
+        {
+            fail("Unable to add module " + module.getModuleIdentifier(), std::move(err));
+        }
+    }
+
+    void Engine::add(codegen::CodeGenerator& generator)
+    {
+        add_module(*(generator.module));
+    }
+
+    std::uint64_t Engine::lookup(const std::string& name)
+    {
+        auto symbol = unwrap("Unable to find symbol " + name, m_jit->lookup(name));
+        return symbol.getAddress();
+    }
+
+    bool Engine::has_symbol(const std::string& name)
+    {
+        auto symbol = m_jit->lookup(name);
+        if (!symbol)
+        {
+            llvm::consumeError(symbol.takeError());
+            return false;
+        }
+
+        return true;
+    }
+
+    int Engine::run(const std::string& module_name)
+    {
+        function<void()>(module_name + "_init")();
+
+        if (has_symbol("main"))
+        {
+            function<void()>("main")();
+        }
+
+        return 0;
+    }
+}}
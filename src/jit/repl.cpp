@@ -0,0 +1,47 @@
+#include "jit/repl.hpp"
+#include "state/module_tree.hpp"
+
+namespace rhea { namespace jit {
+    Session::Session(std::string name, EngineOptions options)
+        : m_name(name), m_generator(name), m_engine(options)
+    {
+        m_types.module_scopes[name] = std::make_unique<state::ModuleScopeTree>(name);
+        m_types.visitor.module_scope = m_types.module_scopes[name].get();
+
+        // Later inputs have to be able to see earlier globals.
+        m_generator.export_globals = true;
+    }
+
+    std::string Session::evaluate(std::unique_ptr<ast::ASTNode> input)
+    {
+        auto module_name = m_name + "_" + std::to_string(m_inputs.size() + 1);
+
+        // Programs wrap their contents in a node we don't generate code for.
+        auto node = input.get();
+        auto program = dynamic_cast<ast::Program*>(node);
+        if (program != nullptr && !program->children.empty())
+        {
+            node = program->children.front().get();
+        }
+
+        m_inputs.push_back(std::move(input));
+
+        // Folding replaces nodes, so it has to come before inference. The
+        // folder remembers constants from earlier inputs, too.
+        m_folder.fold(node);
+
+        // Only infer and finalize the new nodes. Everything older was already
+        // handed to the code generator.
+        node->visit(&m_types.visitor);
+        auto types = m_types.finalize(m_first_new_node);
+        m_first_new_node = ast::ASTNode::id_count();
+
+        m_generator.start_module(module_name);
+        m_generator.generate(node, std::move(types));
+
+        m_engine.add(m_generator);
+        m_engine.function<void()>(module_name + "_init")();
+
+        return module_name;
+    }
+}}
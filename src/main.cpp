@@ -4,8 +4,30 @@
 #include "grammar/expression.hpp"
 #include "debug/parse_tree.hpp"
 
-int main()
+int main(int argc, char* argv[])
 {
+    // Files named on the command line are parsed whole.
+    if (argc > 1)
+    {
+        int status = 0;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            auto file = rhea::debug::parse_file(argv[i]);
+
+            if (file)
+            {
+                rhea::debug::print_partial_tree(std::cout, file->parse());
+            }
+            else
+            {
+                status = 1;
+            }
+        }
+
+        return status;
+    }
+
     std::string input;
 
     while (std::getline(std::cin, input))
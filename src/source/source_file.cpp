@@ -0,0 +1,59 @@
+#include "source/source_file.hpp"
+
+#include <tao/pegtl/contrib/parse_tree.hpp>
+
+#include "grammar/module.hpp"
+#include "ast/builder.hpp"
+#include "ast/direct_builder.hpp"
+#include "ast/error.hpp"
+#include "ast/selector.hpp"
+
+namespace rhea { namespace source {
+    namespace pt = tao::pegtl::parse_tree;
+
+    SourceFile::SourceFile(std::string filename)
+        : m_name(filename), m_input(filename), m_buffer(m_input)
+    {}
+
+    ast::parser_node* SourceFile::parse()
+    {
+        if (m_tree == nullptr)
+        {
+            m_tree = pt::parse<
+                grammar::translation_unit,
+                ast::parser_node,
+                ast::tree_selector
+            >(m_input);
+        }
+
+        return m_tree.get();
+    }
+
+    ast::ASTNode* SourceFile::ast()
+    {
+        if (m_ast == nullptr)
+        {
+            ast::ArenaScope scope { m_arena };
+
+            // Build straight from the text if we can, which skips the parse
+            // tree entirely. That uses an input of its own, so the parse tree
+            // builder can start from the beginning if it has to take over.
+            try
+            {
+                ast::file_view_input in { begin(), end(), m_name.c_str() };
+                m_ast = ast::build_program_direct(in);
+            }
+            catch (ast::unimplemented_type&)
+            {
+                m_ast = nullptr;
+            }
+
+            if (m_ast == nullptr)
+            {
+                m_ast = ast::build_ast(parse());
+            }
+        }
+
+        return m_ast.get();
+    }
+}}
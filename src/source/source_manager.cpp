@@ -0,0 +1,223 @@
+#include "source/source_manager.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace rhea { namespace source {
+    namespace {
+        // The AST builder looks up the same buffer for every node it makes,
+        // so we remember the last answer instead of locking the table each
+        // time. Registering or removing anything invalidates it.
+        struct lookup_cache
+        {
+            const SourceManager* manager = nullptr;
+            const char* buffer = nullptr;
+            std::uint64_t generation = 0;
+            std::uint32_t base = 0;
+            std::uint32_t size = 0;
+        };
+
+        thread_local lookup_cache last_lookup;
+    }
+
+    SourceManager& SourceManager::global()
+    {
+        static SourceManager manager;
+        return manager;
+    }
+
+    FileId SourceManager::add_buffer(std::string name, const char* data, std::size_t size)
+    {
+        file_entry f;
+        f.name = std::move(name);
+        f.buffer = data;
+
+        // Scan for line breaks once, up front. We don't keep the text, so
+        // this is the only chance.
+        auto p = data;
+        auto end = data + size;
+        while (p != end)
+        {
+            auto nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (nl == nullptr)
+            {
+                break;
+            }
+
+            f.line_starts.push_back(static_cast<std::uint32_t>(nl + 1 - data));
+            p = nl + 1;
+        }
+
+        std::lock_guard<std::mutex> lock { m_mutex };
+
+        // Each file takes one location per byte, plus one for its end.
+        if (size >= std::numeric_limits<std::uint32_t>::max() - m_next_base)
+        {
+            throw std::overflow_error("Too much source text for 32-bit locations");
+        }
+
+        f.base = m_next_base;
+        f.size = static_cast<std::uint32_t>(size);
+        m_next_base += f.size + 1;
+
+        m_files.push_back(std::move(f));
+
+        auto id = static_cast<FileId>(m_files.size());
+        m_buffers[data] = id;
+        ++m_generation;
+
+        return id;
+    }
+
+    void SourceManager::remove_buffer(FileId file)
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+
+        assert(file > 0 && file <= m_files.size());
+        auto& f = m_files[file - 1];
+        assert(!f.removed);
+
+        // The buffer may have been registered again since, in which case
+        // lookups by address belong to the newer entry.
+        auto it = m_buffers.find(f.buffer);
+        if (it != m_buffers.end() && it->second == file)
+        {
+            m_buffers.erase(it);
+        }
+
+        f.removed = true;
+        f.name = std::string {};
+        f.line_starts = std::vector<std::uint32_t> {};
+        ++m_removed;
+
+        // Entries have to stay sorted by base, so only the ones at the end
+        // can actually go, taking their locations with them. Buffers are
+        // usually dropped in the reverse of the order they were added.
+        while (!m_files.empty() && m_files.back().removed)
+        {
+            m_next_base = m_files.back().base;
+            m_files.pop_back();
+            --m_removed;
+        }
+
+        ++m_generation;
+    }
+
+    SourceLocation SourceManager::location(FileId file, std::size_t offset) const
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+
+        assert(file > 0 && file <= m_files.size());
+        auto& f = m_files[file - 1];
+
+        assert(!f.removed && offset <= f.size);
+        return SourceLocation { f.base + static_cast<std::uint32_t>(offset) };
+    }
+
+    SourceLocation SourceManager::location(const char* buffer, std::size_t offset) const
+    {
+        auto& cache = last_lookup;
+        auto generation = m_generation.load();
+
+        if (cache.manager != this || cache.buffer != buffer || cache.generation != generation)
+        {
+            std::lock_guard<std::mutex> lock { m_mutex };
+
+            auto it = m_buffers.find(buffer);
+            if (it == m_buffers.end())
+            {
+                return SourceLocation {};
+            }
+
+            auto& f = m_files[it->second - 1];
+            cache = lookup_cache { this, buffer, generation, f.base, f.size };
+        }
+
+        if (offset > cache.size)
+        {
+            return SourceLocation {};
+        }
+
+        return SourceLocation { cache.base + static_cast<std::uint32_t>(offset) };
+    }
+
+    const SourceManager::file_entry& SourceManager::entry(SourceLocation loc) const
+    {
+        assert(loc.valid());
+
+        // Files are added in order of their base location, so the one we
+        // want is the last to start at or before this location.
+        auto it = std::upper_bound(m_files.begin(), m_files.end(), loc.raw(),
+            [](std::uint32_t raw, const file_entry& f) { return raw < f.base; });
+
+        assert(it != m_files.begin());
+        return *(it - 1);
+    }
+
+    std::size_t SourceManager::line_index(const file_entry& f, std::size_t offset) const
+    {
+        // Number of line breaks before the offset, i.e., the 0-based line.
+        return std::upper_bound(f.line_starts.begin(), f.line_starts.end(), offset)
+            - f.line_starts.begin();
+    }
+
+    FileId SourceManager::file(SourceLocation loc) const
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        return static_cast<FileId>(&entry(loc) - m_files.data()) + 1;
+    }
+
+    std::size_t SourceManager::offset(SourceLocation loc) const
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        return loc.raw() - entry(loc).base;
+    }
+
+    std::string SourceManager::name(SourceLocation loc) const
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        return entry(loc).name;
+    }
+
+    std::size_t SourceManager::line(SourceLocation loc) const
+    {
+        return presumed(loc).line;
+    }
+
+    std::size_t SourceManager::column(SourceLocation loc) const
+    {
+        return presumed(loc).column;
+    }
+
+    PresumedLocation SourceManager::presumed(SourceLocation loc) const
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+
+        auto& f = entry(loc);
+        std::size_t offset = loc.raw() - f.base;
+        auto line = line_index(f, offset);
+        std::size_t line_start = line == 0 ? 0 : f.line_starts[line - 1];
+
+        return PresumedLocation { f.name, line + 1, offset - line_start + 1, offset };
+    }
+
+    std::size_t SourceManager::size() const
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        return m_files.size() - m_removed;
+    }
+
+    std::ostream& operator<<(std::ostream& os, const SourceLocation& loc)
+    {
+        if (!loc.valid())
+        {
+            return os << "<unknown>";
+        }
+
+        auto p = SourceManager::global().presumed(loc);
+        return os << p.name << ':' << p.line << ':' << p.column;
+    }
+}}
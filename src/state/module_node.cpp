@@ -1,11 +1,11 @@
 #include "state/module_node.hpp"
 
 namespace rhea { namespace state {
-    ModuleScopeNode::ModuleScopeNode(std::string n, ModuleScopeNode* p)
+    ModuleScopeNode::ModuleScopeNode(util::InternedString n, ModuleScopeNode* p)
         : name(n), parent(p)
     {}
 
-    ModuleScopeNode::ModuleScopeNode(std::string n) : ModuleScopeNode(n, nullptr)
+    ModuleScopeNode::ModuleScopeNode(util::InternedString n) : ModuleScopeNode(n, nullptr)
     {}
 
     ModuleScopeNode::ModuleScopeNode(ModuleScopeNode* p) : ModuleScopeNode("", p)
@@ -14,11 +14,12 @@ namespace rhea { namespace state {
     ModuleScopeNode::ModuleScopeNode() : ModuleScopeNode("", nullptr)
     {}
 
-    ast::ASTNode* ModuleScopeNode::find_symbol(std::string sym)
+    ast::ASTNode* ModuleScopeNode::find_symbol(util::InternedString sym)
     {
-        if (symbol_table.count(sym) > 0)
+        auto it = symbol_table.find(sym);
+        if (it != symbol_table.end())
         {
-            return symbol_table[sym];
+            return it->second;
         }
         else if (parent == nullptr)
         {
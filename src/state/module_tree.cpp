@@ -11,7 +11,7 @@ namespace rhea { namespace state {
     ModuleScopeTree::ModuleScopeTree() : ModuleScopeTree("")
     {}
 
-    void ModuleScopeTree::begin_scope(std::string name = "(unnamed)")
+    void ModuleScopeTree::begin_scope(util::InternedString name = "(unnamed)")
     {
         auto new_scope = std::make_unique<ModuleScopeNode>(name, current_scope);
 
@@ -20,14 +20,16 @@ namespace rhea { namespace state {
 
         current_scope->children.push_back(std::move(new_scope));
         current_scope = ptr;
+        m_visible.push();
     }
 
     void ModuleScopeTree::end_scope()
     {
         current_scope = current_scope->parent;
+        m_visible.pop();
     }
 
-    void ModuleScopeTree::add_symbol(std::string sym, ast::ASTNode* node)
+    void ModuleScopeTree::add_symbol(util::InternedString sym, ast::ASTNode* node)
     {
         if (current_scope->symbol_table.count(sym) > 0)
         {
@@ -41,26 +43,13 @@ namespace rhea { namespace state {
         else
         {
             current_scope->symbol_table[sym] = node;
+            m_visible.insert(sym, node);
         }
     }
 
-    ast::ASTNode* ModuleScopeTree::find_symbol(std::string sym)
+    ast::ASTNode* ModuleScopeTree::find_symbol(util::InternedString sym)
     {
-        auto cs = current_scope;
-        ast::ASTNode* result = nullptr;
-
-        while (result == nullptr && cs != nullptr)
-        {
-            if (cs->symbol_table.count(sym) > 0)
-            {
-                result = cs->symbol_table[sym];
-            }
-            else
-            {
-                cs = cs->parent;
-            }
-        }
-
-        return result;
+        auto result = m_visible.find(sym);
+        return result != nullptr ? *result : nullptr;
     }
 }}
\ No newline at end of file
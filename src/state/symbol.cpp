@@ -9,30 +9,26 @@ namespace rhea { namespace state {
             push();
         }
 
-        m_stack.back().symbol_table[sym.name] = sym;
+        m_table.insert(sym.name, sym);
     }
 
-    bool ScopeManager::is_local(std::string s)
+    bool ScopeManager::is_local(util::InternedString s)
     {
-        const auto local = m_stack.back();
-        return (local.symbol_table.find(s) != local.symbol_table.end());
+        return m_table.is_local(s);
     }
 
-    SymbolSearchResult ScopeManager::find(std::string key)
+    SymbolSearchResult ScopeManager::find(util::InternedString key)
     {
         SymbolSearchResult opt {};
 
-        // We search backwards through the scope stack to find the latest declaration
-        // of the desired symbol.
-        for (auto s = m_stack.rbegin(); s != m_stack.rend(); ++s)
-        {
-            auto sym = s->symbol_table.find(key);
+        // The table always gives us the latest declaration of the desired
+        // symbol, so there's no need to search outer scopes ourselves.
+        auto sym = m_table.find(key);
 
-            if (sym != s->symbol_table.end())
-            {
-                opt = std::make_pair(std::ref(sym->second), s->name);
-                break;
-            }
+        if (sym != nullptr)
+        {
+            auto& scope = m_stack[m_table.depth_of(key) - 1];
+            opt = std::make_pair(std::ref(*sym), scope.name);
         }
 
         return opt;
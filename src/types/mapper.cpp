@@ -27,7 +27,7 @@ namespace rhea { namespace types {
         type_map["nothing"]     = NothingType();
     }
 
-    bool TypeMapper::add_type_definition(std::string s, TypeInfo ti)
+    bool TypeMapper::add_type_definition(util::InternedString s, TypeInfo ti)
     {
         // This will not update an existing type definition, because we don't
         // want to risk allowing user code to, for instance, overwrite the
@@ -45,7 +45,7 @@ namespace rhea { namespace types {
         }
     }
 
-    util::optional<TypeInfo> TypeMapper::remove_type_definition(std::string s)
+    util::optional<TypeInfo> TypeMapper::remove_type_definition(util::InternedString s)
     {
         if (is_type_defined(s))
         {
@@ -39,9 +39,9 @@ namespace rhea { namespace types {
             mangled += fmt::format("{0}{1}", name.length(), name);
         }
 
-        if (function_type.return_type != nullptr)
+        if (function_type.return_type != 0)
         {
-            mangled += internal::mangle_argument_name(function_type.return_type);
+            mangled += TypeTable::global().mangled(function_type.return_type);
         }
         else
         {
@@ -57,10 +57,7 @@ namespace rhea { namespace types {
         {
             for (auto&& t : function_type.argument_types)
             {
-                auto fn = [&] (auto const& e) { return internal::mangle_argument_name(e); };
-                auto result = util::visit(fn, t.second->type());
-
-                mangled += result;
+                mangled += TypeTable::global().mangled(t.second);
             }
         }
 
@@ -0,0 +1,238 @@
+#include "types/type_table.hpp"
+#include "types/name_mangle.hpp"
+#include "types/to_string.hpp"
+
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+namespace rhea { namespace types {
+    namespace {
+        void hash_combine(std::size_t& seed, std::size_t value)
+        {
+            seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        }
+
+        // Builds the parts of a key for each kind of type.
+        struct key_builder
+        {
+            std::vector<std::uint64_t>& parts;
+            std::vector<std::string>& names;
+
+            void operator()(const UnknownType&) {}
+            void operator()(const NothingType&) {}
+            void operator()(const AnyType&) {}
+
+            // Equality for simple types only looks at the basic type, so
+            // interning has to do the same.
+            void operator()(const SimpleType& t)
+            {
+                parts.push_back(static_cast<std::uint64_t>(t.type));
+            }
+
+            void operator()(const FunctionType& t)
+            {
+                parts.push_back(t.return_type);
+                for (auto&& a : t.argument_types)
+                {
+                    names.push_back(a.first);
+                    parts.push_back(a.second);
+                }
+            }
+
+            void operator()(const OptionalType& t)
+            {
+                parts.push_back(t.contained_type);
+            }
+
+            void operator()(const VariantType& t)
+            {
+                parts.insert(parts.end(), t.types.begin(), t.types.end());
+            }
+
+            void operator()(const StructureType& t)
+            {
+                for (auto&& f : t.fields)
+                {
+                    names.push_back(f.first);
+                    parts.push_back(f.second);
+                }
+            }
+        };
+    }
+
+    std::size_t TypeTable::key_hash::operator()(const key& k) const
+    {
+        std::size_t seed = k.kind;
+
+        for (auto p : k.parts)
+        {
+            hash_combine(seed, std::hash<std::uint64_t>{}(p));
+        }
+
+        for (auto& n : k.names)
+        {
+            hash_combine(seed, std::hash<std::string>{}(n));
+        }
+
+        return seed;
+    }
+
+    TypeTable::key TypeTable::key_of(const TypeInfo& t)
+    {
+        key k { t.type().index(), {}, {} };
+        util::visit(key_builder { k.parts, k.names }, t.type());
+        return k;
+    }
+
+    TypeTable::TypeTable()
+    {
+        // ID 0 is always the unknown type.
+        intern(UnknownType());
+    }
+
+    TypeTable& TypeTable::global()
+    {
+        static TypeTable table;
+        return table;
+    }
+
+    TypeId TypeTable::intern(const TypeInfo& t)
+    {
+        auto k = key_of(t);
+
+        std::lock_guard<std::mutex> lock { m_mutex };
+
+        auto it = m_ids.find(k);
+        if (it != m_ids.end())
+        {
+            return it->second;
+        }
+
+        if (m_entries.size() >= std::numeric_limits<TypeId>::max())
+        {
+            throw std::overflow_error("Too many distinct types");
+        }
+
+        // Simple types are keyed only on their basic type, so store the
+        // canonical form, with the flags that go with it. Otherwise, which
+        // flags we get back would depend on who interned the type first.
+        TypeInfo canonical = t;
+        if (auto st = util::get_if<SimpleType>(&canonical.type()))
+        {
+            *st = SimpleType(st->type);
+        }
+
+        auto id = static_cast<TypeId>(m_entries.size());
+        m_entries.push_back(entry { canonical });
+        m_ids.emplace(std::move(k), id);
+
+        return id;
+    }
+
+    const TypeInfo& TypeTable::get(TypeId id) const
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+
+        assert(id < m_entries.size());
+        return m_entries[id].type;
+    }
+
+    bool TypeTable::compatible(TypeId lhs, TypeId rhs)
+    {
+        auto pair_key = (static_cast<std::uint64_t>(lhs) << 32) | rhs;
+
+        {
+            std::lock_guard<std::mutex> lock { m_mutex };
+
+            auto it = m_compatible.find(pair_key);
+            if (it != m_compatible.end())
+            {
+                return it->second;
+            }
+        }
+
+        // Work it out without holding the lock, since it might need to look
+        // up other types. If two threads race, they'll get the same answer.
+        auto result = types::compatible(get(lhs), get(rhs));
+
+        std::lock_guard<std::mutex> lock { m_mutex };
+        m_compatible.emplace(pair_key, result);
+
+        return result;
+    }
+
+    const std::string& TypeTable::name(TypeId id)
+    {
+        {
+            std::lock_guard<std::mutex> lock { m_mutex };
+
+            assert(id < m_entries.size());
+            if (m_entries[id].has_name)
+            {
+                return m_entries[id].name;
+            }
+        }
+
+        auto result = to_string(get(id));
+
+        std::lock_guard<std::mutex> lock { m_mutex };
+
+        auto& e = m_entries[id];
+        if (!e.has_name)
+        {
+            e.name = std::move(result);
+            e.has_name = true;
+        }
+
+        return e.name;
+    }
+
+    const std::string& TypeTable::mangled(TypeId id)
+    {
+        {
+            std::lock_guard<std::mutex> lock { m_mutex };
+
+            assert(id < m_entries.size());
+            if (m_entries[id].has_mangled)
+            {
+                return m_entries[id].mangled;
+            }
+        }
+
+        // This may throw for types that can't be mangled yet. Nothing is
+        // cached in that case, so we'll throw again next time.
+        auto result = util::visit(
+            [](const auto& t) { return internal::mangle_argument_name(t); },
+            get(id).type()
+        );
+
+        std::lock_guard<std::mutex> lock { m_mutex };
+
+        auto& e = m_entries[id];
+        if (!e.has_mangled)
+        {
+            e.mangled = std::move(result);
+            e.has_mangled = true;
+        }
+
+        return e.mangled;
+    }
+
+    std::size_t TypeTable::size() const
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        return m_entries.size();
+    }
+
+    TypeId intern_type(const TypeInfo& t)
+    {
+        return TypeTable::global().intern(t);
+    }
+
+    const TypeInfo& type_for_id(TypeId id)
+    {
+        return TypeTable::global().get(id);
+    }
+}}
@@ -0,0 +1,116 @@
+#include "util/interned_string.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace rhea { namespace util {
+    namespace {
+        /*
+         * The table maps strings to handles with an ordinary hash map, which
+         * only needs to be touched when interning. Going the other way, from
+         * a handle to its string, happens far more often (every time a name
+         * is printed or passed to LLVM), so that side doesn't take a lock.
+         * Handles index into fixed-size chunks that are never moved or freed
+         * once published, and each points at a key in the hash map, which
+         * is node-based and so never moves either.
+         */
+        class string_table
+        {
+            public:
+            static constexpr std::size_t chunk_bits = 16;
+            static constexpr std::size_t chunk_size = std::size_t(1) << chunk_bits;
+            static constexpr std::size_t max_chunks = std::size_t(1) << 12;
+
+            string_table()
+            {
+                // Handle 0 is always the empty string.
+                intern(std::string {});
+            }
+
+            std::uint32_t intern(const std::string& s)
+            {
+                std::lock_guard<std::mutex> lock { m_mutex };
+
+                auto it = m_ids.find(s);
+                if (it != m_ids.end())
+                {
+                    return it->second;
+                }
+
+                auto id = m_count;
+                auto chunk = id >> chunk_bits;
+
+                if (chunk >= max_chunks)
+                {
+                    throw std::overflow_error("Too many interned strings");
+                }
+
+                if (m_chunks[chunk].load(std::memory_order_relaxed) == nullptr)
+                {
+                    m_owned[chunk].reset(new std::atomic<const std::string*>[chunk_size]());
+                    m_chunks[chunk].store(m_owned[chunk].get(), std::memory_order_release);
+                }
+
+                auto inserted = m_ids.emplace(s, id).first;
+                m_chunks[chunk].load(std::memory_order_relaxed)[id & (chunk_size - 1)]
+                    .store(&inserted->first, std::memory_order_release);
+
+                ++m_count;
+                return id;
+            }
+
+            const std::string& lookup(std::uint32_t id) const
+            {
+                auto chunk = m_chunks[id >> chunk_bits].load(std::memory_order_acquire);
+                assert(chunk != nullptr);
+
+                auto str = chunk[id & (chunk_size - 1)].load(std::memory_order_acquire);
+                assert(str != nullptr);
+
+                return *str;
+            }
+
+            std::size_t size() const
+            {
+                std::lock_guard<std::mutex> lock { m_mutex };
+                return m_count;
+            }
+
+            private:
+            mutable std::mutex m_mutex;
+            std::unordered_map<std::string, std::uint32_t> m_ids;
+            std::uint32_t m_count = 0;
+
+            std::atomic<std::atomic<const std::string*>*> m_chunks[max_chunks] {};
+            std::unique_ptr<std::atomic<const std::string*>[]> m_owned[max_chunks];
+        };
+
+        string_table& table()
+        {
+            static string_table t;
+            return t;
+        }
+    }
+
+    InternedString::InternedString(const std::string& s)
+        : m_id(table().intern(s))
+    {}
+
+    InternedString::InternedString(const char* s)
+        : InternedString(std::string(s))
+    {}
+
+    const std::string& InternedString::str() const
+    {
+        return table().lookup(m_id);
+    }
+
+    std::size_t interned_count()
+    {
+        return table().size();
+    }
+}}
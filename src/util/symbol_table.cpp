@@ -0,0 +1,103 @@
+#include "util/symbol_table.hpp"
+
+#include <cassert>
+#include <limits>
+
+#include <fmt/format.h>
+
+namespace rhea { namespace util {
+    SymbolTable::SymbolTable(hash_function h) : m_hash(h) {}
+
+    SymbolTable& SymbolTable::global()
+    {
+        static SymbolTable table;
+        return table;
+    }
+
+    SymbolId SymbolTable::intern(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        return intern_locked(name);
+    }
+
+    SymbolId SymbolTable::intern_locked(const std::string& name)
+    {
+        auto it = m_ids.find(name);
+        if (it != m_ids.end())
+        {
+            return it->second;
+        }
+
+        if (m_entries.size() >= std::numeric_limits<SymbolId>::max())
+        {
+            throw std::overflow_error("Too many distinct symbols");
+        }
+
+        auto hash = m_hash(name);
+
+        auto other = m_hashes.find(hash);
+        if (other != m_hashes.end())
+        {
+            throw symbol_collision(fmt::format("Symbols @{0} and @{1} have the same hash {2:#018x}",
+                m_entries[other->second].name, name, hash));
+        }
+
+        auto id = static_cast<SymbolId>(m_entries.size());
+        m_entries.push_back(entry { name, hash });
+        m_ids.emplace(name, id);
+        m_hashes.emplace(hash, id);
+
+        return id;
+    }
+
+    std::vector<SymbolId> SymbolTable::intern_enum(const std::string& name, const std::vector<std::string>& members)
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+
+        std::vector<SymbolId> ids;
+        ids.reserve(members.size());
+        for (auto& m : members)
+        {
+            ids.push_back(intern_locked(m));
+        }
+
+        auto it = m_enums.find(name);
+        if (it != m_enums.end() && it->second != ids)
+        {
+            throw std::invalid_argument(fmt::format("Enum {0} redeclared with different members", name));
+        }
+
+        m_enums[name] = ids;
+        return ids;
+    }
+
+    const std::vector<SymbolId>* SymbolTable::enum_members(const std::string& name) const
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+
+        auto it = m_enums.find(name);
+        return it != m_enums.end() ? &it->second : nullptr;
+    }
+
+    const std::string& SymbolTable::name(SymbolId id) const
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+
+        assert(id < m_entries.size());
+        return m_entries[id].name;
+    }
+
+    std::uint64_t SymbolTable::abi_hash(SymbolId id) const
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+
+        assert(id < m_entries.size());
+        return m_entries[id].hash;
+    }
+
+    std::size_t SymbolTable::size() const
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        return m_entries.size();
+    }
+}}
@@ -0,0 +1,174 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <stdexcept>
+
+#include <tao/pegtl.hpp>
+
+#include "../../include/ast.hpp"
+#include "../../include/grammar.hpp"
+
+#include "test_setup.hpp"
+
+using tao::pegtl::string_input;
+namespace pt = tao::pegtl::parse_tree;
+namespace gr = rhea::grammar;
+namespace ast = rhea::ast;
+
+namespace {
+    std::unique_ptr<ast::parser_node> tree_builder(string_input<>& in)
+    {
+        return pt::parse<
+            gr::program_definition,
+            ast::parser_node,
+            ast::tree_selector
+        >(in);
+    }
+
+    BOOST_AUTO_TEST_SUITE (AST_arena)
+
+    BOOST_AUTO_TEST_CASE (arena_allocate_aligned)
+    {
+        ast::Arena arena { 128 };
+
+        auto a = arena.allocate(3, 1);
+        auto b = arena.allocate(8, 8);
+        auto c = arena.allocate(16, 16);
+
+        BOOST_TEST((reinterpret_cast<std::uintptr_t>(b) % 8 == 0));
+        BOOST_TEST((reinterpret_cast<std::uintptr_t>(c) % 16 == 0));
+        BOOST_TEST((static_cast<char*>(b) > static_cast<char*>(a)));
+        BOOST_TEST((static_cast<char*>(c) > static_cast<char*>(b)));
+        BOOST_TEST(arena.block_count() == 1);
+
+        // Too big for the current block, so it needs a new one.
+        arena.allocate(512, 8);
+        BOOST_TEST(arena.block_count() == 2);
+
+        arena.release();
+        BOOST_TEST(arena.block_count() == 0);
+        BOOST_TEST(arena.bytes_used() == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE (arena_scope_nesting)
+    {
+        BOOST_TEST((ast::Arena::current() == nullptr));
+
+        ast::Arena outer, inner;
+        {
+            ast::ArenaScope s1 { outer };
+            BOOST_TEST((ast::Arena::current() == &outer));
+            {
+                ast::ArenaScope s2 { inner };
+                BOOST_TEST((ast::Arena::current() == &inner));
+            }
+            BOOST_TEST((ast::Arena::current() == &outer));
+        }
+
+        BOOST_TEST((ast::Arena::current() == nullptr));
+    }
+
+    BOOST_AUTO_TEST_CASE (arena_node_lifetime)
+    {
+        ast::Arena arena;
+
+        // Nodes made outside a scope use the heap.
+        auto heap_node = std::make_unique<ast::Integer>(1);
+        BOOST_TEST(arena.live_nodes() == 0);
+
+        {
+            ast::ArenaScope scope { arena };
+            auto first = std::make_unique<ast::Integer>(2);
+            auto second = std::make_unique<ast::Boolean>(true);
+
+            BOOST_TEST(arena.live_nodes() == 2);
+            BOOST_TEST(arena.bytes_used() > 0);
+
+            // Allocation order is address order within a block.
+            BOOST_TEST((static_cast<void*>(second.get()) > static_cast<void*>(first.get())));
+        }
+
+        BOOST_TEST(arena.live_nodes() == 0);
+        BOOST_TEST(heap_node->value == 1);
+    }
+
+    BOOST_AUTO_TEST_CASE (arena_release_live_nodes)
+    {
+        ast::Arena arena;
+        std::unique_ptr<ast::Integer> node;
+
+        {
+            ast::ArenaScope scope { arena };
+            node = std::make_unique<ast::Integer>(1);
+        }
+
+        // Freeing the memory under a live node would leave it dangling.
+        BOOST_CHECK_THROW(arena.release(), std::logic_error);
+        BOOST_TEST(arena.block_count() == 1);
+
+        // Heap nodes still go back to the heap while the arena has blocks.
+        auto heap_node = std::make_unique<ast::Integer>(2);
+        heap_node.reset();
+        BOOST_TEST(arena.live_nodes() == 1);
+
+        node.reset();
+        arena.release();
+        BOOST_TEST(arena.block_count() == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE (arena_nodes_remember_their_arena)
+    {
+        ast::Arena first, second;
+        std::unique_ptr<ast::Integer> node;
+
+        {
+            ast::ArenaScope scope { first };
+            node = std::make_unique<ast::Integer>(1);
+
+            // Nodes that don't come from `new` aren't counted.
+            ast::Integer local { 2 };
+        }
+
+        BOOST_TEST(first.live_nodes() == 1);
+
+        // Deleting goes back to the node's own arena, whichever one is
+        // current at the time.
+        {
+            ast::ArenaScope scope { second };
+            node.reset();
+        }
+
+        BOOST_TEST(first.live_nodes() == 0);
+        BOOST_TEST(second.live_nodes() == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE (arena_build_program)
+    {
+        std::string sample { "def main = { var x = 1 + 2 * 3; return x > 4; }" };
+
+        BOOST_TEST_MESSAGE("Building arena-backed program " << sample);
+        string_input<> in(sample, "test");
+
+        auto tree = tree_builder(in);
+
+        ast::Arena arena;
+        std::string expected = ast::build_ast(tree.get())->to_string();
+
+        {
+            auto node = ast::build_ast(tree.get(), arena);
+
+            BOOST_TEST(arena.live_nodes() > 0);
+            BOOST_TEST(node->to_string() == expected);
+        }
+
+        // The whole tree is gone, so the memory can go back in one step.
+        BOOST_TEST(arena.live_nodes() == 0);
+        arena.release();
+        BOOST_TEST(arena.block_count() == 0);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
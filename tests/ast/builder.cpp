@@ -356,6 +356,21 @@ namespace {
         BOOST_TEST_MESSAGE((node->position));
         BOOST_TEST((node->to_string() ==
             "(BareExpression,(Call,(Identifier,f),(NamedArgument,a,(Integral,1,0)),(NamedArgument,b,(Integral,2,0))))"));
+
+        std::string predicate { "valid(x)?;" };
+
+        BOOST_TEST_MESSAGE("Parsing predicate call " << predicate);
+        string_input<> in_predicate(predicate, "test");
+
+        tree = tree_builder<gr::bare_expression>(in_predicate);
+
+        node = ast::internal::create_statement_node(tree->children.front().get());
+
+        BOOST_TEST((node->to_string() == "(BareExpression,(Call,(Identifier,valid),(Identifier,x)))"));
+
+        auto call = dynamic_cast<ast::Call*>(static_cast<ast::BareExpression*>(node.get())->expression.get());
+        BOOST_TEST_REQUIRE((call != nullptr));
+        BOOST_TEST((call->type == ast::FunctionType::Predicate));
     }
 
     BOOST_AUTO_TEST_CASE (builder_variable_declaration)
@@ -1074,5 +1089,30 @@ namespace {
             "(Program,(Def,0,main,null,null,(Conditions),(Block,(Return,(Boolean,true)))))"));
     }
 
+    BOOST_AUTO_TEST_CASE (builder_node_rule_ids)
+    {
+        std::string sample { "a + f(1);" };
+
+        BOOST_TEST_MESSAGE("Checking rule IDs for " << sample);
+        string_input<> in(sample, "test");
+
+        auto tree = tree_builder<gr::bare_expression>(in);
+
+        // The root has no rule, while every other node should have the ID
+        // of the rule that made it.
+        BOOST_TEST((tree->rule == ast::unknown_rule_id));
+
+        auto& stmt = tree->children.front();
+        BOOST_TEST((stmt->rule == ast::rule_id<gr::bare_expression>::value));
+
+        auto& expr = stmt->children.front();
+        BOOST_TEST((expr->rule == ast::rule_id<gr::add_operator>::value));
+        BOOST_TEST((expr->children.at(1)->rule == ast::rule_id<gr::function_call_expr>::value));
+
+        // Rules the builder doesn't dispatch on all share the "unknown" ID.
+        BOOST_TEST((ast::rule_id<gr::program_definition>::value == ast::unknown_rule_id));
+        BOOST_TEST((ast::rule_id<gr::add_operator>::value != ast::rule_id<gr::subtract_operator>::value));
+    }
+
     BOOST_AUTO_TEST_SUITE_END ()
 }
\ No newline at end of file
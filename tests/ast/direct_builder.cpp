@@ -0,0 +1,176 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <boost/test/data/monomorphic.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include <tao/pegtl.hpp>
+
+#include "../../include/ast.hpp"
+#include "../../include/grammar.hpp"
+#include "../../include/source/source_manager.hpp"
+
+#include "test_setup.hpp"
+
+namespace data = boost::unit_test::data;
+using tao::pegtl::string_input;
+namespace pt = tao::pegtl::parse_tree;
+namespace gr = rhea::grammar;
+namespace ast = rhea::ast;
+using rhea::source::SourceManager;
+
+namespace {
+    // The regular two-phase builder, as a reference.
+    template <typename GrammarNode>
+    std::unique_ptr<ast::parser_node> tree_builder(string_input<>& in)
+    {
+        return pt::parse<
+            GrammarNode,
+            ast::parser_node,
+            ast::tree_selector
+        >(in);
+    }
+
+    SourceManager& sources = SourceManager::global();
+
+    // Datasets
+    std::string expression_samples[] = {
+        "42",
+        "-123_l",
+        "0xdeadbeef",
+        "3.14_f",
+        "true",
+        "nothing",
+        "'single' + \"double\"",
+        "@sym",
+        "foo:bar:baz",
+        ":foo:bar",
+        "a + b * c - d / e",
+        "x ** 2 ** 3",
+        "a << 1 >= b & c",
+        "not a and b or c",
+        "-x + ~y * ^z",
+        "if a > b then a else b",
+        "x as integer",
+        "y is |integer|?",
+        "z as list <string> [10]",
+        "f()",
+        "f(1, 2 + 3)",
+        "f(a: 1, b: 2)",
+        "valid(x)?",
+        "a.b.c(1)[2]",
+        "[1, 2, 3]",
+        "(1, 2)",
+        "{1, 'a', @b}",
+        "@{a, b, c}",
+        "{ @a: 1, 2: 'b' }",
+        "(a + b) * c"
+    };
+
+    std::string statement_samples[] = {
+        "foo(bar);",
+        "var x = y * z;",
+        "var x as list <string>;",
+        "const x = 42;",
+        "x[1] = 'foo';",
+        "i -= 1;",
+        "x **= 2;",
+        "{ a = 1; b = 2; }",
+        "if x > 0 { do foo; } else { bar(); }",
+        "unless x == nothing { do x; }",
+        "while x < 10 { x += 1; if x == 5 { break; } continue; }"
+    };
+
+    // Test cases
+    BOOST_AUTO_TEST_SUITE (AST_direct_builder)
+
+    BOOST_DATA_TEST_CASE(direct_expression_matches_builder, data::make(expression_samples))
+    {
+        string_input<> tree_in(sample, "test");
+        rhea::source::ScopedBuffer tree_buffer { tree_in };
+        auto tree = tree_builder<gr::expression>(tree_in);
+        auto expected = ast::internal::create_expression_node(tree->children.front().get());
+
+        string_input<> direct_in(sample, "test");
+        rhea::source::ScopedBuffer direct_buffer { direct_in };
+        auto node = ast::build_expression_direct(direct_in);
+
+        BOOST_TEST_REQUIRE(node != nullptr);
+        BOOST_TEST_MESSAGE("Testing AST Node " << node->to_string());
+
+        BOOST_TEST((node->to_string() == expected->to_string()));
+        BOOST_TEST((sources.offset(node->position) == sources.offset(expected->position)));
+    }
+
+    BOOST_DATA_TEST_CASE(direct_statement_matches_builder, data::make(statement_samples))
+    {
+        string_input<> tree_in(sample, "test");
+        auto tree = tree_builder<gr::stmt_or_block>(tree_in);
+        auto expected = ast::internal::create_statement_node(tree->children.front().get());
+
+        string_input<> direct_in(sample, "test");
+        auto node = ast::build_statement_direct(direct_in);
+
+        BOOST_TEST_REQUIRE(node != nullptr);
+        BOOST_TEST_MESSAGE("Testing AST Node " << node->to_string());
+
+        BOOST_TEST((node->to_string() == expected->to_string()));
+    }
+
+    BOOST_AUTO_TEST_CASE (direct_call_suffix)
+    {
+        std::string sample { "valid(x)? or f(y)!" };
+        string_input<> in(sample, "test");
+        rhea::source::ScopedBuffer buffer { in };
+
+        auto node = ast::build_expression_direct(in);
+        auto op = dynamic_cast<ast::BinaryOp*>(node.get());
+        BOOST_TEST_REQUIRE((op != nullptr));
+
+        auto lhs = dynamic_cast<ast::Call*>(op->left.get());
+        auto rhs = dynamic_cast<ast::Call*>(op->right.get());
+        BOOST_TEST_REQUIRE((lhs != nullptr && rhs != nullptr));
+        BOOST_TEST((lhs->type == ast::FunctionType::Predicate));
+        BOOST_TEST((rhs->type == ast::FunctionType::Unchecked));
+    }
+
+    BOOST_AUTO_TEST_CASE (direct_no_match)
+    {
+        std::string sample { ";" };
+        string_input<> in(sample, "test");
+
+        BOOST_TEST((ast::build_expression_direct(in) == nullptr));
+    }
+
+    BOOST_AUTO_TEST_CASE (direct_unsupported_statement)
+    {
+        std::string sample { "match x { on 1: foo(); }" };
+        string_input<> in(sample, "test");
+
+        BOOST_CHECK_THROW(ast::build_statement_direct(in), ast::unimplemented_type);
+    }
+
+    BOOST_AUTO_TEST_CASE (direct_program_matches_builder)
+    {
+        std::string sample { "const x = 42;\nvar y = x * 2;\n" };
+
+        string_input<> tree_in(sample, "test");
+        auto expected = ast::build_ast(tree_builder<gr::translation_unit>(tree_in).get());
+
+        string_input<> direct_in(sample, "test");
+        auto node = ast::build_program_direct(direct_in);
+
+        BOOST_TEST_REQUIRE(node != nullptr);
+        BOOST_TEST((node->to_string() == expected->to_string()));
+
+        // Modules aren't covered yet.
+        std::string module { "module foo;\nconst x = 42;\n" };
+        string_input<> module_in(module, "test");
+
+        BOOST_CHECK_THROW(ast::build_program_direct(module_in), ast::unimplemented_type);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
@@ -0,0 +1,121 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <memory>
+#include <vector>
+
+#include <tao/pegtl.hpp>
+
+#include "../../include/ast.hpp"
+#include "../../include/grammar.hpp"
+
+#include "test_setup.hpp"
+
+using tao::pegtl::string_input;
+namespace pt = tao::pegtl::parse_tree;
+namespace gr = rhea::grammar;
+namespace ast = rhea::ast;
+
+namespace {
+    BOOST_AUTO_TEST_SUITE (AST_node_map)
+
+    BOOST_AUTO_TEST_CASE (node_ids_are_sequential)
+    {
+        auto a = std::make_unique<ast::Integer>(1);
+        auto b = std::make_unique<ast::Integer>(2);
+
+        BOOST_TEST(b->id == a->id + 1);
+        BOOST_TEST(ast::ASTNode::id_count() > b->id);
+
+        // Copies are different nodes.
+        ast::Integer c { *a };
+        BOOST_TEST(c.id != a->id);
+    }
+
+    BOOST_AUTO_TEST_CASE (built_tree_ids)
+    {
+        std::string sample { "def main = { var x = 1 + 2; }" };
+        string_input<> in(sample, "ids");
+
+        auto first = ast::ASTNode::id_count();
+        auto tree = pt::parse<
+            gr::program_definition,
+            ast::parser_node,
+            ast::tree_selector
+        >(in);
+        auto program = ast::build_ast(tree.get());
+        auto last = ast::ASTNode::id_count();
+
+        // Every node from the build falls in one dense range.
+        BOOST_TEST(program->id >= first);
+        BOOST_TEST(program->id < last);
+    }
+
+    BOOST_AUTO_TEST_CASE (node_map_operations)
+    {
+        auto a = std::make_unique<ast::Integer>(1);
+        auto b = std::make_unique<ast::Integer>(2);
+        ast::NodeMap<std::string> m;
+
+        BOOST_TEST(m.empty());
+        BOOST_TEST((m.find(a.get()) == nullptr));
+
+        m[a.get()] = "a";
+        BOOST_TEST(m.size() == 1);
+        BOOST_TEST(m.count(a.get()) == 1);
+        BOOST_TEST(m.count(b.get()) == 0);
+        BOOST_TEST(*m.find(a.get()) == "a");
+
+        // Only the part of the table around the entry is allocated.
+        BOOST_TEST(m.capacity() > 0);
+        BOOST_TEST(m.capacity() < ast::ASTNode::id_count());
+
+        m[b.get()] = "b";
+        auto copy = m;
+        m.erase(a.get());
+
+        BOOST_TEST(m.size() == 1);
+        BOOST_TEST((m.find(a.get()) == nullptr));
+        BOOST_TEST(copy.size() == 2);
+        BOOST_TEST(*copy.find(a.get()) == "a");
+    }
+
+    BOOST_AUTO_TEST_CASE (node_map_small_for_new_trees)
+    {
+        // Lots of older nodes, most of them already gone.
+        std::vector<std::unique_ptr<ast::Integer>> old;
+        for (int i = 0; i < 100000; ++i)
+        {
+            old.push_back(std::make_unique<ast::Integer>(i));
+        }
+        old.resize(10);
+
+        std::vector<std::unique_ptr<ast::Integer>> tree;
+        for (int i = 0; i < 10; ++i)
+        {
+            tree.push_back(std::make_unique<ast::Integer>(i));
+        }
+
+        ast::NodeMap<int> m;
+        for (auto& n : tree)
+        {
+            m[n.get()] = 1;
+        }
+
+        // Sized for the new tree, not for every node ever made.
+        BOOST_TEST(m.size() == 10u);
+        BOOST_TEST(m.capacity() <= 512u);
+
+        // An older node can still be added later.
+        m[old.front().get()] = 2;
+        BOOST_TEST(*m.find(old.front().get()) == 2);
+        BOOST_TEST(*m.find(tree.back().get()) == 1);
+        BOOST_TEST(m.capacity() <= 1024u);
+
+        int count = 0;
+        m.for_each([&] (int) { ++count; }, tree.front()->id);
+        BOOST_TEST(count == 10);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
@@ -19,15 +19,23 @@ namespace ast = rhea::ast;
 
 namespace {
     
-    using rhea::util::any;
-    using rhea::util::any_cast;
-    using rhea::util::bad_any_cast;
+    struct StringVisitor : rhea::visitor::DefaultVisitor<std::string>
+    {
+        std::string visit(ast::Boolean* n) override { return n->to_string(); }
+        std::string visit(ast::Integer* n) override { return n->to_string(); }
+        std::string visit(ast::Double* n) override { return n->to_string(); }
+        std::string visit(ast::BinaryOp* n) override
+        {
+            return n->left->visit(this) + " " + n->right->visit(this);
+        }
+    };
 
-    struct StringVisitor : rhea::visitor::DefaultVisitor
+    struct CountingVisitor : rhea::visitor::DefaultVisitor<void>
     {
-        any visit(ast::Boolean* n) { return n->to_string(); }
-        any visit(ast::Integer* n) { return n->to_string(); }
-        any visit(ast::Double* n) { return n->to_string(); }
+        void visit(ast::Boolean* n) override { ++count; }
+        void visit(ast::Integer* n) override { ++count; }
+
+        int count = 0;
     };
 
     struct VisitorFixture
@@ -49,7 +57,7 @@ namespace {
         auto result = node->visit(&v);
 
         BOOST_TEST_MESSAGE("Visiting boolean AST node " << node->to_string());
-        BOOST_TEST((any_cast<std::string>(result) == "(Boolean,true)"));
+        BOOST_TEST((result == "(Boolean,true)"));
     }
 
     BOOST_AUTO_TEST_CASE (visit_integral_ast)
@@ -59,7 +67,7 @@ namespace {
         auto result = node->visit(&v);
 
         BOOST_TEST_MESSAGE("Visiting integer AST node " << node->to_string());
-        BOOST_TEST((any_cast<std::string>(result) == "(Integral,42,0)"));
+        BOOST_TEST((result == "(Integral,42,0)"));
     }
 
     BOOST_AUTO_TEST_CASE (visit_floating_point_ast)
@@ -69,7 +77,43 @@ namespace {
         auto result = node->visit(&v);
 
         BOOST_TEST_MESSAGE("Visiting floating-point AST node " << node->to_string());
-        BOOST_TEST((any_cast<std::string>(result) == "(FloatingPoint,1e-06,3)"));
+        BOOST_TEST((result == "(FloatingPoint,1e-06,3)"));
+    }
+
+    BOOST_AUTO_TEST_CASE (visit_unhandled_ast)
+    {
+        std::unique_ptr<ast::ASTNode> node = std::make_unique<ast::Float>(1.5f);
+
+        auto result = node->visit(&v);
+
+        BOOST_TEST_MESSAGE("Visiting unhandled AST node " << node->to_string());
+        BOOST_TEST(result.empty());
+    }
+
+    BOOST_AUTO_TEST_CASE (visit_nested_ast)
+    {
+        auto node = std::make_unique<ast::BinaryOp>(
+            ast::BinaryOperators::Add,
+            ast::make_expression<ast::Integer>(1),
+            ast::make_expression<ast::Integer>(2)
+        );
+
+        // Children's results mustn't leak into the parent's.
+        auto result = node->visit(&v);
+
+        BOOST_TEST_MESSAGE("Visiting nested AST node " << node->to_string());
+        BOOST_TEST((result == "(Integral,1,0) (Integral,2,0)"));
+    }
+
+    BOOST_AUTO_TEST_CASE (visit_void_ast)
+    {
+        CountingVisitor cv;
+        std::unique_ptr<ast::ASTNode> node = std::make_unique<ast::Boolean>(false);
+
+        node->visit(&cv);
+        node->visit(&cv);
+
+        BOOST_TEST(cv.count == 2);
     }
 
     BOOST_AUTO_TEST_SUITE_END ()
@@ -7,13 +7,18 @@
 #include <vector>
 #include <array>
 #include <iostream>
+#include <stdexcept>
 
 #include "../../include/codegen/generator.hpp"
 #include "../../include/codegen/code_visitor.hpp"
 #include "../../include/ast.hpp"
+#include "../../include/debug/parse_tree.hpp"
+#include "../../include/debug/build_ast.hpp"
 
 #include <llvm/IR/Value.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Metadata.h>
 
 #include "test_setup.hpp"
 
@@ -43,11 +48,144 @@ namespace {
 
         BOOST_TEST_MESSAGE("Codegen for binary op " << node->to_string());
 
-        auto result = util::any_cast<llvm::Value*>(gen.generate(node.get()));
+        auto result = gen.generate(node.get());
 
         BOOST_TEST((result != nullptr));
         result->print(llvm::outs(), true);
     }
 
+    BOOST_AUTO_TEST_CASE (cg_binary_op_inferred_types)
+    {
+        ast::expression_ptr l = std::make_unique<ast::Long>(42);
+        ast::expression_ptr r = std::make_unique<ast::Long>(69);
+        auto left = l.get();
+        auto right = r.get();
+        auto op = ast::BinaryOperators::Multiply;
+
+        auto node = std::make_unique<ast::BinaryOp>(op, std::move(l), std::move(r));
+
+        // Types handed over from inference are used as-is.
+        auto long_id = rhea::types::intern_type(rhea::types::SimpleType(rhea::types::BasicType::Long));
+        ast::NodeMap<rhea::types::TypeId> types;
+        types[node.get()] = long_id;
+        types[left] = long_id;
+        types[right] = long_id;
+
+        auto result = gen.generate(node.get(), std::move(types));
+
+        BOOST_TEST((result != nullptr));
+        BOOST_TEST(result->getType()->isIntegerTy(64));
+        BOOST_TEST((&gen.type_of(node.get()) == &rhea::types::type_for_id(long_id)));
+    }
+
+    BOOST_AUTO_TEST_CASE (cg_binary_op_missing_type)
+    {
+        ast::expression_ptr l = std::make_unique<ast::Long>(42);
+        ast::expression_ptr r = std::make_unique<ast::Long>(69);
+        auto left = l.get();
+
+        auto node = std::make_unique<ast::BinaryOp>(
+            ast::BinaryOperators::Multiply, std::move(l), std::move(r));
+
+        // Inferred types have to cover the whole tree; the RHS isn't here.
+        auto long_id = rhea::types::intern_type(rhea::types::SimpleType(rhea::types::BasicType::Long));
+        ast::NodeMap<rhea::types::TypeId> types;
+        types[node.get()] = long_id;
+        types[left] = long_id;
+
+        BOOST_CHECK_THROW(gen.generate(node.get(), std::move(types)), std::invalid_argument);
+    }
+
+    BOOST_AUTO_TEST_CASE (cg_binary_op_unknown_type)
+    {
+        ast::expression_ptr l = std::make_unique<ast::Long>(42);
+        ast::expression_ptr r = std::make_unique<ast::Long>(69);
+        auto left = l.get();
+        auto right = r.get();
+
+        auto node = std::make_unique<ast::BinaryOp>(
+            ast::BinaryOperators::Multiply, std::move(l), std::move(r));
+
+        // Inference couldn't work out the operation's type, so the node
+        // isn't asked for it instead.
+        auto long_id = rhea::types::intern_type(rhea::types::SimpleType(rhea::types::BasicType::Long));
+        ast::NodeMap<rhea::types::TypeId> types;
+        types[node.get()] = 0;
+        types[left] = long_id;
+        types[right] = long_id;
+
+        BOOST_CHECK_THROW(gen.generate(node.get(), std::move(types)), std::invalid_argument);
+    }
+
+    BOOST_AUTO_TEST_CASE (cg_binary_op_short_circuit)
+    {
+        // `false and (true or false)`, so both kinds get nested.
+        ast::expression_ptr inner_l = std::make_unique<ast::Boolean>(true);
+        ast::expression_ptr inner_r = std::make_unique<ast::Boolean>(false);
+        ast::expression_ptr l = std::make_unique<ast::Boolean>(false);
+        ast::expression_ptr r = std::make_unique<ast::BinaryOp>(
+            ast::BinaryOperators::BooleanOr, std::move(inner_l), std::move(inner_r));
+
+        auto node = std::make_unique<ast::BinaryOp>(
+            ast::BinaryOperators::BooleanAnd, std::move(l), std::move(r));
+
+        auto result = gen.generate(node.get());
+
+        // The result is a PHI joining the skipped path and the RHS.
+        auto phi = llvm::dyn_cast_or_null<llvm::PHINode>(result);
+        BOOST_TEST_REQUIRE((phi != nullptr));
+        BOOST_TEST(phi->getType()->isIntegerTy(1));
+        BOOST_TEST(phi->getNumIncomingValues() == 2u);
+        BOOST_TEST(phi->getParent()->getName().startswith("and.end"));
+
+        // The RHS is itself short-circuited, and its PHI feeds this one.
+        auto inner = llvm::dyn_cast<llvm::PHINode>(phi->getIncomingValue(1));
+        BOOST_TEST_REQUIRE((inner != nullptr));
+        BOOST_TEST(inner->getParent()->getName().startswith("or.end"));
+        BOOST_TEST((phi->getIncomingBlock(1) == inner->getParent()));
+    }
+
+    BOOST_AUTO_TEST_CASE (cg_binary_op_cold_rhs)
+    {
+        // The predicate call is a check that's expected to pass, so the
+        // branch into it is weighted as unlikely.
+        std::string source { "true or valid(true)?;" };
+
+        auto in = rhea::debug::input_from_string(source);
+        auto parse = rhea::debug::parse<ast::parser_node>(*in);
+        BOOST_TEST_REQUIRE((parse != nullptr));
+
+        // We take the front child because the debug parser tries to parse a program first.
+        auto tree = rhea::debug::build_ast(parse->children.front().get());
+        auto statement = dynamic_cast<ast::BareExpression*>(tree.get());
+        BOOST_TEST_REQUIRE((statement != nullptr));
+
+        auto result = gen.generate(statement->expression.get());
+
+        auto phi = llvm::dyn_cast_or_null<llvm::PHINode>(result);
+        BOOST_TEST_REQUIRE((phi != nullptr));
+
+        // The LHS block ends in the branch that skips the RHS.
+        auto br = llvm::dyn_cast<llvm::BranchInst>(phi->getIncomingBlock(0)->getTerminator());
+        BOOST_TEST_REQUIRE((br != nullptr));
+        BOOST_TEST_REQUIRE(br->isConditional());
+        BOOST_TEST(br->getSuccessor(1)->getName().startswith("or.rhs"));
+
+        auto prof = br->getMetadata(llvm::LLVMContext::MD_prof);
+        BOOST_TEST_REQUIRE((prof != nullptr));
+        BOOST_TEST_REQUIRE(prof->getNumOperands() == 3u);
+
+        // `or` skips the RHS when the LHS is true, which is the likely case.
+        auto weight = [&](unsigned i) {
+            return llvm::mdconst::extract<llvm::ConstantInt>(prof->getOperand(i))->getZExtValue();
+        };
+
+        BOOST_TEST(weight(1) == 2000u);
+        BOOST_TEST(weight(2) == 1u);
+
+        // The predicate itself is declared for the linker to find.
+        BOOST_TEST((gen.module->getFunction("valid") != nullptr));
+    }
+
     BOOST_AUTO_TEST_SUITE_END ()
 }
\ No newline at end of file
@@ -15,6 +15,7 @@
 #include <llvm/IR/Value.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
 
 #include "test_setup.hpp"
 
@@ -102,5 +103,34 @@ namespace {
         // BOOST_TEST((ai.value() != nullptr));
     }
 
+    BOOST_AUTO_TEST_CASE (codegen_constant_global)
+    {
+        // const bar = 6 * 7;
+        auto lhs = std::make_unique<ast::Identifier>("bar");
+        auto rhs = ast::make_expression<ast::BinaryOp>(ast::BinaryOperators::Multiply,
+            ast::make_expression<ast::Integer>(6), ast::make_expression<ast::Integer>(7));
+
+        auto node = std::make_unique<ast::Constant>(std::move(lhs), std::move(rhs));
+
+        gen.generate(node.get());
+
+        // The value is folded into the global's initializer...
+        auto gvar = gen.module->getGlobalVariable("bar", true);
+        BOOST_TEST_REQUIRE((gvar != nullptr));
+        BOOST_TEST(gvar->isConstant());
+
+        auto init = llvm::dyn_cast<llvm::ConstantInt>(gvar->getInitializer());
+        BOOST_TEST_REQUIRE((init != nullptr));
+        BOOST_TEST(init->getSExtValue() == 42);
+
+        // ...so there's nothing left to do at startup.
+        auto init_fn = gen.module->getFunction(gen.module->getModuleIdentifier() + "_init");
+        BOOST_TEST_REQUIRE((init_fn != nullptr));
+        for (auto& inst : init_fn->getEntryBlock())
+        {
+            BOOST_TEST(!llvm::isa<llvm::StoreInst>(inst));
+        }
+    }
+
     BOOST_AUTO_TEST_SUITE_END ()
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <iostream>
 
 #include "../../include/codegen/function_visitor.hpp"
+#include "../../include/codegen/generator.hpp"
 #include "../../include/ast.hpp"
 #include "../../include/grammar.hpp"
 #include "../../include/types/types.hpp"
@@ -104,5 +105,27 @@ namespace {
         BOOST_TEST((fv.potential_return_types.empty()));
     }
 
+    BOOST_AUTO_TEST_CASE (generator_function_visitor)
+    {
+        BOOST_TEST_MESSAGE("Testing return types from the code generator");
+
+        auto ret = std::make_unique<ast::Return>(ast::make_expression<ast::Long>(42));
+
+        // With a generator, its types win over the node's own.
+        cg::CodeGenerator gen;
+        gen.set_type_of(ret->value.get(), types::SimpleType(types::BasicType::Integer));
+
+        cg::FunctionVisitor fv;
+        fv.generator = &gen;
+        ret->visit(&fv);
+
+        BOOST_TEST_REQUIRE((fv.potential_return_types.size() == 1));
+        auto fv_type = fv.potential_return_types.back().type();
+        auto as_simple = util::get_if<types::SimpleType>(&fv_type);
+
+        BOOST_TEST_REQUIRE((as_simple != nullptr));
+        BOOST_TEST((as_simple->type == types::BasicType::Integer));
+    }
+
     BOOST_AUTO_TEST_SUITE_END ()
 }
\ No newline at end of file
@@ -76,7 +76,7 @@ namespace {
 
         BOOST_TEST_MESSAGE("Codegen for boolean literal " << node->to_string());
 
-        auto result = util::any_cast<llvm::Value*>(gen.generate(node.get()));
+        auto result = gen.generate(node.get());
 
         BOOST_TEST((result != nullptr));
         result->print(llvm::outs(), true);
@@ -88,17 +88,37 @@ namespace {
 
         BOOST_TEST_MESSAGE("Codegen for nothing literal " << node->to_string());
 
-        auto result = util::any_cast<llvm::Value*>(gen.generate(node.get()));
+        auto result = gen.generate(node.get());
 
         BOOST_TEST((result != nullptr));
         result->print(llvm::outs(), true);
     }
 
+    BOOST_AUTO_TEST_CASE (cg_symbol_literal)
+    {
+        auto node = std::make_unique<ast::Symbol>("cg_symbol_test");
+
+        // Symbols are dense IDs by default...
+        auto result = llvm::dyn_cast_or_null<llvm::ConstantInt>(gen.generate(node.get()));
+        auto id = rhea::util::SymbolTable::global().intern("cg_symbol_test");
+
+        BOOST_TEST_REQUIRE((result != nullptr));
+        BOOST_TEST(result->getZExtValue() == id);
+
+        // ...and their hashes when they cross module boundaries.
+        cg::CodeGenerator hashed;
+        hashed.hashed_symbols = true;
+        auto hashed_result = llvm::dyn_cast_or_null<llvm::ConstantInt>(hashed.generate(node.get()));
+
+        BOOST_TEST_REQUIRE((hashed_result != nullptr));
+        BOOST_TEST(hashed_result->getZExtValue() == rhea::util::symbol_hash("cg_symbol_test"));
+    }
+
     BOOST_DATA_TEST_CASE (cg_integer_literal, data::make(samples_to_vector(integral_samples)))
     {
         BOOST_TEST_MESSAGE("Codegen for integer literal " << sample->to_string());
 
-        auto result = util::any_cast<llvm::Value*>(gen.generate(sample));
+        auto result = gen.generate(sample);
 
         BOOST_TEST((result != nullptr));
         result->print(llvm::outs(), true);
@@ -108,7 +128,7 @@ namespace {
     {
         BOOST_TEST_MESSAGE("Codegen for floating-point literal " << sample->to_string());
 
-        auto result = util::any_cast<llvm::Value*>(gen.generate(sample));
+        auto result = gen.generate(sample);
 
         BOOST_TEST((result != nullptr));
         result->print(llvm::outs(), true);
@@ -118,7 +138,7 @@ namespace {
     {
         BOOST_TEST_MESSAGE("Codegen for symbol " << sample->to_string());
 
-        auto result = util::any_cast<llvm::Value*>(gen.generate(sample));
+        auto result = gen.generate(sample);
 
         BOOST_TEST((result != nullptr));
         result->print(llvm::outs(), true);
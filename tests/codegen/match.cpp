@@ -0,0 +1,126 @@
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+
+#include "../../include/codegen/generator.hpp"
+#include "../../include/codegen/code_visitor.hpp"
+#include "../../include/ast.hpp"
+
+#include <llvm/IR/Value.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Instructions.h>
+
+#include "test_setup.hpp"
+
+namespace ast = rhea::ast;
+namespace cg = rhea::codegen;
+
+namespace {
+    struct CodegenFixture
+    {
+        cg::CodeGenerator gen;
+    };
+
+    ast::statement_ptr make_body(int value)
+    {
+        return std::make_unique<ast::BareExpression>(std::make_unique<ast::Integer>(value));
+    }
+
+    BOOST_FIXTURE_TEST_SUITE (codegen_match, CodegenFixture)
+
+    BOOST_AUTO_TEST_CASE (match_on_switch)
+    {
+        // match 2 { on 1, 2: ...; on 3: ...; default: ...; }
+        ast::child_vector<ast::Expression> values;
+        values.push_back(std::make_unique<ast::Integer>(1));
+        values.push_back(std::make_unique<ast::Integer>(2));
+
+        ast::child_vector<ast::Case> cases;
+        cases.push_back(std::make_unique<ast::On>(values, make_body(10)));
+        cases.push_back(std::make_unique<ast::On>(std::make_unique<ast::Integer>(3), make_body(20)));
+        cases.push_back(std::make_unique<ast::Default>(make_body(30)));
+
+        auto node = std::make_unique<ast::Match>(std::make_unique<ast::Integer>(2), cases);
+
+        auto result = gen.generate(node.get());
+
+        auto sw = llvm::dyn_cast_or_null<llvm::SwitchInst>(result);
+        BOOST_TEST_REQUIRE((sw != nullptr));
+        BOOST_TEST(sw->getNumCases() == 3u);
+        BOOST_TEST(sw->getDefaultDest()->getName().startswith("match.default"));
+
+        // Both values of the first case go to the same block.
+        auto type = llvm::cast<llvm::IntegerType>(sw->getCondition()->getType());
+        auto one = sw->findCaseValue(llvm::ConstantInt::get(type, 1));
+        auto two = sw->findCaseValue(llvm::ConstantInt::get(type, 2));
+        auto three = sw->findCaseValue(llvm::ConstantInt::get(type, 3));
+        BOOST_TEST((one->getCaseSuccessor() == two->getCaseSuccessor()));
+        BOOST_TEST((one->getCaseSuccessor() != three->getCaseSuccessor()));
+    }
+
+    BOOST_AUTO_TEST_CASE (match_on_symbols)
+    {
+        ast::child_vector<ast::Case> cases;
+        cases.push_back(std::make_unique<ast::On>(std::make_unique<ast::Symbol>("foo"), make_body(1)));
+        cases.push_back(std::make_unique<ast::On>(std::make_unique<ast::Symbol>("bar"), make_body(2)));
+
+        auto node = std::make_unique<ast::Match>(std::make_unique<ast::Symbol>("bar"), cases);
+
+        auto sw = llvm::dyn_cast_or_null<llvm::SwitchInst>(gen.generate(node.get()));
+        BOOST_TEST_REQUIRE((sw != nullptr));
+        BOOST_TEST(sw->getNumCases() == 2u);
+        BOOST_TEST(sw->getDefaultDest()->getName().startswith("match.end"));
+    }
+
+    BOOST_AUTO_TEST_CASE (match_on_errors)
+    {
+        // Duplicate values
+        ast::child_vector<ast::Case> dupes;
+        dupes.push_back(std::make_unique<ast::On>(std::make_unique<ast::Integer>(1), make_body(1)));
+        dupes.push_back(std::make_unique<ast::On>(std::make_unique<ast::Integer>(1), make_body(2)));
+        auto dupe_node = std::make_unique<ast::Match>(std::make_unique<ast::Integer>(1), dupes);
+
+        BOOST_CHECK_THROW(gen.generate(dupe_node.get()), rhea::ast::syntax_error);
+
+        // Symbol cases on an integer subject
+        cg::CodeGenerator other;
+        ast::child_vector<ast::Case> mixed;
+        mixed.push_back(std::make_unique<ast::On>(std::make_unique<ast::Symbol>("foo"), make_body(1)));
+        auto mixed_node = std::make_unique<ast::Match>(std::make_unique<ast::Integer>(1), mixed);
+
+        BOOST_CHECK_THROW(other.generate(mixed_node.get()), rhea::ast::syntax_error);
+    }
+
+    BOOST_AUTO_TEST_CASE (match_on_signedness)
+    {
+        // 255_ub is the same width as a byte, but doesn't fit in one.
+        ast::child_vector<ast::Case> unsigned_cases;
+        unsigned_cases.push_back(std::make_unique<ast::On>(std::make_unique<ast::UnsignedByte>(255), make_body(1)));
+        auto unsigned_node = std::make_unique<ast::Match>(std::make_unique<ast::Byte>(1), unsigned_cases);
+
+        BOOST_CHECK_THROW(gen.generate(unsigned_node.get()), rhea::ast::syntax_error);
+
+        // Nor does -1_b fit in an unsigned byte.
+        cg::CodeGenerator other;
+        ast::child_vector<ast::Case> signed_cases;
+        signed_cases.push_back(std::make_unique<ast::On>(std::make_unique<ast::Byte>(-1), make_body(1)));
+        auto signed_node = std::make_unique<ast::Match>(std::make_unique<ast::UnsignedByte>(1), signed_cases);
+
+        BOOST_CHECK_THROW(other.generate(signed_node.get()), rhea::ast::syntax_error);
+
+        // But values that fit are fine, whatever their type.
+        cg::CodeGenerator fine;
+        ast::child_vector<ast::Case> fine_cases;
+        fine_cases.push_back(std::make_unique<ast::On>(std::make_unique<ast::UnsignedByte>(127), make_body(1)));
+        fine_cases.push_back(std::make_unique<ast::On>(std::make_unique<ast::Integer>(-128), make_body(2)));
+        auto fine_node = std::make_unique<ast::Match>(std::make_unique<ast::Byte>(1), fine_cases);
+
+        auto sw = llvm::dyn_cast_or_null<llvm::SwitchInst>(fine.generate(fine_node.get()));
+        BOOST_TEST_REQUIRE((sw != nullptr));
+        BOOST_TEST(sw->getNumCases() == 2u);
+        auto type = llvm::cast<llvm::IntegerType>(sw->getCondition()->getType());
+        BOOST_TEST((sw->findCaseValue(llvm::ConstantInt::get(type, -128, true)) != sw->case_default()));
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
@@ -0,0 +1,126 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <memory>
+
+#include "../../include/codegen/generator.hpp"
+#include "../../include/ast.hpp"
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+
+#include "test_setup.hpp"
+
+namespace cg = rhea::codegen;
+
+namespace {
+    struct CodegenFixture
+    {
+        cg::CodeGenerator gen;
+
+        // Build `square(x) = x * x`, with the argument spilled to the stack
+        // the way our codegen does for variables.
+        llvm::Function* make_square()
+        {
+            auto int_type = llvm::Type::getInt32Ty(gen.context);
+            auto ft = llvm::FunctionType::get(int_type, { int_type }, false);
+
+            auto fn = llvm::Function::Create(
+                ft,
+                llvm::Function::ExternalLinkage,
+                "square",
+                gen.module.get()
+            );
+
+            auto block = llvm::BasicBlock::Create(gen.context, "entry", fn);
+            gen.builder.SetInsertPoint(block);
+
+            auto slot = gen.builder.CreateAlloca(int_type, nullptr, "x");
+            gen.builder.CreateStore(&*(fn->arg_begin()), slot);
+            auto x = gen.builder.CreateLoad(slot, "x");
+            gen.builder.CreateRet(gen.builder.CreateMul(x, x, "multmp"));
+
+            return fn;
+        }
+
+        static std::size_t count_allocas(llvm::Function* fn)
+        {
+            std::size_t count = 0;
+            for (auto& block : *fn)
+            {
+                for (auto& inst : block)
+                {
+                    if (llvm::isa<llvm::AllocaInst>(inst)) ++count;
+                }
+            }
+
+            return count;
+        }
+    };
+
+    BOOST_FIXTURE_TEST_SUITE (codegen_optimization, CodegenFixture)
+
+    BOOST_AUTO_TEST_CASE (optimize_o0)
+    {
+        auto fn = make_square();
+
+        gen.optimization.level = cg::OptimizationLevel::O0;
+        gen.optimize(gen.module.get());
+
+        BOOST_TEST(count_allocas(fn) == 1);
+    }
+
+    BOOST_AUTO_TEST_CASE (optimize_module_o3)
+    {
+        auto fn = make_square();
+
+        gen.optimization.level = cg::OptimizationLevel::O3;
+        gen.optimize(gen.module.get());
+
+        BOOST_TEST(count_allocas(fn) == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE (optimize_function_os)
+    {
+        auto fn = make_square();
+
+        gen.optimization.level = cg::OptimizationLevel::Os;
+        BOOST_TEST((gen.optimize(fn) == fn));
+
+        BOOST_TEST(count_allocas(fn) == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE (optimize_extra_passes)
+    {
+        auto fn = make_square();
+
+        gen.optimization.level = cg::OptimizationLevel::O0;
+        gen.optimization.extra_passes.push_back("mem2reg");
+        gen.optimize(fn);
+
+        BOOST_TEST(count_allocas(fn) == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE (optimize_disabled_passes)
+    {
+        auto fn = make_square();
+
+        gen.optimization.level = cg::OptimizationLevel::O0;
+        gen.optimization.extra_passes.push_back("mem2reg");
+        gen.optimization.disabled_passes.insert("PromotePass");
+        gen.optimize(fn);
+
+        BOOST_TEST(count_allocas(fn) == 1);
+    }
+
+    BOOST_AUTO_TEST_CASE (optimize_bad_pipeline)
+    {
+        make_square();
+
+        gen.optimization.extra_passes.push_back("not-a-real-pass");
+        BOOST_CHECK_THROW(gen.optimize(gen.module.get()), std::invalid_argument);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
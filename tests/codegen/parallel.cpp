@@ -0,0 +1,98 @@
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../include/codegen/parallel.hpp"
+#include "../../include/ast.hpp"
+
+namespace ast = rhea::ast;
+namespace cg = rhea::codegen;
+
+namespace {
+    // A few units, each defining its own global.
+    struct Units
+    {
+        Units(std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                auto name = "v" + std::to_string(i);
+
+                auto lhs = std::make_unique<ast::Identifier>(name);
+                auto rhs = ast::make_expression<ast::BinaryOp>(
+                    ast::BinaryOperators::Multiply,
+                    ast::make_expression<ast::Integer>(static_cast<int>(i)),
+                    ast::make_expression<ast::Integer>(3)
+                );
+
+                trees.push_back(std::make_unique<ast::Variable>(std::move(lhs), std::move(rhs)));
+
+                cg::CompilationUnit unit;
+                unit.name = "unit_" + std::to_string(i);
+                unit.tree = trees.back().get();
+                units.push_back(std::move(unit));
+            }
+        }
+
+        std::vector<std::unique_ptr<ast::ASTNode>> trees;
+        std::vector<cg::CompilationUnit> units;
+    };
+
+    BOOST_AUTO_TEST_SUITE (codegen_parallel)
+
+    BOOST_AUTO_TEST_CASE (parallel_output_is_deterministic)
+    {
+        Units program { 12 };
+
+        cg::ParallelOptions serial;
+        serial.threads = 1;
+
+        cg::ParallelOptions parallel;
+        parallel.threads = 4;
+
+        auto expected = cg::compile_parallel(program.units, serial);
+        auto result = cg::compile_parallel(program.units, parallel);
+
+        BOOST_TEST_REQUIRE(expected.size() == program.units.size());
+        BOOST_TEST_REQUIRE(result.size() == expected.size());
+
+        for (std::size_t i = 0; i < result.size(); ++i)
+        {
+            BOOST_TEST(result[i].name == program.units[i].name);
+            BOOST_TEST(!result[i].object.empty());
+            BOOST_TEST((result[i].object == expected[i].object));
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE (parallel_optimization)
+    {
+        Units program { 3 };
+
+        cg::ParallelOptions options;
+        options.threads = 2;
+        options.optimization.level = cg::OptimizationLevel::O2;
+
+        auto result = cg::compile_parallel(program.units, options);
+
+        BOOST_TEST_REQUIRE(result.size() == 3u);
+        BOOST_TEST(result[2].name == "unit_2");
+        BOOST_TEST(!result[2].object.empty());
+    }
+
+    BOOST_AUTO_TEST_CASE (parallel_errors)
+    {
+        Units program { 4 };
+
+        // Bad pipelines throw, and the error comes back to the caller.
+        cg::ParallelOptions options;
+        options.threads = 2;
+        options.optimization.extra_passes.push_back("no-such-pass");
+
+        BOOST_CHECK_THROW(cg::compile_parallel(program.units, options), std::invalid_argument);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
@@ -0,0 +1,130 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <memory>
+
+#include "../../include/codegen/generator.hpp"
+#include "../../include/codegen/target.hpp"
+#include "../../include/ast.hpp"
+
+#include <llvm/ADT/Triple.h>
+
+#include "test_setup.hpp"
+
+namespace ast = rhea::ast;
+namespace cg = rhea::codegen;
+
+namespace {
+    BOOST_AUTO_TEST_SUITE (codegen_target)
+
+    BOOST_AUTO_TEST_CASE (target_machines_are_cached)
+    {
+        // A cache of our own, so other tests can't have filled it already.
+        cg::TargetMachineCache cache;
+        BOOST_TEST(cache.size() == 0u);
+
+        cg::TargetSpec spec;
+        spec.triple = cg::host_triple();
+
+        auto tm = cache.get(spec);
+
+        BOOST_TEST((tm != nullptr));
+        BOOST_TEST(cache.size() == 1u);
+        BOOST_TEST((cache.get(spec) == tm));
+        BOOST_TEST(cache.size() == 1u);
+
+        // Any change to the spec needs a new machine.
+        auto other = spec;
+        other.opt_level = llvm::CodeGenOpt::Aggressive;
+        BOOST_TEST((cache.get(other) != tm));
+        BOOST_TEST(cache.size() == 2u);
+    }
+
+    BOOST_AUTO_TEST_CASE (unknown_target)
+    {
+        cg::TargetSpec spec;
+        spec.triple = "nonsense-unknown-nowhere";
+
+        BOOST_CHECK_THROW(cg::TargetMachineCache::global().get(spec), std::invalid_argument);
+    }
+
+    BOOST_AUTO_TEST_CASE (foreign_target)
+    {
+        // Some architecture that isn't the host's.
+        llvm::Triple host { cg::host_triple() };
+
+        cg::TargetSpec spec;
+        spec.triple = (host.getArch() == llvm::Triple::aarch64)
+            ? "x86_64-unknown-linux-gnu"
+            : "aarch64-unknown-linux-gnu";
+
+        BOOST_CHECK_THROW(cg::TargetMachineCache::global().get(spec), std::invalid_argument);
+    }
+
+    BOOST_AUTO_TEST_CASE (generators_share_machines)
+    {
+        cg::TargetMachineCache cache;
+
+        cg::CodeGenerator first { "first" };
+        cg::CodeGenerator second { "second" };
+        first.target_machines = &cache;
+        second.target_machines = &cache;
+
+        auto node = std::make_unique<ast::Integer>(42);
+
+        first.generate(node.get());
+        BOOST_TEST(cache.size() == 1u);
+
+        second.generate(node.get());
+        first.generate(node.get());
+
+        BOOST_TEST((first.target_machine == second.target_machine));
+        BOOST_TEST(cache.size() == 1u);
+    }
+
+    BOOST_AUTO_TEST_CASE (native_target_selection)
+    {
+        cg::TargetSelection selection;
+        selection.cpu = "native";
+        selection.features = "-avx512f";
+
+        auto spec = cg::resolve_target(selection);
+
+        BOOST_TEST(spec.triple == cg::host_triple());
+        BOOST_TEST(spec.cpu != "native");
+        BOOST_TEST(!spec.cpu.empty());
+
+        // Explicit features come last, so they win.
+        auto pos = spec.features.rfind("-avx512f");
+        BOOST_TEST(pos != std::string::npos);
+        BOOST_TEST(pos + 8 == spec.features.size());
+
+        // Detection is deterministic, so the cache key is stable.
+        BOOST_TEST(cg::resolve_target(selection).features == spec.features);
+    }
+
+    BOOST_AUTO_TEST_CASE (default_target_selection)
+    {
+        auto spec = cg::resolve_target(cg::TargetSelection {});
+
+        BOOST_TEST(spec.cpu == "generic");
+        BOOST_TEST(spec.features.empty());
+    }
+
+    BOOST_AUTO_TEST_CASE (target_function_attributes)
+    {
+        cg::CodeGenerator gen { "attrs" };
+        gen.target.cpu = "native";
+
+        auto node = std::make_unique<ast::Integer>(42);
+        gen.generate(node.get());
+
+        auto fn = gen.module->getFunction("attrs_init");
+        BOOST_TEST((fn != nullptr));
+        BOOST_TEST(fn->getFnAttribute("target-cpu").getValueAsString().str() ==
+            gen.target_machine->getTargetCPU().str());
+        BOOST_TEST(fn->hasFnAttribute("target-features"));
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
@@ -0,0 +1,80 @@
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+
+#include "../../include/codegen/generator.hpp"
+#include "../../include/codegen/code_visitor.hpp"
+#include "../../include/codegen/cost.hpp"
+#include "../../include/ast.hpp"
+
+#include <llvm/IR/Value.h>
+#include <llvm/IR/Instructions.h>
+
+#include "test_setup.hpp"
+
+namespace ast = rhea::ast;
+namespace cg = rhea::codegen;
+
+namespace {
+    struct CodegenFixture
+    {
+        cg::CodeGenerator gen;
+    };
+
+    std::unique_ptr<ast::TernaryOp> make_ternary(ast::expression_ptr t, ast::expression_ptr f)
+    {
+        return std::make_unique<ast::TernaryOp>(
+            std::make_unique<ast::Boolean>(true), std::move(t), std::move(f));
+    }
+
+    ast::expression_ptr make_division()
+    {
+        return std::make_unique<ast::BinaryOp>(ast::BinaryOperators::Divide,
+            std::make_unique<ast::Integer>(10), std::make_unique<ast::Integer>(2));
+    }
+
+    BOOST_FIXTURE_TEST_SUITE (codegen_ternary, CodegenFixture)
+
+    BOOST_AUTO_TEST_CASE (ternary_cost)
+    {
+        auto sum = std::make_unique<ast::BinaryOp>(ast::BinaryOperators::Add,
+            std::make_unique<ast::Integer>(1), std::make_unique<ast::Integer>(2));
+        BOOST_TEST(cg::evaluation_cost(sum.get()) == 1u);
+
+        // Anything that might trap can't be speculated at all.
+        auto div = make_division();
+        BOOST_TEST(cg::evaluation_cost(div.get()) == cg::unbounded_cost);
+
+        auto cheap = make_ternary(std::move(sum), std::make_unique<ast::Integer>(3));
+        BOOST_TEST(cg::should_use_select(cheap.get()));
+
+        auto expensive = make_ternary(std::move(div), std::make_unique<ast::Integer>(3));
+        BOOST_TEST(!cg::should_use_select(expensive.get()));
+    }
+
+    BOOST_AUTO_TEST_CASE (ternary_select)
+    {
+        auto node = make_ternary(std::make_unique<ast::Integer>(1), std::make_unique<ast::Integer>(2));
+
+        auto result = gen.generate(node.get());
+
+        BOOST_TEST_REQUIRE((result != nullptr));
+        BOOST_TEST(!llvm::isa<llvm::PHINode>(result));
+    }
+
+    BOOST_AUTO_TEST_CASE (ternary_branch)
+    {
+        auto node = make_ternary(make_division(), std::make_unique<ast::Integer>(2));
+
+        auto result = gen.generate(node.get());
+
+        // Only the chosen arm runs, so the result comes from a PHI.
+        auto phi = llvm::dyn_cast_or_null<llvm::PHINode>(result);
+        BOOST_TEST_REQUIRE((phi != nullptr));
+        BOOST_TEST(phi->getType()->isIntegerTy(32));
+        BOOST_TEST(phi->getNumIncomingValues() == 2u);
+        BOOST_TEST(phi->getParent()->getName().startswith("tern.end"));
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
@@ -0,0 +1,209 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "../../include/ast.hpp"
+#include "../../include/fold/constant_fold.hpp"
+
+namespace ast = rhea::ast;
+namespace fold = rhea::fold;
+
+using rhea::types::BasicType;
+
+namespace {
+    // Wrap an expression in a statement, so the folder can replace it.
+    std::unique_ptr<ast::BareExpression> statement(ast::expression_ptr e)
+    {
+        return std::make_unique<ast::BareExpression>(std::move(e));
+    }
+
+    ast::expression_ptr binop(ast::BinaryOperators op, ast::expression_ptr l, ast::expression_ptr r)
+    {
+        return ast::make_expression<ast::BinaryOp>(op, std::move(l), std::move(r));
+    }
+
+    template <typename T, typename V>
+    ast::expression_ptr lit(V v)
+    {
+        return ast::make_expression<T>(v);
+    }
+
+    // Test cases
+    BOOST_AUTO_TEST_SUITE (Constant_folding)
+
+    BOOST_AUTO_TEST_CASE (fold_integer_arithmetic)
+    {
+        fold::ConstantFolder folder;
+
+        // 1 << 20
+        auto shift = statement(binop(ast::BinaryOperators::LeftShift, lit<ast::Integer>(1), lit<ast::Integer>(20)));
+        folder.fold(shift.get());
+
+        auto result = dynamic_cast<ast::Integer*>(shift->expression.get());
+        BOOST_TEST_REQUIRE((result != nullptr));
+        BOOST_TEST(result->value == 1 << 20);
+
+        // Bytes wrap at 8 bits: 100_b + 100_b == -56_b
+        auto wrap = statement(binop(ast::BinaryOperators::Add, lit<ast::Byte>(100), lit<ast::Byte>(100)));
+        folder.fold(wrap.get());
+
+        auto wrapped = dynamic_cast<ast::Byte*>(wrap->expression.get());
+        BOOST_TEST_REQUIRE((wrapped != nullptr));
+        BOOST_TEST(wrapped->value == -56);
+
+        // Unsigned comparisons are unsigned.
+        auto cmp = statement(binop(ast::BinaryOperators::LessThan,
+            lit<ast::UnsignedInteger>(1u), lit<ast::UnsignedInteger>(0xffffffffu)));
+        folder.fold(cmp.get());
+
+        auto less = dynamic_cast<ast::Boolean*>(cmp->expression.get());
+        BOOST_TEST_REQUIRE((less != nullptr));
+        BOOST_TEST(less->value);
+
+        // The RHS widens to the LHS type, as in codegen.
+        auto mixed = statement(binop(ast::BinaryOperators::Multiply, lit<ast::Long>(3), lit<ast::Integer>(7)));
+        folder.fold(mixed.get());
+
+        auto product = dynamic_cast<ast::Long*>(mixed->expression.get());
+        BOOST_TEST_REQUIRE((product != nullptr));
+        BOOST_TEST(product->value == 21);
+
+        BOOST_TEST(folder.folded_count() == 4u);
+    }
+
+    BOOST_AUTO_TEST_CASE (no_fold_undefined)
+    {
+        fold::ConstantFolder folder;
+
+        // Division by zero and oversized shifts are left for runtime.
+        auto div = statement(binop(ast::BinaryOperators::Divide, lit<ast::Integer>(1), lit<ast::Integer>(0)));
+        auto shift = statement(binop(ast::BinaryOperators::LeftShift, lit<ast::Integer>(1), lit<ast::Integer>(32)));
+        auto overflow = statement(binop(ast::BinaryOperators::Divide,
+            lit<ast::Integer>(std::numeric_limits<std::int32_t>::min()), lit<ast::Integer>(-1)));
+
+        folder.fold(div.get());
+        folder.fold(shift.get());
+        folder.fold(overflow.get());
+
+        BOOST_TEST((dynamic_cast<ast::BinaryOp*>(div->expression.get()) != nullptr));
+        BOOST_TEST((dynamic_cast<ast::BinaryOp*>(shift->expression.get()) != nullptr));
+        BOOST_TEST((dynamic_cast<ast::BinaryOp*>(overflow->expression.get()) != nullptr));
+        BOOST_TEST(folder.folded_count() == 0u);
+
+        // But not an implicit narrowing, which is a type error.
+        auto narrow = statement(binop(ast::BinaryOperators::Add, lit<ast::Integer>(1), lit<ast::Long>(2)));
+        folder.fold(narrow.get());
+        BOOST_TEST((dynamic_cast<ast::BinaryOp*>(narrow->expression.get()) != nullptr));
+    }
+
+    BOOST_AUTO_TEST_CASE (fold_floating_point)
+    {
+        fold::ConstantFolder folder;
+
+        // Floats are computed at float precision.
+        auto sum = statement(binop(ast::BinaryOperators::Add, lit<ast::Float>(0.1f), lit<ast::Float>(0.2f)));
+        folder.fold(sum.get());
+
+        auto result = dynamic_cast<ast::Float*>(sum->expression.get());
+        BOOST_TEST_REQUIRE((result != nullptr));
+        BOOST_TEST(result->value == 0.1f + 0.2f);
+
+        // Unary minus on an unsigned value gives a signed one.
+        auto neg = statement(ast::make_expression<ast::UnaryOp>(ast::UnaryOperators::Minus, lit<ast::UnsignedByte>(1)));
+        folder.fold(neg.get());
+
+        auto negated = dynamic_cast<ast::Byte*>(neg->expression.get());
+        BOOST_TEST_REQUIRE((negated != nullptr));
+        BOOST_TEST(negated->value == -1);
+    }
+
+    BOOST_AUTO_TEST_CASE (fold_ternary_and_logic)
+    {
+        fold::ConstantFolder folder;
+
+        // false ? 1 : 2_b gives the false branch, converted to integer.
+        auto tern = statement(ast::make_expression<ast::TernaryOp>(
+            lit<ast::Boolean>(false), lit<ast::Integer>(1), lit<ast::Byte>(2)));
+        folder.fold(tern.get());
+
+        auto chosen = dynamic_cast<ast::Integer*>(tern->expression.get());
+        BOOST_TEST_REQUIRE((chosen != nullptr));
+        BOOST_TEST(chosen->value == 2);
+
+        // `false and x` is false, whatever x is.
+        auto logic = statement(binop(ast::BinaryOperators::BooleanAnd,
+            lit<ast::Boolean>(false), ast::make_expression<ast::Identifier>("unknown")));
+        folder.fold(logic.get());
+
+        auto is_false = dynamic_cast<ast::Boolean*>(logic->expression.get());
+        BOOST_TEST_REQUIRE((is_false != nullptr));
+        BOOST_TEST(!is_false->value);
+    }
+
+    BOOST_AUTO_TEST_CASE (propagate_constants)
+    {
+        fold::ConstantFolder folder;
+
+        // const size = 4 * 1024;
+        auto size = std::make_unique<ast::Constant>(std::make_unique<ast::Identifier>("size"),
+            binop(ast::BinaryOperators::Multiply, lit<ast::Integer>(4), lit<ast::Integer>(1024)));
+        folder.fold(size.get());
+
+        // size + 1
+        auto use = statement(binop(ast::BinaryOperators::Add,
+            ast::make_expression<ast::Identifier>("size"), lit<ast::Integer>(1)));
+        folder.fold(use.get());
+
+        auto result = dynamic_cast<ast::Integer*>(use->expression.get());
+        BOOST_TEST_REQUIRE((result != nullptr));
+        BOOST_TEST(result->value == 4097);
+
+        // A variable in an inner block hides the constant.
+        ast::child_vector<ast::Statement> inner;
+        inner.push_back(std::make_unique<ast::Variable>(std::make_unique<ast::Identifier>("size"), lit<ast::Integer>(1)));
+        inner.push_back(statement(ast::make_expression<ast::Identifier>("size")));
+        auto block = std::make_unique<ast::Block>(inner);
+        folder.fold(block.get());
+
+        auto hidden = dynamic_cast<ast::BareExpression*>(block->children.back().get());
+        BOOST_TEST((dynamic_cast<ast::Identifier*>(hidden->expression.get()) != nullptr));
+
+        // ...but only inside that block.
+        auto after = statement(ast::make_expression<ast::Identifier>("size"));
+        folder.fold(after.get());
+        BOOST_TEST((dynamic_cast<ast::Integer*>(after->expression.get()) != nullptr));
+    }
+
+    BOOST_AUTO_TEST_CASE (constant_conversions)
+    {
+        fold::ConstantValue big;
+        big.type = BasicType::Double;
+        big.floating = 1e300;
+
+        // Out of range for an integer, so it can't be folded.
+        BOOST_TEST(!fold::convert_constant(big, BasicType::Integer));
+
+        fold::ConstantValue negative;
+        negative.type = BasicType::Integer;
+        negative.integer = static_cast<std::uint64_t>(-2);
+
+        auto as_ubyte = fold::convert_constant(negative, BasicType::UnsignedByte);
+        BOOST_TEST_REQUIRE(bool(as_ubyte));
+        BOOST_TEST(as_ubyte->integer == 254u);
+
+        auto as_long = fold::convert_constant(negative, BasicType::Long);
+        BOOST_TEST_REQUIRE(bool(as_long));
+        BOOST_TEST(static_cast<std::int64_t>(as_long->integer) == -2);
+
+        auto as_bool = fold::convert_constant(negative, BasicType::Boolean);
+        BOOST_TEST_REQUIRE(bool(as_bool));
+        BOOST_TEST(as_bool->integer == 1u);
+
+        // Strings aren't numbers.
+        BOOST_TEST(!fold::convert_constant(negative, BasicType::String));
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
@@ -86,7 +86,8 @@ namespace {
     std::string on_case_samples[] = {
         "on 1: print('test');",
         "on 2: { do_something(); }",
-        "on @foo: { bar = 42_u; }"
+        "on @foo: { bar = 42_u; }",
+        "on 3, 4, 5: { baz(); }"
     };
 
     std::string when_case_samples[] = {
@@ -103,6 +104,7 @@ namespace {
         "match foo {\n"
         "   on 1: print('test');\n"
         "   on 2: { do_something_else(foo); }\n"
+        "   on 3, 4: print('three or four');\n"
         "   default: { result = error; }\n"
         "}"
     };
@@ -2,6 +2,7 @@
 #include <boost/test/data/test_case.hpp>
 #include <boost/test/data/monomorphic.hpp>
 
+#include <algorithm>
 #include <string>
 #include <memory>
 #include <vector>
@@ -322,6 +323,47 @@ namespace {
         BOOST_TEST((scope->find_symbol("foo") != nullptr));
     }
 
+    BOOST_AUTO_TEST_CASE (infer_identifier)
+    {
+        BOOST_TEST_MESSAGE("Testing inference of identifiers");
+
+        // var foo = 69; var bar = foo; baz
+        std::unique_ptr<ASTNode> foo = make_statement<Variable>(
+            std::make_unique<Identifier>("foo"),
+            make_expression<Long>(69)
+        );
+
+        auto r = std::make_unique<Identifier>("foo");
+        auto use = r.get();
+        std::unique_ptr<ASTNode> bar = make_statement<Variable>(
+            std::make_unique<Identifier>("bar"),
+            std::move(r)
+        );
+
+        auto undeclared = std::make_unique<Identifier>("baz");
+
+        foo->visit(&engine.visitor);
+        bar->visit(&engine.visitor);
+        undeclared->visit(&engine.visitor);
+
+        auto inferred = engine.get_inferred_type(use);
+        auto as_simple = util::get_if<SimpleType>(&inferred.type());
+        BOOST_TEST_REQUIRE((as_simple != nullptr));
+        BOOST_TEST((as_simple->type == BasicType::Long));
+
+        // The declaration's type carries through to the new variable.
+        auto bar_type = engine.get_inferred_type(bar.get());
+        BOOST_TEST((bar_type == inferred));
+
+        // Redefining the declaration throws away the use's type.
+        engine.set_inferred_type(foo.get(),
+            InferredType { [](TypeEngine*, ASTNode*) { return SimpleType(BasicType::Double, true, false); } });
+        BOOST_TEST(!engine.inferred_types[use].cached);
+
+        auto unknown = engine.get_inferred_type(undeclared.get());
+        BOOST_TEST((util::get_if<UnknownType>(&unknown.type()) != nullptr));
+    }
+
     BOOST_AUTO_TEST_CASE (infer_type_declaration)
     {
         BOOST_TEST_MESSAGE("Testing inference of type declaration");
@@ -393,5 +435,159 @@ namespace {
         BOOST_TEST((scope->find_symbol("foo <> -> nothing") != nullptr));
     }
 
+    BOOST_AUTO_TEST_CASE (inferred_types_are_cached)
+    {
+        BOOST_TEST_MESSAGE("Testing caching of inferred types");
+
+        auto l = make_expression<Integer>(42);
+        auto r = make_expression<Integer>(69);
+        auto left = l.get();
+        std::unique_ptr<ASTNode> node = make_expression<BinaryOp>(
+            BinaryOperators::Add,
+            std::move(l),
+            std::move(r)
+        );
+
+        node->visit(&engine.visitor);
+
+        // The first query computes the operation and both operands.
+        engine.get_inferred_type(node.get());
+        BOOST_TEST(engine.cache_stats.misses == 3);
+        BOOST_TEST(engine.cache_stats.hits == 0);
+
+        // After that, nothing is recomputed.
+        auto inferred = engine.get_inferred_type(node.get());
+        engine.get_inferred_type(left);
+        BOOST_TEST(engine.cache_stats.misses == 3);
+        BOOST_TEST(engine.cache_stats.hits == 2);
+
+        auto as_simple = util::get_if<SimpleType>(&inferred.type());
+        BOOST_TEST((as_simple != nullptr));
+        BOOST_TEST((as_simple->type == BasicType::Integer));
+    }
+
+    BOOST_AUTO_TEST_CASE (inferred_types_are_invalidated)
+    {
+        BOOST_TEST_MESSAGE("Testing invalidation of inferred types");
+
+        auto l = make_expression<Integer>(42);
+        auto r = make_expression<Integer>(69);
+        auto left = l.get();
+        auto right = r.get();
+        std::unique_ptr<ASTNode> node = make_expression<BinaryOp>(
+            BinaryOperators::Add,
+            std::move(l),
+            std::move(r)
+        );
+
+        node->visit(&engine.visitor);
+        engine.get_inferred_type(node.get());
+
+        // Changing one operand throws away the operation's type, but not
+        // the other operand's.
+        engine.set_inferred_type(left,
+            InferredType { [](TypeEngine*, ASTNode*) { return SimpleType(BasicType::Long, true, true); } });
+
+        BOOST_TEST(!engine.inferred_types[node.get()].cached);
+        BOOST_TEST(engine.inferred_types[right].cached);
+        BOOST_TEST(engine.cache_stats.invalidations == 2);
+
+        auto misses = engine.cache_stats.misses;
+        auto inferred = engine.get_inferred_type(node.get());
+        BOOST_TEST(engine.cache_stats.misses == misses + 2);
+
+        // The operands no longer match.
+        BOOST_TEST((util::get_if<UnknownType>(&inferred.type()) != nullptr));
+    }
+
+    BOOST_AUTO_TEST_CASE (named_types_are_invalidated)
+    {
+        BOOST_TEST_MESSAGE("Testing invalidation of types that use a name");
+
+        std::unique_ptr<ASTNode> use = std::make_unique<Typename>(std::make_unique<Identifier>("meters"));
+        use->visit(&engine.visitor);
+
+        // Not defined yet, and that answer is cached.
+        auto before = engine.get_inferred_type(use.get());
+        BOOST_TEST((util::get_if<UnknownType>(&before.type()) != nullptr));
+        BOOST_TEST(engine.inferred_types[use.get()].cached);
+
+        // An alias defined later has to be seen by the earlier use.
+        std::unique_ptr<ASTNode> alias = make_statement<Alias>(
+            std::make_unique<Identifier>("meters"),
+            std::make_unique<Typename>(std::make_unique<Identifier>("long"))
+        );
+        alias->visit(&engine.visitor);
+
+        BOOST_TEST(!engine.inferred_types[use.get()].cached);
+
+        auto after = engine.get_inferred_type(use.get());
+        auto as_simple = util::get_if<SimpleType>(&after.type());
+        BOOST_TEST_REQUIRE((as_simple != nullptr));
+        BOOST_TEST((as_simple->type == BasicType::Long));
+
+        // Removing the definition works the same way.
+        engine.remove_type_definition("meters");
+        BOOST_TEST(!engine.inferred_types[use.get()].cached);
+        BOOST_TEST((util::get_if<UnknownType>(&engine.get_inferred_type(use.get()).type()) != nullptr));
+    }
+
+    BOOST_AUTO_TEST_CASE (finalized_types)
+    {
+        BOOST_TEST_MESSAGE("Testing finalization of inferred types");
+
+        auto l = make_expression<Byte>(1);
+        auto r = make_expression<Byte>(2);
+        auto left = l.get();
+        std::unique_ptr<ASTNode> node = make_expression<BinaryOp>(
+            BinaryOperators::Add,
+            std::move(l),
+            std::move(r)
+        );
+
+        node->visit(&engine.visitor);
+        auto types = engine.finalize();
+
+        BOOST_TEST(types.size() == 3);
+        BOOST_TEST(*types.find(left) == intern_type(SimpleType(BasicType::Byte)));
+        BOOST_TEST(*types.find(node.get()) == *types.find(left));
+
+        // Interned simple types carry the flags that go with their basic type.
+        auto& final_type = type_for_id(*types.find(node.get()));
+        auto as_simple = util::get_if<SimpleType>(&final_type.type());
+        BOOST_TEST((as_simple != nullptr));
+        BOOST_TEST(as_simple->is_integral);
+    }
+
+    BOOST_AUTO_TEST_CASE (finalized_types_per_input)
+    {
+        BOOST_TEST_MESSAGE("Testing incremental finalization, as the REPL does it");
+
+        // Every input is kept, as in a REPL session, so the engine sees more
+        // and more nodes. Each input's map should still be the same size.
+        std::vector<std::unique_ptr<ASTNode>> inputs;
+        NodeId first = ASTNode::id_count();
+        std::size_t largest = 0;
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            inputs.push_back(make_expression<BinaryOp>(
+                BinaryOperators::Add,
+                make_expression<Integer>(i),
+                make_expression<Integer>(1)
+            ));
+
+            inputs.back()->visit(&engine.visitor);
+            auto types = engine.finalize(first);
+            first = ASTNode::id_count();
+
+            BOOST_TEST(types.size() == 3u);
+            largest = std::max(largest, types.capacity());
+        }
+
+        // At most two chunks, however long the session runs.
+        BOOST_TEST(largest <= 512u);
+    }
+
     BOOST_AUTO_TEST_SUITE_END()
 }
\ No newline at end of file
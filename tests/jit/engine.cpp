@@ -0,0 +1,95 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <boost/test/data/monomorphic.hpp>
+
+#include <string>
+#include <memory>
+
+#include "../../include/jit/engine.hpp"
+#include "../../include/codegen/generator.hpp"
+#include "../../include/ast.hpp"
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+
+namespace data = boost::unit_test::data;
+namespace ast = rhea::ast;
+namespace cg = rhea::codegen;
+namespace jit = rhea::jit;
+
+namespace {
+    struct JitFixture
+    {
+        JitFixture() : gen("jittest") {}
+
+        cg::CodeGenerator gen;
+
+        // Add `twice(x) = x + x` to the generator's module.
+        void make_twice()
+        {
+            auto int_type = llvm::Type::getInt32Ty(gen.context);
+            auto ft = llvm::FunctionType::get(int_type, { int_type }, false);
+
+            auto fn = llvm::Function::Create(
+                ft,
+                llvm::Function::ExternalLinkage,
+                "twice",
+                gen.module.get()
+            );
+
+            auto block = llvm::BasicBlock::Create(gen.context, "entry", fn);
+            gen.builder.SetInsertPoint(block);
+
+            auto x = &*(fn->arg_begin());
+            gen.builder.CreateRet(gen.builder.CreateAdd(x, x, "addtmp"));
+        }
+    };
+
+    // Datasets
+    bool lazy_modes[] = { true, false };
+
+    BOOST_FIXTURE_TEST_SUITE (jit_engine, JitFixture)
+
+    BOOST_DATA_TEST_CASE (jit_call_function, data::make(lazy_modes))
+    {
+        jit::Engine engine { jit::EngineOptions { sample, true } };
+
+        make_twice();
+        engine.add(gen);
+
+        auto twice = engine.function<int(int)>("twice");
+        BOOST_TEST(twice(21) == 42);
+    }
+
+    BOOST_AUTO_TEST_CASE (jit_run_module)
+    {
+        jit::Engine engine;
+
+        auto node = std::make_unique<ast::Integer>(42);
+        gen.generate(node.get());
+        engine.add(gen);
+
+        BOOST_TEST(engine.has_symbol("jittest_init"));
+        BOOST_TEST(!engine.has_symbol("main"));
+        BOOST_TEST(engine.run("jittest") == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE (jit_missing_symbol)
+    {
+        jit::Engine engine;
+
+        BOOST_TEST(!engine.has_symbol("no_such_function"));
+        BOOST_CHECK_THROW(engine.lookup("no_such_function"), std::runtime_error);
+    }
+
+    BOOST_AUTO_TEST_CASE (jit_host_symbols)
+    {
+        jit::Engine engine;
+        BOOST_TEST(engine.has_symbol("malloc"));
+
+        jit::Engine isolated { jit::EngineOptions { true, false } };
+        BOOST_TEST(!isolated.has_symbol("malloc"));
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
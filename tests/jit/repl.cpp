@@ -0,0 +1,70 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <string>
+#include <memory>
+
+#include "../../include/jit/repl.hpp"
+#include "../../include/ast.hpp"
+
+namespace ast = rhea::ast;
+namespace jit = rhea::jit;
+
+namespace {
+    std::unique_ptr<ast::ASTNode> define(std::string name, ast::expression_ptr value)
+    {
+        return std::make_unique<ast::Variable>(
+            std::make_unique<ast::Identifier>(name),
+            std::move(value)
+        );
+    }
+
+    std::int32_t read_global(jit::Session& session, const std::string& name)
+    {
+        return *reinterpret_cast<std::int32_t*>(
+            static_cast<std::uintptr_t>(session.engine().lookup(name))
+        );
+    }
+
+    BOOST_AUTO_TEST_SUITE (jit_repl)
+
+    BOOST_AUTO_TEST_CASE (repl_inputs_get_their_own_modules)
+    {
+        jit::Session session;
+
+        auto first = session.evaluate(define("x", ast::make_expression<ast::Integer>(42)));
+        auto second = session.evaluate(define("y", ast::make_expression<ast::Integer>(69)));
+
+        BOOST_TEST(first == "repl_1");
+        BOOST_TEST(second == "repl_2");
+        BOOST_TEST(session.size() == 2);
+
+        // Only the latest input is left in the generator.
+        BOOST_TEST(session.generator().module->getModuleIdentifier() == "repl_2");
+        BOOST_TEST((session.generator().module->getFunction("repl_1_init") == nullptr));
+
+        BOOST_TEST(read_global(session, "x") == 42);
+        BOOST_TEST(read_global(session, "y") == 69);
+    }
+
+    BOOST_AUTO_TEST_CASE (repl_uses_earlier_definitions)
+    {
+        jit::Session session { "uses" };
+
+        session.evaluate(define("x", ast::make_expression<ast::Integer>(42)));
+        session.evaluate(define("y", ast::make_expression<ast::BinaryOp>(
+            ast::BinaryOperators::Add,
+            std::make_unique<ast::Identifier>("x"),
+            ast::make_expression<ast::Integer>(1)
+        )));
+
+        BOOST_TEST(read_global(session, "y") == 43);
+
+        // The second module only declares `x`.
+        auto x = session.generator().module->getGlobalVariable("x");
+        BOOST_TEST((x != nullptr));
+        BOOST_TEST(x->isDeclaration());
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
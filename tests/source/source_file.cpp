@@ -0,0 +1,141 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <string>
+#include <fstream>
+#include <memory>
+
+#include <tao/pegtl.hpp>
+
+#include "../../include/source/source_file.hpp"
+#include "../../include/ast.hpp"
+
+namespace fs = boost::filesystem;
+namespace ast = rhea::ast;
+namespace source = rhea::source;
+
+namespace {
+    // Fixture that writes its contents to a temporary file, which is
+    // removed again at the end of the test.
+    struct temp_source
+    {
+        temp_source(const std::string& contents)
+            : path(fs::temp_directory_path() / fs::unique_path("rhea-%%%%-%%%%.rhea"))
+        {
+            std::ofstream out(path.string(), std::ios::binary);
+            out << contents;
+        }
+
+        ~temp_source() { fs::remove(path); }
+
+        fs::path path;
+    };
+
+    // Test cases
+    BOOST_AUTO_TEST_SUITE (Source_files)
+
+    BOOST_AUTO_TEST_CASE (map_whole_file)
+    {
+        std::string contents { "const x = 42;\nvar y = x * 2;\n" };
+        temp_source tmp { contents };
+
+        source::SourceFile file { tmp.path.string() };
+
+        BOOST_TEST(file.size() == contents.size());
+        BOOST_TEST((std::string(file.begin(), file.end()) == contents));
+    }
+
+    BOOST_AUTO_TEST_CASE (parse_program_file)
+    {
+        temp_source tmp { "const x = 42;\n\nvar y = x * 2;\n" };
+
+        source::SourceFile file { tmp.path.string() };
+        auto tree = file.parse();
+
+        BOOST_TEST_REQUIRE(tree != nullptr);
+
+        auto node = ast::build_ast(tree);
+
+        BOOST_TEST_MESSAGE("Testing AST Node " << node->to_string());
+
+        BOOST_TEST((node->to_string() ==
+            "(Program,(Constant,(Identifier,x),(Integral,42,0)),"
+            "(Variable,(Identifier,y),(BinaryOp,2,(Identifier,x),(Integral,2,0))))"));
+
+        // Parsing again returns the cached tree.
+        BOOST_TEST(file.parse() == tree);
+    }
+
+    BOOST_AUTO_TEST_CASE (parse_module_file)
+    {
+        temp_source tmp { "module foo;\n\nconst x = 42;\n" };
+
+        source::SourceFile file { tmp.path.string() };
+        auto node = ast::build_ast(file.parse());
+
+        BOOST_TEST_MESSAGE("Testing AST Node " << node->to_string());
+
+        BOOST_TEST((node->to_string() ==
+            "(Module,(ModuleDef,(ModuleName,foo)),"
+            "(Constant,(Identifier,x),(Integral,42,0)))"));
+    }
+
+    BOOST_AUTO_TEST_CASE (file_ast_uses_arena)
+    {
+        temp_source tmp { "const x = 42;\n\nvar y = x * 2;\n" };
+
+        source::SourceFile file { tmp.path.string() };
+        auto node = file.ast();
+
+        BOOST_TEST_REQUIRE(node != nullptr);
+        BOOST_TEST(file.ast() == node);
+
+        // Every node of the tree lives in the file's arena.
+        BOOST_TEST(file.arena().live_nodes() >= 8u);
+        BOOST_TEST(file.arena().block_count() >= 1u);
+
+        BOOST_TEST((node->to_string() ==
+            "(Program,(Constant,(Identifier,x),(Integral,42,0)),"
+            "(Variable,(Identifier,y),(BinaryOp,2,(Identifier,x),(Integral,2,0))))"));
+    }
+
+    BOOST_AUTO_TEST_CASE (file_ast_falls_back)
+    {
+        // Modules can't be built directly, so this goes through the parse
+        // tree, and should give the same result as doing that by hand.
+        temp_source tmp { "module foo;\n\nconst x = 42;\n" };
+
+        source::SourceFile file { tmp.path.string() };
+        auto node = file.ast();
+
+        BOOST_TEST_REQUIRE(node != nullptr);
+        BOOST_TEST((node->to_string() ==
+            "(Module,(ModuleDef,(ModuleName,foo)),"
+            "(Constant,(Identifier,x),(Integral,42,0)))"));
+
+        // Syntax errors are the same whichever builder sees them.
+        temp_source bad { "const x = 42;\n)\n" };
+        source::SourceFile bad_file { bad.path.string() };
+
+        BOOST_CHECK_THROW(bad_file.ast(), tao::pegtl::parse_error);
+    }
+
+    BOOST_AUTO_TEST_CASE (trailing_garbage_is_error)
+    {
+        temp_source tmp { "const x = 42;\n)\n" };
+
+        source::SourceFile file { tmp.path.string() };
+
+        BOOST_CHECK_THROW(file.parse(), tao::pegtl::parse_error);
+    }
+
+    BOOST_AUTO_TEST_CASE (missing_file_is_error)
+    {
+        BOOST_CHECK_THROW(
+            source::SourceFile { "this-file-does-not-exist.rhea" },
+            std::exception
+        );
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
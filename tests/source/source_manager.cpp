@@ -0,0 +1,177 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <sstream>
+#include <memory>
+
+#include <tao/pegtl.hpp>
+#include <tao/pegtl/contrib/parse_tree.hpp>
+
+#include "../../include/source/source_manager.hpp"
+#include "../../include/ast.hpp"
+#include "../../include/grammar.hpp"
+
+using tao::pegtl::string_input;
+namespace pt = tao::pegtl::parse_tree;
+namespace gr = rhea::grammar;
+namespace ast = rhea::ast;
+namespace source = rhea::source;
+
+namespace {
+    // Test cases
+    BOOST_AUTO_TEST_SUITE (Source_manager)
+
+    BOOST_AUTO_TEST_CASE (location_is_compact)
+    {
+        BOOST_TEST(sizeof(source::SourceLocation) == 4);
+        BOOST_TEST(!source::SourceLocation{}.valid());
+    }
+
+    BOOST_AUTO_TEST_CASE (lines_and_columns)
+    {
+        source::SourceManager sm;
+        std::string text { "var x = 1;\n\nvar y = x;\n" };
+
+        auto file = sm.add_buffer("lines.rhea", text.data(), text.size());
+        auto loc = sm.location(file, text.find('y'));
+
+        BOOST_TEST(loc.valid());
+        BOOST_TEST(sm.file(loc) == file);
+        BOOST_TEST(sm.name(loc) == "lines.rhea");
+        BOOST_TEST(sm.offset(loc) == text.find('y'));
+        BOOST_TEST(sm.line(loc) == 3);
+        BOOST_TEST(sm.column(loc) == 5);
+
+        auto start = sm.location(file, 0);
+        BOOST_TEST(sm.line(start) == 1);
+        BOOST_TEST(sm.column(start) == 1);
+    }
+
+    BOOST_AUTO_TEST_CASE (separate_files)
+    {
+        source::SourceManager sm;
+        std::string first { "abc" }, second { "d\nef" };
+
+        auto f1 = sm.add_buffer("first", first.data(), first.size());
+        auto f2 = sm.add_buffer("second", second.data(), second.size());
+
+        BOOST_TEST(f1 != f2);
+        BOOST_TEST(sm.size() == 2);
+
+        // The end of one file doesn't run into the start of the next.
+        auto end1 = sm.location(f1, first.size());
+        auto start2 = sm.location(f2, 0);
+        BOOST_TEST((end1 != start2));
+        BOOST_TEST(sm.name(end1) == "first");
+        BOOST_TEST(sm.name(start2) == "second");
+
+        // Lookups by address find the right file.
+        auto loc = sm.location(second.data(), 3);
+        BOOST_TEST(sm.file(loc) == f2);
+        BOOST_TEST(sm.line(loc) == 2);
+        BOOST_TEST(sm.column(loc) == 2);
+
+        // Unknown buffers give invalid locations.
+        std::string other { "xyz" };
+        BOOST_TEST(!sm.location(other.data(), 0).valid());
+    }
+
+    BOOST_AUTO_TEST_CASE (builder_locations)
+    {
+        std::string sample { "def main = {\n    var x = 1;\n    return x;\n}" };
+        string_input<> in(sample, "locations");
+        source::ScopedBuffer buffer { in };
+
+        auto tree = pt::parse<
+            gr::program_definition,
+            ast::parser_node,
+            ast::tree_selector
+        >(in);
+
+        auto program = ast::build_ast(tree.get());
+        auto& sm = source::SourceManager::global();
+
+        BOOST_TEST_REQUIRE(program->position.valid());
+        BOOST_TEST(sm.name(program->position) == "locations");
+        BOOST_TEST(sm.line(program->position) == 1);
+
+        std::ostringstream os;
+        os << program->position;
+        BOOST_TEST(os.str() == "locations:1:1");
+    }
+
+    BOOST_AUTO_TEST_CASE (remove_buffers)
+    {
+        source::SourceManager sm;
+        std::string first { "abc" }, second { "d\nef" }, third { "ghi" };
+
+        auto f1 = sm.add_buffer("first", first.data(), first.size());
+        auto f2 = sm.add_buffer("second", second.data(), second.size());
+        auto base2 = sm.location(f2, 0);
+
+        // The last buffer's locations are reused by the next one.
+        sm.remove_buffer(f2);
+        BOOST_TEST(sm.size() == 1);
+        BOOST_TEST(!sm.location(second.data(), 0).valid());
+
+        auto f3 = sm.add_buffer("third", third.data(), third.size());
+        BOOST_TEST((sm.location(f3, 0) == base2));
+        BOOST_TEST(sm.name(sm.location(f3, 1)) == "third");
+
+        // Earlier buffers can't give theirs back yet, but still go.
+        sm.remove_buffer(f1);
+        BOOST_TEST(sm.size() == 1);
+        BOOST_TEST(!sm.location(first.data(), 0).valid());
+        BOOST_TEST(sm.name(sm.location(f3, 0)) == "third");
+
+        // Once the ones after them are gone, they can.
+        sm.remove_buffer(f3);
+        BOOST_TEST(sm.size() == 0);
+        BOOST_TEST(sm.location(sm.add_buffer("first", first.data(), first.size()), 0).raw() == 1u);
+    }
+
+    BOOST_AUTO_TEST_CASE (scoped_buffers_dont_grow)
+    {
+        auto& sm = source::SourceManager::global();
+        auto before = sm.size();
+
+        // As in a REPL: build a tree from each line, then drop it.
+        for (int i = 0; i < 1000; ++i)
+        {
+            std::string sample { "var x = " + std::to_string(i) + ";" };
+            string_input<> in(sample, "line");
+            source::ScopedBuffer buffer { in };
+
+            auto tree = pt::parse<
+                gr::program_definition,
+                ast::parser_node,
+                ast::tree_selector
+            >(in);
+
+            auto program = ast::build_ast(tree.get());
+            BOOST_TEST_REQUIRE(program->position.valid());
+            BOOST_TEST(sm.file(program->position) == buffer.file());
+        }
+
+        BOOST_TEST(sm.size() == before);
+
+        // Building again from the same text doesn't register it again.
+        std::string sample { "var x = 1;" };
+        string_input<> in(sample, "twice");
+        source::ScopedBuffer buffer { in };
+
+        auto tree = pt::parse<
+            gr::program_definition,
+            ast::parser_node,
+            ast::tree_selector
+        >(in);
+
+        auto first = ast::build_ast(tree.get());
+        auto second = ast::build_ast(tree.get());
+
+        BOOST_TEST(sm.size() == before + 1);
+        BOOST_TEST((first->position == second->position));
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
@@ -0,0 +1,86 @@
+#include <boost/test/unit_test.hpp>
+
+#include "../../include/types/types.hpp"
+#include "../../include/types/conversion.hpp"
+
+namespace types = rhea::types;
+
+namespace {
+    using types::BasicType;
+    using types::CastOp;
+    using types::Conversion;
+    using types::conversion_rule;
+
+    // Test cases
+    BOOST_AUTO_TEST_SUITE (Conversion_table)
+
+    BOOST_AUTO_TEST_CASE (identity_conversions)
+    {
+        BOOST_TEST((conversion_rule(BasicType::Integer, BasicType::Integer).kind == Conversion::Identity));
+        BOOST_TEST((conversion_rule(BasicType::String, BasicType::String).kind == Conversion::Identity));
+        BOOST_TEST((conversion_rule(BasicType::Double, BasicType::Double).op == CastOp::None));
+    }
+
+    BOOST_AUTO_TEST_CASE (implicit_widening)
+    {
+        BOOST_TEST(types::is_implicitly_convertible(BasicType::Byte, BasicType::Integer));
+        BOOST_TEST(types::is_implicitly_convertible(BasicType::Byte, BasicType::Long));
+        BOOST_TEST(types::is_implicitly_convertible(BasicType::Integer, BasicType::Long));
+        BOOST_TEST(types::is_implicitly_convertible(BasicType::UnsignedByte, BasicType::UnsignedLong));
+        BOOST_TEST(types::is_implicitly_convertible(BasicType::Float, BasicType::Double));
+
+        // No narrowing, no sign changes, no int <-> float
+        BOOST_TEST(!types::is_implicitly_convertible(BasicType::Long, BasicType::Integer));
+        BOOST_TEST(!types::is_implicitly_convertible(BasicType::UnsignedByte, BasicType::Integer));
+        BOOST_TEST(!types::is_implicitly_convertible(BasicType::Integer, BasicType::Float));
+        BOOST_TEST(!types::is_implicitly_convertible(BasicType::Boolean, BasicType::Integer));
+    }
+
+    BOOST_AUTO_TEST_CASE (explicit_casts)
+    {
+        BOOST_TEST((conversion_rule(BasicType::Long, BasicType::Integer).op == CastOp::Trunc));
+        BOOST_TEST((conversion_rule(BasicType::Byte, BasicType::Integer).op == CastOp::SExt));
+        BOOST_TEST((conversion_rule(BasicType::UnsignedByte, BasicType::Integer).op == CastOp::ZExt));
+        BOOST_TEST((conversion_rule(BasicType::Boolean, BasicType::Long).op == CastOp::ZExt));
+        BOOST_TEST((conversion_rule(BasicType::Integer, BasicType::UnsignedInteger).op == CastOp::None));
+        BOOST_TEST((conversion_rule(BasicType::Double, BasicType::Float).op == CastOp::FPTrunc));
+        BOOST_TEST((conversion_rule(BasicType::Double, BasicType::UnsignedLong).op == CastOp::FPToUI));
+        BOOST_TEST((conversion_rule(BasicType::Long, BasicType::Double).op == CastOp::SIToFP));
+        BOOST_TEST((conversion_rule(BasicType::Integer, BasicType::Boolean).op == CastOp::IntToBool));
+        BOOST_TEST((conversion_rule(BasicType::Float, BasicType::Boolean).op == CastOp::FPToBool));
+
+        BOOST_TEST(!types::is_explicitly_convertible(BasicType::String, BasicType::Integer));
+        BOOST_TEST(!types::is_explicitly_convertible(BasicType::Symbol, BasicType::Boolean));
+    }
+
+    BOOST_AUTO_TEST_CASE (coercion)
+    {
+        BOOST_TEST((conversion_rule(BasicType::Promoted, BasicType::Integer).kind == Conversion::Coerced));
+        BOOST_TEST(types::is_implicitly_convertible(BasicType::Promoted, BasicType::Float));
+        BOOST_TEST(!types::is_implicitly_convertible(BasicType::Integer, BasicType::Promoted));
+    }
+
+    BOOST_AUTO_TEST_CASE (ranking)
+    {
+        BOOST_TEST(types::conversion_rank(BasicType::Integer, BasicType::Integer) <
+            types::conversion_rank(BasicType::Byte, BasicType::Integer));
+        BOOST_TEST(types::conversion_rank(BasicType::Byte, BasicType::Integer) <
+            types::conversion_rank(BasicType::Double, BasicType::Integer));
+    }
+
+    BOOST_AUTO_TEST_CASE (compatible_uses_table)
+    {
+        types::TypeInfo integer = types::SimpleType(BasicType::Integer);
+        types::TypeInfo lng = types::SimpleType(BasicType::Long);
+
+        BOOST_TEST(types::compatible(lng, integer));
+        BOOST_TEST(!types::compatible(integer, lng));
+
+        types::TypeInfo opt = types::OptionalType { integer.id() };
+        types::TypeInfo byte = types::SimpleType(BasicType::Byte);
+        BOOST_TEST(types::compatible(opt, byte));
+        BOOST_TEST(!types::compatible(opt, lng));
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
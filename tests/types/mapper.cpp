@@ -100,8 +100,8 @@ namespace {
         BOOST_TEST_MESSAGE("Inserting a function type definition, taking an integer 'i' and returning nothing");
 
         auto fn_type = types::FunctionType {
-            { { "i", std::make_shared<types::TypeInfo>(types::SimpleType(types::BasicType::Integer, true, true)) } },
-            std::make_shared<types::TypeInfo>(types::NothingType())
+            { { "i", types::intern_type(types::SimpleType(types::BasicType::Integer, true, true)) } },
+            types::intern_type(types::NothingType())
         };
 
         auto result = mapper.add_type_definition("f <integer> -> nothing", fn_type);
@@ -122,7 +122,7 @@ namespace {
     {
         BOOST_TEST_MESSAGE("Inserting an optional type holding an integer");
 
-        auto opt_type = types::OptionalType { std::make_shared<types::TypeInfo>(mapper.get_type_for("integer")) };
+        auto opt_type = types::OptionalType { types::intern_type(mapper.get_type_for("integer")) };
 
         auto result = mapper.add_type_definition("integer?", opt_type);
 
@@ -143,8 +143,8 @@ namespace {
         BOOST_TEST_MESSAGE("Inserting a variant over integer and string");
 
         auto var_type = types::VariantType {{
-            std::make_shared<types::TypeInfo>(mapper.get_type_for("integer")),
-            std::make_shared<types::TypeInfo>(mapper.get_type_for("string"))
+            types::intern_type(mapper.get_type_for("integer")),
+            types::intern_type(mapper.get_type_for("string"))
         }};
 
         auto result = mapper.add_type_definition("|integer, string|", var_type);
@@ -166,8 +166,8 @@ namespace {
         BOOST_TEST_MESSAGE("Inserting a structure St with fields i (integer) and s (string)");
 
         auto struct_type = types::StructureType {{
-            { "i", std::make_shared<types::TypeInfo>(mapper.get_type_for("integer"))},
-            { "s", std::make_shared<types::TypeInfo>(mapper.get_type_for("string"))}
+            { "i", types::intern_type(mapper.get_type_for("integer"))},
+            { "s", types::intern_type(mapper.get_type_for("string"))}
         }};
 
         auto result = mapper.add_type_definition("St", struct_type);
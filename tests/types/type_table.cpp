@@ -0,0 +1,97 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include "../../include/types/types.hpp"
+#include "../../include/types/type_table.hpp"
+#include "../../include/types/name_mangle.hpp"
+
+namespace types = rhea::types;
+
+namespace {
+    using types::TypeTable;
+    using types::intern_type;
+
+    // Test cases
+    BOOST_AUTO_TEST_SUITE (Type_table)
+
+    BOOST_AUTO_TEST_CASE (unknown_is_zero)
+    {
+        BOOST_TEST(intern_type(types::UnknownType()) == 0);
+        BOOST_TEST(types::TypeInfo().id() == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE (simple_types_intern_once)
+    {
+        auto a = intern_type(types::SimpleType(types::BasicType::Integer, true, true));
+        auto b = intern_type(types::SimpleType(types::BasicType::Integer));
+        auto c = intern_type(types::SimpleType(types::BasicType::Double, true, false));
+
+        BOOST_TEST(a == b);
+        BOOST_TEST(a != c);
+        BOOST_TEST((types::type_for_id(a) == types::SimpleType(types::BasicType::Integer)));
+    }
+
+    BOOST_AUTO_TEST_CASE (compound_types_intern_structurally)
+    {
+        auto integer = intern_type(types::SimpleType(types::BasicType::Integer));
+        auto str = intern_type(types::SimpleType(types::BasicType::String));
+
+        auto opt1 = intern_type(types::OptionalType { integer });
+        auto opt2 = intern_type(types::OptionalType { integer });
+        auto opt3 = intern_type(types::OptionalType { str });
+
+        BOOST_TEST(opt1 == opt2);
+        BOOST_TEST(opt1 != opt3);
+
+        // Order matters for variants, as do field names for structures.
+        auto v1 = intern_type(types::VariantType {{ integer, str }});
+        auto v2 = intern_type(types::VariantType {{ str, integer }});
+        BOOST_TEST(v1 != v2);
+
+        auto s1 = intern_type(types::StructureType {{ { "a", integer } }});
+        auto s2 = intern_type(types::StructureType {{ { "b", integer } }});
+        BOOST_TEST(s1 != s2);
+
+        // The same shape as a different kind of type is still different.
+        BOOST_TEST(intern_type(types::VariantType {{ integer }}) != opt1);
+
+        auto size = TypeTable::global().size();
+        intern_type(types::OptionalType { integer });
+        BOOST_TEST(TypeTable::global().size() == size);
+    }
+
+    BOOST_AUTO_TEST_CASE (cached_queries)
+    {
+        auto& table = TypeTable::global();
+
+        auto integer = intern_type(types::SimpleType(types::BasicType::Integer));
+        auto dbl = intern_type(types::SimpleType(types::BasicType::Double));
+        auto opt = intern_type(types::OptionalType { integer });
+
+        BOOST_TEST(table.name(integer) == "integer");
+        BOOST_TEST(&table.name(integer) == &table.name(integer));
+
+        BOOST_TEST(table.mangled(integer) == "i");
+        BOOST_TEST(table.mangled(opt) == "Opi");
+
+        BOOST_TEST(table.compatible(integer, integer));
+        BOOST_TEST(!table.compatible(integer, dbl));
+        BOOST_TEST(table.compatible(opt, integer));
+    }
+
+    BOOST_AUTO_TEST_CASE (mangled_function_arguments)
+    {
+        auto integer = intern_type(types::SimpleType(types::BasicType::Integer));
+        auto dbl = intern_type(types::SimpleType(types::BasicType::Double));
+
+        types::FunctionType ft {
+            { { "x", integer }, { "y", dbl } },
+            intern_type(types::SimpleType(types::BasicType::Boolean))
+        };
+
+        BOOST_TEST(types::mangle_function_name("foo", ft) == "_Rf3foobiDd");
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
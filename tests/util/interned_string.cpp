@@ -0,0 +1,71 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <boost/test/data/monomorphic.hpp>
+
+#include <string>
+#include <unordered_map>
+
+#include "../../include/util/interned_string.hpp"
+
+namespace data = boost::unit_test::data;
+using rhea::util::InternedString;
+
+namespace {
+    // Datasets
+    std::string name_samples[] = { "x", "foo", "main", "$global", "a:long:module_name", "á" };
+
+    // Test cases
+    BOOST_AUTO_TEST_SUITE (Util_interned_string)
+
+    BOOST_DATA_TEST_CASE(intern_round_trip, data::make(name_samples))
+    {
+        InternedString s { sample };
+
+        BOOST_TEST(s.str() == sample);
+        BOOST_TEST(!s.empty());
+
+        // Interning again gives the same handle and the same storage.
+        InternedString again { sample };
+        BOOST_TEST((again == s));
+        BOOST_TEST(again.id() == s.id());
+        BOOST_TEST(&again.str() == &s.str());
+    }
+
+    BOOST_AUTO_TEST_CASE (empty_string_is_default)
+    {
+        InternedString def;
+        InternedString empty { "" };
+
+        BOOST_TEST(def.empty());
+        BOOST_TEST((def == empty));
+        BOOST_TEST(def.id() == 0);
+        BOOST_TEST(def.str() == "");
+    }
+
+    BOOST_AUTO_TEST_CASE (distinct_strings_differ)
+    {
+        InternedString a { "alpha" };
+        InternedString b { "beta" };
+
+        BOOST_TEST((a != b));
+        BOOST_TEST(a.id() != b.id());
+    }
+
+    BOOST_AUTO_TEST_CASE (interned_map_keys)
+    {
+        std::unordered_map<InternedString, int> table;
+        table["one"] = 1;
+        table[std::string("two")] = 2;
+
+        auto before = rhea::util::interned_count();
+
+        BOOST_TEST(table.at("one") == 1);
+        BOOST_TEST(table.at("two") == 2);
+        BOOST_TEST(table.count("one") == 1);
+
+        // Looking up existing names doesn't add anything to the table.
+        BOOST_TEST(rhea::util::interned_count() == before);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
@@ -0,0 +1,90 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include "../../include/util/scoped_table.hpp"
+
+using rhea::util::ScopedTable;
+
+namespace {
+    using table_type = ScopedTable<std::string, int>;
+
+    // Test cases
+    BOOST_AUTO_TEST_SUITE (Util_scoped_table)
+
+    BOOST_AUTO_TEST_CASE (insert_and_find)
+    {
+        table_type t;
+
+        BOOST_TEST(t.depth() == 1);
+        BOOST_TEST((t.find("x") == nullptr));
+
+        t.insert("x", 1);
+
+        BOOST_TEST_REQUIRE((t.find("x") != nullptr));
+        BOOST_TEST(*t.find("x") == 1);
+        BOOST_TEST(t.is_local("x"));
+        BOOST_TEST(t.depth_of("x") == 1);
+
+        // Rebinding in the same scope replaces the value.
+        t.insert("x", 2);
+        BOOST_TEST(*t.find("x") == 2);
+
+        t.pop();
+        BOOST_TEST((t.find("x") == nullptr));
+    }
+
+    BOOST_AUTO_TEST_CASE (shadowing)
+    {
+        table_type t;
+        t.insert("x", 1);
+        t.insert("y", 10);
+
+        t.push();
+        BOOST_TEST(!t.is_local("x"));
+        BOOST_TEST((t.find_local("x") == nullptr));
+        BOOST_TEST(*t.find("x") == 1);
+
+        t.insert("x", 2);
+        t.insert("z", 3);
+        BOOST_TEST(t.is_local("x"));
+        BOOST_TEST(*t.find("x") == 2);
+        BOOST_TEST(t.depth_of("x") == 2);
+        BOOST_TEST(t.depth_of("y") == 1);
+
+        // Closing the scope brings back the outer binding and drops
+        // anything that was only bound inside.
+        t.pop();
+        BOOST_TEST(*t.find("x") == 1);
+        BOOST_TEST(*t.find("y") == 10);
+        BOOST_TEST((t.find("z") == nullptr));
+        BOOST_TEST(t.depth_of("z") == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE (many_scopes)
+    {
+        table_type t;
+
+        for (int i = 0; i < 100; ++i)
+        {
+            t.push();
+            t.insert("v", i);
+            t.insert("v" + std::to_string(i), i);
+        }
+
+        BOOST_TEST(t.depth() == 101);
+        BOOST_TEST(*t.find("v") == 99);
+
+        for (int i = 99; i >= 0; --i)
+        {
+            BOOST_TEST(*t.find("v") == i);
+            BOOST_TEST(t.is_local("v" + std::to_string(i)));
+            t.pop();
+        }
+
+        BOOST_TEST((t.find("v") == nullptr));
+        BOOST_TEST(t.depth() == 1);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}
@@ -0,0 +1,75 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include "../../include/util/symbol_table.hpp"
+
+using rhea::util::SymbolTable;
+using rhea::util::SymbolId;
+
+namespace {
+    // A terrible hash, so we can check collisions without searching for
+    // real FNV collisions.
+    std::uint64_t first_letter(std::string s)
+    {
+        return s.empty() ? 0 : static_cast<std::uint64_t>(s[0]);
+    }
+
+    // Test cases
+    BOOST_AUTO_TEST_SUITE (Util_symbol_table)
+
+    BOOST_AUTO_TEST_CASE (dense_ids)
+    {
+        SymbolTable table;
+
+        auto foo = table.intern("foo");
+        auto bar = table.intern("bar");
+        auto baz = table.intern("baz");
+
+        BOOST_TEST(foo == 0u);
+        BOOST_TEST(bar == 1u);
+        BOOST_TEST(baz == 2u);
+        BOOST_TEST(table.intern("bar") == bar);
+        BOOST_TEST(table.size() == 3u);
+
+        BOOST_TEST(table.name(bar) == "bar");
+        BOOST_TEST(table.abi_hash(bar) == rhea::util::symbol_hash("bar"));
+    }
+
+    BOOST_AUTO_TEST_CASE (enum_members)
+    {
+        SymbolTable table;
+        table.intern("green");
+
+        auto ids = table.intern_enum("Color", { "red", "green", "blue" });
+
+        BOOST_TEST(ids.size() == 3u);
+        BOOST_TEST(ids[0] == 1u);
+        BOOST_TEST(ids[1] == table.intern("green"));
+        BOOST_TEST(ids[2] == 2u);
+
+        auto members = table.enum_members("Color");
+        BOOST_TEST_REQUIRE((members != nullptr));
+        BOOST_TEST((*members == ids));
+        BOOST_TEST((table.enum_members("Shape") == nullptr));
+
+        // Same members again is fine; different ones aren't.
+        BOOST_TEST((table.intern_enum("Color", { "red", "green", "blue" }) == ids));
+        BOOST_CHECK_THROW(table.intern_enum("Color", { "red" }), std::invalid_argument);
+    }
+
+    BOOST_AUTO_TEST_CASE (hash_collisions)
+    {
+        SymbolTable table { first_letter };
+
+        table.intern("apple");
+        BOOST_CHECK_THROW(table.intern("avocado"), rhea::util::symbol_collision);
+
+        // The failed symbol isn't added.
+        BOOST_TEST(table.size() == 1u);
+        BOOST_TEST(table.intern("banana") == 1u);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END ()
+}